@@ -0,0 +1,461 @@
+// mayaAnalyzerBench — end-to-end FileAnalyzer::analyze() throughput.
+//
+// Generates synthetic scenes on disk and analyzes each one several times:
+//
+//   .ma  header (`requires`, `file -r`), then createNode blocks with numeric
+//        setAttr filler and file nodes whose texture paths are spread
+//        evenly through the body
+//   .mb  FOR4 IFF tree: FREF chunks for references, STR chunks for texture
+//        paths, large opaque payload chunks as filler. With --encoding utf16
+//        the paths are stored as UTF-16LE in a headerless file instead,
+//        which is the only place FileAnalyzer reads UTF-16 (fallback scan)
+//
+// and prints, per scene, best-of-N MB/s, peak RSS during analyze() and heap
+// allocations per dependency found. The number of dependencies found is
+// checked against what was generated, so a parser regression that drops
+// paths fails the run (exit code 1).
+//
+//   mayaAnalyzerBench [--size <MB>] [--refs <n>] [--textures <n>]
+//                     [--format ma|mb|all] [--encoding ascii|utf8|utf16|all]
+//                     [--iterations <n>] [--dir <path>] [--keep] [--header-only]
+//
+// Peak RSS is exact on Linux (the high-water mark is reset before each
+// run); on Windows it is the process peak so far.
+
+#include "FileAnalyzer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ---- Allocation counting ----------------------------------------------------
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+}
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+enum class Encoding { Ascii, Utf8, Utf16 };
+
+struct Config {
+    uint64_t sizeBytes = 64ull * 1024 * 1024;
+    int refs = 100;
+    int textures = 2000;
+    int iterations = 3;
+    bool headerOnly = false;
+    bool keep = false;
+    fs::path dir;
+    std::vector<std::string> formats{"ma", "mb"};
+    std::vector<Encoding> encodings{Encoding::Ascii, Encoding::Utf8, Encoding::Utf16};
+};
+
+const char* encodingName(Encoding e)
+{
+    switch (e) {
+    case Encoding::Ascii: return "ascii";
+    case Encoding::Utf8: return "utf8";
+    case Encoding::Utf16: return "utf16";
+    }
+    return "";
+}
+
+// Dependency paths. Textures use UDIM-free unique names so every one is a
+// distinct dependency.
+std::string referencePath(Encoding e, int i)
+{
+    std::string n = std::to_string(i);
+    if (e == Encoding::Utf8) return "/proj/资产/角色/char" + n + "/绑定/char" + n + "_rig.ma";
+    return "/proj/assets/chr/char" + n + "/rig/char" + n + "_rig.ma";
+}
+
+std::string texturePath(Encoding e, int i)
+{
+    std::string n = std::to_string(i);
+    if (e == Encoding::Utf8) return "/proj/资产/贴图/纹理_" + n + "_基础色.png";
+    return "/proj/assets/tex/set/surface_" + n + "_basecolor.png";
+}
+
+// ---- Peak RSS ------------------------------------------------------------------
+
+void resetPeakRss()
+{
+#ifdef __linux__
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+uint64_t peakRssBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize;
+    return 0;
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+    }
+    return 0;
+#else
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (uint64_t)ru.ru_maxrss;  // bytes on macOS
+#endif
+}
+
+// ---- .ma generator -------------------------------------------------------------
+
+void writeMa(const fs::path& file, const Config& cfg, Encoding e)
+{
+    std::ofstream out(file, std::ios::binary);
+    out << "//Maya ASCII 2024 scene\n"
+        << "//Name: bench.ma\n"
+        << "requires maya \"2024\";\n"
+        << "requires -nodeType \"aiStandardSurface\" \"mtoa\" \"5.3.1\";\n";
+    for (int i = 0; i < cfg.refs; ++i) {
+        std::string p = referencePath(e, i);
+        out << "file -rdi 1 -ns \"char" << i << "\" -rfn \"char" << i << "RN\" -typ \"mayaAscii\" \"" << p
+            << "\";\n";
+    }
+    for (int i = 0; i < cfg.refs; ++i) {
+        out << "file -r -ns \"char" << i << "\" -dr 1 -rfn \"char" << i << "RN\" -typ \"mayaAscii\" \""
+            << referencePath(e, i) << "\";\n";
+    }
+    out << "currentUnit -l centimeter -a degree -t film;\n";
+
+    // Filler node, about 1 KB: a transform with a float array.
+    std::string filler;
+    {
+        std::mt19937 rng(7);
+        filler = "\tsetAttr -s 64 \".pt[0:63]\" -type \"float3\"";
+        for (int k = 0; k < 64; ++k) filler += " " + std::to_string(rng() % 1000) + "." + std::to_string(rng() % 100);
+        filler += ";\n";
+    }
+
+    uint64_t written = (uint64_t)out.tellp();
+    uint64_t nodesTotal = std::max<uint64_t>(1, cfg.sizeBytes / (filler.size() + 40));
+    uint64_t textureEvery = cfg.textures > 0 ? std::max<uint64_t>(1, nodesTotal / cfg.textures) : 0;
+    int texturesWritten = 0;
+    for (uint64_t n = 0; written < cfg.sizeBytes || texturesWritten < cfg.textures; ++n) {
+        std::string block = "createNode transform -n \"node" + std::to_string(n) + "\";\n" + filler;
+        if (textureEvery && n % textureEvery == 0 && texturesWritten < cfg.textures) {
+            block += "createNode file -n \"file" + std::to_string(texturesWritten) + "\";\n"
+                     "\tsetAttr \".ftn\" -type \"string\" \"" + texturePath(e, texturesWritten) + "\";\n";
+            ++texturesWritten;
+        }
+        out << block;
+        written += block.size();
+    }
+}
+
+// ---- .mb generator -------------------------------------------------------------
+
+void putTag(std::string& out, const char* tag)
+{
+    out.append(tag, 4);
+}
+
+void putBe32(std::string& out, uint32_t v)
+{
+    for (int i = 3; i >= 0; --i) out += (char)((v >> (8 * i)) & 0xFF);
+}
+
+void putChunk(std::string& out, const char* tag, const std::string& payload)
+{
+    putTag(out, tag);
+    putBe32(out, (uint32_t)payload.size());
+    out += payload;
+    while (out.size() % 4) out += '\0';
+}
+
+void putGroup(std::string& out, const char* type, const std::string& children)
+{
+    putTag(out, "FOR4");
+    putBe32(out, (uint32_t)(children.size() + 4));
+    putTag(out, type);
+    out += children;
+}
+
+std::string utf16le(const std::string& ascii)
+{
+    std::string s;
+    for (char c : ascii) {
+        s += c;
+        s += '\0';
+    }
+    return s;
+}
+
+void writeMbIff(const fs::path& file, const Config& cfg, Encoding e)
+{
+    std::ofstream out(file, std::ios::binary);
+    std::string head;
+    putTag(head, "FOR4");
+    putBe32(head, 0);  // patched below
+    putTag(head, "Maya");
+    {
+        std::string hdr;
+        putChunk(hdr, "VERS", std::string("2024") + '\0');
+        putGroup(head, "HEAD", hdr);
+    }
+    for (int i = 0; i < cfg.refs; ++i) {
+        std::string fref;
+        putChunk(fref, "FREF", "char" + std::to_string(i) + "RN" + '\0' + referencePath(e, i) + '\0');
+        putGroup(head, "FREF", fref);
+    }
+    out << head;
+    uint64_t written = head.size();
+
+    std::string payload(4096, '\0');
+    std::mt19937 rng(11);
+    for (auto& c : payload) c = (char)(rng() & 0xFF);
+    uint64_t nodesTotal = std::max<uint64_t>(1, cfg.sizeBytes / (payload.size() + 64));
+    uint64_t textureEvery = cfg.textures > 0 ? std::max<uint64_t>(1, nodesTotal / cfg.textures) : 0;
+    int texturesWritten = 0;
+    for (uint64_t n = 0; written < cfg.sizeBytes || texturesWritten < cfg.textures; ++n) {
+        std::string children;
+        putChunk(children, "CREA", "node" + std::to_string(n) + '\0');
+        putChunk(children, "DBLE", payload);
+        if (textureEvery && n % textureEvery == 0 && texturesWritten < cfg.textures) {
+            putChunk(children, "STR ", std::string("ftn") + '\0' + texturePath(e, texturesWritten) + '\0');
+            ++texturesWritten;
+        }
+        std::string group;
+        putGroup(group, "XFRM", children);
+        out << group;
+        written += group.size();
+    }
+
+    if (written - 8 > UINT32_MAX) {
+        std::cerr << "warning: " << file.u8string() << " exceeds the FOR4 size limit\n";
+    }
+    std::string size;
+    putBe32(size, (uint32_t)(written - 8));
+    out.seekp(4);
+    out << size;
+}
+
+// Headerless binary with UTF-16LE paths: exercises the fallback scan.
+void writeMbUtf16(const fs::path& file, const Config& cfg)
+{
+    std::ofstream out(file, std::ios::binary);
+    std::string block(4096, '\0');
+    std::mt19937 rng(13);
+    for (auto& c : block) c = (char)(rng() & 0xFF);
+
+    uint64_t blocksTotal = std::max<uint64_t>(1, cfg.sizeBytes / block.size());
+    int total = cfg.refs + cfg.textures;
+    uint64_t every = total > 0 ? std::max<uint64_t>(1, blocksTotal / total) : 0;
+    int placed = 0;
+    uint64_t written = 0;
+    for (uint64_t n = 0; written < cfg.sizeBytes || placed < total; ++n) {
+        out << block;
+        written += block.size();
+        if (every && n % every == 0 && placed < total) {
+            std::string p = placed < cfg.refs ? referencePath(Encoding::Ascii, placed)
+                                              : texturePath(Encoding::Ascii, placed - cfg.refs);
+            std::string s = std::string(2, '\0') + utf16le(p) + std::string(2, '\0');
+            out << s;
+            written += s.size();
+            ++placed;
+        }
+    }
+}
+
+// ---- Runner --------------------------------------------------------------------
+
+struct Result {
+    double bestSeconds = 1e30;
+    uint64_t peakRss = 0;
+    uint64_t allocations = 0;
+    size_t deps = 0;
+};
+
+Result benchFile(const fs::path& file, const Config& cfg)
+{
+    Result r;
+    std::string path = file.u8string();
+    for (int i = 0; i < cfg.iterations; ++i) {
+        resetPeakRss();
+        uint64_t allocs0 = g_allocations.load();
+        auto t0 = std::chrono::steady_clock::now();
+
+        FileAnalyzer fa(path);
+        if (cfg.headerOnly) fa.setMode(AnalysisMode::ReferencesAndRequires);
+        fa.analyze();
+
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        uint64_t allocs = g_allocations.load() - allocs0;
+        r.bestSeconds = std::min(r.bestSeconds, s);
+        r.peakRss = std::max(r.peakRss, peakRssBytes());
+        r.allocations = allocs;
+        r.deps = fa.references.size() + fa.textures.size() + fa.caches.size();
+    }
+    return r;
+}
+
+bool parseArgs(int argc, char** argv, Config& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--size" && hasValue) {
+            cfg.sizeBytes = std::strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        } else if (a == "--refs" && hasValue) {
+            cfg.refs = std::max(0, std::atoi(argv[++i]));
+        } else if (a == "--textures" && hasValue) {
+            cfg.textures = std::max(0, std::atoi(argv[++i]));
+        } else if ((a == "--iterations" || a == "-n") && hasValue) {
+            cfg.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (a == "--dir" && hasValue) {
+            cfg.dir = fs::u8path(argv[++i]);
+        } else if (a == "--format" && hasValue) {
+            std::string v = argv[++i];
+            if (v == "all") {
+                cfg.formats = {"ma", "mb"};
+            } else if (v == "ma" || v == "mb") {
+                cfg.formats = {v};
+            } else {
+                std::cerr << "error: unknown format " << v << "\n";
+                return false;
+            }
+        } else if (a == "--encoding" && hasValue) {
+            std::string v = argv[++i];
+            if (v == "all") {
+                cfg.encodings = {Encoding::Ascii, Encoding::Utf8, Encoding::Utf16};
+            } else if (v == "ascii") {
+                cfg.encodings = {Encoding::Ascii};
+            } else if (v == "utf8") {
+                cfg.encodings = {Encoding::Utf8};
+            } else if (v == "utf16") {
+                cfg.encodings = {Encoding::Utf16};
+            } else {
+                std::cerr << "error: unknown encoding " << v << "\n";
+                return false;
+            }
+        } else if (a == "--keep") {
+            cfg.keep = true;
+        } else if (a == "--header-only") {
+            cfg.headerOnly = true;
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--size <MB>] [--refs <n>] [--textures <n>] [--format ma|mb|all]\n"
+                         "       [--encoding ascii|utf8|utf16|all] [--iterations <n>] [--dir <path>]\n"
+                         "       [--keep] [--header-only]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Config cfg;
+    if (!parseArgs(argc, argv, cfg)) return 2;
+
+    if (cfg.dir.empty()) {
+#ifdef _WIN32
+        unsigned long pid = GetCurrentProcessId();
+#else
+        long pid = (long)getpid();
+#endif
+        cfg.dir = fs::temp_directory_path() / ("mayaAnalyzerBench-" + std::to_string(pid));
+    }
+    std::error_code ec;
+    fs::create_directories(cfg.dir, ec);
+    if (ec) {
+        std::cerr << "error: cannot create " << cfg.dir.u8string() << "\n";
+        return 2;
+    }
+
+    std::cout << "scene                 MB      MB/s   peak RSS MB   deps   allocs/dep\n";
+    bool ok = true;
+    for (const auto& format : cfg.formats) {
+        for (Encoding e : cfg.encodings) {
+            // Maya ASCII is never UTF-16.
+            if (format == "ma" && e == Encoding::Utf16) continue;
+
+            std::string name = std::string("bench_") + encodingName(e) + "." + format;
+            fs::path file = cfg.dir / name;
+            if (format == "ma") {
+                writeMa(file, cfg, e);
+            } else if (e == Encoding::Utf16) {
+                writeMbUtf16(file, cfg);
+            } else {
+                writeMbIff(file, cfg, e);
+            }
+
+            Result r = benchFile(file, cfg);
+            double mb = fs::file_size(file, ec) / (1024.0 * 1024.0);
+            size_t expected = (size_t)cfg.refs + (cfg.headerOnly ? 0 : (size_t)cfg.textures);
+            std::printf("%-18s %7.1f %9.1f %13.1f %6zu %12.1f\n", name.c_str(), mb, mb / r.bestSeconds,
+                        r.peakRss / (1024.0 * 1024.0), r.deps,
+                        r.deps ? (double)r.allocations / r.deps : 0.0);
+            if (r.deps != expected) {
+                std::cout << "  MISMATCH: expected " << expected << " dependencies\n";
+                ok = false;
+            }
+            if (!cfg.keep) fs::remove(file, ec);
+        }
+    }
+    if (!cfg.keep) fs::remove(cfg.dir, ec);
+    return ok ? 0 : 1;
+}
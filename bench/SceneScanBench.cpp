@@ -0,0 +1,372 @@
+// mayaSceneScanBench — cost of the Batch Exporter scene scan.
+//
+// Builds a synthetic crowd scene in a MemorySceneQuery (one namespace per
+// character: a deformation skeleton, an export skeleton named "root", a
+// skinned body and a skinned face with a blendShape) and runs the Scan
+// Scene finders on it. Prints the time and the number of scene queries of
+// each; in Maya every query is an API call (it used to be a MEL round trip).
+// The SceneSnapshot finders are compared with the previous per-node query
+// versions, which must find the same targets.
+//
+//   mayaSceneScanBench [--characters <n>] [--joints <n>] [--iterations <n>]
+
+#include "MemorySceneQuery.h"
+#include "SceneAnalysis.h"
+#include "SceneSnapshot.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int characters = 200;
+    int joints = 150;  // per skeleton
+    int weights = 52;  // face blendShape targets
+    int iterations = 3;
+};
+
+// Joint hierarchy of `count` joints under `parent`: mostly chains, with a
+// branch every few joints, like a limb/finger layout.
+std::vector<std::string> addSkeleton(MemorySceneQuery& scene, const std::string& parent,
+                                     const std::string& ns, const std::string& rootName, int count,
+                                     uint32_t& seed)
+{
+    std::vector<std::string> joints;
+    joints.push_back(scene.addDagNode(ns + rootName, "joint", parent));
+    for (int i = 1; i < count; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        size_t p = (seed >> 24) % 5 == 0 ? (seed >> 8) % joints.size() : joints.size() - 1;
+        joints.push_back(scene.addDagNode(ns + rootName + "_" + std::to_string(i), "joint", joints[p]));
+    }
+    return joints;
+}
+
+// ---- Previous implementations (queries per joint / per node) ----
+
+std::vector<CharacterInfo> legacyFindCharacters(const SceneQuery& scene)
+{
+    using namespace SceneAnalysis;
+    std::map<std::string, std::vector<std::string>> nsMap;
+    for (const auto& joint : scene.nodesOfType("joint")) {
+        if (!scene.parent(joint, "joint").empty()) continue;
+        nsMap[namespaceOf(shortName(joint))].push_back(joint);
+    }
+
+    std::vector<CharacterInfo> result;
+    for (auto& kv : nsMap) {
+        std::string bestRoot = kv.second[0];
+        size_t bestCount = 0;
+        bool bestIsRootNamed = false;
+        for (const auto& r : kv.second) {
+            std::string lower = bareName(shortName(r));
+            for (auto& c : lower) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+            bool isRootNamed = (lower == "root");
+            size_t count = scene.descendants(r, "joint").size();
+            if ((isRootNamed && !bestIsRootNamed) ||
+                (isRootNamed == bestIsRootNamed && count > bestCount)) {
+                bestCount = count;
+                bestRoot = r;
+                bestIsRootNamed = isRootNamed;
+            }
+        }
+        std::string sn = shortName(bestRoot);
+        CharacterInfo info;
+        info.rootJoint = bestRoot;
+        info.nsOrName = kv.first.empty() ? bareName(sn) : kv.first;
+        info.display = sn;
+        result.push_back(info);
+    }
+    return result;
+}
+
+std::vector<BlendShapeGroupInfo> legacyFindBlendShapeGroups(const SceneQuery& scene)
+{
+    using namespace SceneAnalysis;
+    std::map<std::string, std::pair<std::string, size_t>> nsMap;  // ns -> (mesh, weights)
+    for (const auto& bs : scene.nodesOfType("blendShape")) {
+        size_t weightCount = scene.elementNames(bs, "weight").size();
+        for (const auto& geo : scene.deformedGeometry(bs)) {
+            std::string transform = scene.parent(geo);
+            if (transform.empty()) continue;
+            std::string ns = namespaceOf(shortName(transform));
+            auto it = nsMap.find(ns);
+            if (it == nsMap.end() || weightCount > it->second.second) nsMap[ns] = {transform, weightCount};
+        }
+    }
+    std::vector<BlendShapeGroupInfo> result;
+    for (const auto& kv : nsMap) {
+        std::string sn = shortName(kv.second.first);
+        BlendShapeGroupInfo info;
+        info.mesh = kv.second.first;
+        info.nsOrName = kv.first.empty() ? bareName(sn) : kv.first;
+        info.display = kv.first.empty() ? sn + " (BlendShape)" : kv.first + ":* (BlendShape)";
+        result.push_back(info);
+    }
+    return result;
+}
+
+std::vector<SkeletonBlendShapeInfo> legacyFindSkeletonBlendShapeCombos(const SceneQuery& scene,
+                                                                       const std::vector<CharacterInfo>& characters)
+{
+    std::vector<SkeletonBlendShapeInfo> result;
+    for (const auto& ch : characters) {
+        std::vector<std::string> allJoints = scene.descendants(ch.rootJoint, "joint");
+        allJoints.push_back(ch.rootJoint);
+        std::set<std::string> skinClusters;
+        for (const auto& j : allJoints) {
+            std::vector<std::string> clusters = scene.connections(j, "skinCluster", true, false);
+            if (clusters.empty()) clusters = scene.connections(j, "skinCluster", true, true);
+            skinClusters.insert(clusters.begin(), clusters.end());
+        }
+        std::set<std::string> skinned;
+        for (const auto& skin : skinClusters) {
+            for (const auto& geo : scene.deformedGeometry(skin)) {
+                std::string geoType = scene.nodeType(geo);
+                if (geoType == "mesh" && !scene.parent(geo).empty()) skinned.insert(scene.parent(geo));
+                if (geoType == "transform") skinned.insert(geo);
+            }
+        }
+
+        SkeletonBlendShapeInfo info;
+        std::set<std::string> seenBsNodes;
+        auto scanMeshForBS = [&](const std::string& meshXform) {
+            bool meshHasBS = false;
+            std::vector<std::string> history;
+            scene.history(meshXform, history);
+            for (const auto& node : history) {
+                if (scene.nodeType(node) != "blendShape") continue;
+                meshHasBS = true;
+                if (seenBsNodes.insert(node).second) info.bsNodes.push_back(node);
+                std::vector<std::string> attrs = SceneAnalysis::blendShapeWeightAttrs(scene, node);
+                info.bsWeightAttrs.insert(info.bsWeightAttrs.end(), attrs.begin(), attrs.end());
+            }
+            if (meshHasBS) info.bsMeshes.push_back(meshXform);
+        };
+        for (const auto& meshXform : skinned) scanMeshForBS(meshXform);
+
+        std::string rootTop = ch.rootJoint.substr(0, ch.rootJoint.find('|', 1));
+        std::set<std::string> nonSkinned;
+        for (const auto& shape : scene.descendants(rootTop, "mesh")) {
+            std::string parent = scene.parent(shape);
+            if (!parent.empty() && !skinned.count(parent)) nonSkinned.insert(parent);
+        }
+        for (const auto& meshXform : nonSkinned) scanMeshForBS(meshXform);
+
+        if (!info.bsMeshes.empty()) {
+            info.rootJoint = ch.rootJoint;
+            info.nsOrName = ch.nsOrName;
+            info.display = ch.display + " (Skel+BS)";
+            result.push_back(info);
+        }
+    }
+    return result;
+}
+
+bool sameCharacters(const std::vector<CharacterInfo>& a, const std::vector<CharacterInfo>& b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].rootJoint != b[i].rootJoint || a[i].nsOrName != b[i].nsOrName || a[i].display != b[i].display) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// What BatchExporterUI::onScanScene finds.
+struct ScanResult {
+    size_t cameras = 0;
+    std::vector<CharacterInfo> characters;
+    std::vector<BlendShapeGroupInfo> bsGroups;
+    std::vector<SkeletonBlendShapeInfo> combos;
+};
+
+ScanResult legacyScanScene(const SceneQuery& scene)
+{
+    ScanResult r;
+    r.cameras = SceneAnalysis::findNonDefaultCameras(scene).size();
+    r.characters = legacyFindCharacters(scene);
+    r.bsGroups = legacyFindBlendShapeGroups(scene);
+    r.combos = legacyFindSkeletonBlendShapeCombos(scene, r.characters);
+    return r;
+}
+
+ScanResult scanScene(const SceneQuery& scene)
+{
+    ScanResult r;
+    SceneSnapshot snap = SceneSnapshot::build(scene);
+    r.cameras = SceneAnalysis::findNonDefaultCameras(scene).size();
+    r.characters = SceneAnalysis::findCharacters(snap);
+    r.bsGroups = SceneAnalysis::findBlendShapeGroups(snap);
+    r.combos = SceneAnalysis::findSkeletonBlendShapeCombos(snap, r.characters);
+    return r;
+}
+
+bool sameScan(const ScanResult& a, const ScanResult& b)
+{
+    if (a.cameras != b.cameras || a.bsGroups.size() != b.bsGroups.size()) return false;
+    if (!sameCharacters(a.characters, b.characters) || a.combos.size() != b.combos.size()) return false;
+    for (size_t i = 0; i < a.bsGroups.size(); ++i) {
+        if (a.bsGroups[i].mesh != b.bsGroups[i].mesh || a.bsGroups[i].nsOrName != b.bsGroups[i].nsOrName ||
+            a.bsGroups[i].display != b.bsGroups[i].display) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.combos.size(); ++i) {
+        const SkeletonBlendShapeInfo& x = a.combos[i];
+        const SkeletonBlendShapeInfo& y = b.combos[i];
+        if (x.rootJoint != y.rootJoint || x.bsMeshes != y.bsMeshes || x.bsNodes != y.bsNodes ||
+            x.bsWeightAttrs != y.bsWeightAttrs) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void buildCrowd(MemorySceneQuery& scene, const Options& opt)
+{
+    scene.setBaseType("joint", "transform");
+    for (const char* cam : {"persp", "top", "front", "side"}) {
+        std::string xform = scene.addDagNode(cam, "transform");
+        std::string shape = scene.addDagNode(std::string(cam) + "Shape", "camera", xform);
+        scene.setStartupCamera(shape);
+    }
+    std::string shotCam = scene.addDagNode("shotCam", "transform");
+    scene.addDagNode("shotCamShape", "camera", shotCam);
+
+    uint32_t seed = 12345;
+    // Un-namespaced set dressing: several skeletons competing for one group.
+    std::string set = scene.addDagNode("set", "transform");
+    for (int s = 0; s < 5; ++s) addSkeleton(scene, set, "", "tree" + std::to_string(s), 3 + 7 * s % 11, seed);
+
+    for (int c = 0; c < opt.characters; ++c) {
+        std::string ns = "crowd" + std::to_string(c) + ":";
+        std::string rig = scene.addDagNode(ns + "rig", "transform");
+        std::string deform = scene.addDagNode(ns + "DeformationSystem", "transform", rig);
+        addSkeleton(scene, deform, ns, "Root_M", opt.joints, seed);
+        std::vector<std::string> exportJoints = addSkeleton(scene, rig, ns, "root", opt.joints, seed);
+        // A prop rigged under a hand: a joint root below a non-joint below a joint.
+        std::string prop = scene.addDagNode(ns + "prop_grp", "transform", exportJoints.back());
+        addSkeleton(scene, prop, ns, "prop", 4, seed);
+
+        std::string geo = scene.addDagNode(ns + "geo", "transform", rig);
+        std::string body = scene.addDagNode(ns + "body", "transform", geo);
+        std::string bodyShape = scene.addDagNode(ns + "bodyShape", "mesh", body);
+        std::string face = scene.addDagNode(ns + "face", "transform", geo);
+        std::string faceShape = scene.addDagNode(ns + "faceShape", "mesh", face);
+
+        // Joints feed the skinClusters (worldMatrix -> matrix[i]).
+        std::string bodySkin = ns + "skinCluster1";
+        std::string faceSkin = ns + "skinCluster2";
+        scene.addNode(bodySkin, "skinCluster");
+        scene.addNode(faceSkin, "skinCluster");
+        for (const auto& j : exportJoints) scene.connect(j, bodySkin);
+        for (size_t j = 0; j < exportJoints.size(); j += 10) scene.connect(exportJoints[j], faceSkin);
+        scene.addDeformedGeometry(bodySkin, bodyShape);
+        scene.addDeformedGeometry(faceSkin, faceShape);
+
+        std::string bs = ns + "blendShape1";
+        scene.addNode(bs, "blendShape");
+        std::vector<std::string> weights;
+        for (int w = 0; w < opt.weights; ++w) weights.push_back("shape" + std::to_string(w));
+        scene.setElementNames(bs, "weight", weights);
+        scene.connect(bs, faceSkin);
+        scene.addDeformedGeometry(bs, faceShape);
+    }
+}
+
+template <typename Fn>
+double bestSeconds(int iterations, Fn&& fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < iterations; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+template <typename Fn>
+void report(const char* name, MemorySceneQuery& scene, int iterations, Fn&& fn)
+{
+    size_t found = 0;
+    scene.resetQueryCount();
+    fn(found);
+    size_t queries = scene.queryCount();
+    double t = bestSeconds(iterations, [&]() { fn(found); });
+    std::cout << "  " << name << ": " << found << " found, " << queries << " queries, "
+              << t * 1000.0 << " ms\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--characters" && i + 1 < argc) {
+            opt.characters = std::max(1, std::atoi(argv[++i]));
+        } else if (a == "--joints" && i + 1 < argc) {
+            opt.joints = std::max(1, std::atoi(argv[++i]));
+        } else if ((a == "--iterations" || a == "-n") && i + 1 < argc) {
+            opt.iterations = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "usage: mayaSceneScanBench [--characters <n>] [--joints <n>] [--iterations <n>]\n";
+            return 2;
+        }
+    }
+
+    MemorySceneQuery scene;
+    buildCrowd(scene, opt);
+    std::cout << opt.characters << " characters, " << scene.nodeCount() << " nodes\n";
+
+    report("findNonDefaultCameras", scene, opt.iterations, [&](size_t& n) {
+        n = SceneAnalysis::findNonDefaultCameras(scene).size();
+    });
+    report("findCharacters (per-joint queries)", scene, opt.iterations, [&](size_t& n) {
+        n = legacyFindCharacters(scene).size();
+    });
+
+    SceneSnapshot snap;
+    report("SceneSnapshot::build", scene, opt.iterations, [&](size_t& n) {
+        snap = SceneSnapshot::build(scene);
+        n = static_cast<size_t>(snap.size());
+    });
+    std::vector<CharacterInfo> characters;
+    report("findCharacters (snapshot)", scene, opt.iterations, [&](size_t& n) {
+        characters = SceneAnalysis::findCharacters(snap);
+        n = characters.size();
+    });
+    report("findBlendShapeGroups (snapshot)", scene, opt.iterations, [&](size_t& n) {
+        n = SceneAnalysis::findBlendShapeGroups(snap).size();
+    });
+    report("findSkeletonBlendShapeCombos (snapshot)", scene, opt.iterations, [&](size_t& n) {
+        n = SceneAnalysis::findSkeletonBlendShapeCombos(snap, characters).size();
+    });
+
+    ScanResult legacy;
+    report("scan scene (per-node queries)", scene, opt.iterations, [&](size_t& n) {
+        legacy = legacyScanScene(scene);
+        n = legacy.combos.size();
+    });
+    ScanResult current;
+    report("scan scene (snapshot)", scene, opt.iterations, [&](size_t& n) {
+        current = scanScene(scene);
+        n = current.combos.size();
+    });
+    bool ok = sameScan(legacy, current);
+    if (!ok) std::cout << "  MISMATCH: the snapshot scan found different targets\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// mayaStringScanBench — throughput of the .mb fallback string scan.
+//
+// Compares the previous FileAnalyzer implementation (two byte-at-a-time
+// passes that materialize every ASCII and UTF-16LE run as a std::string)
+// with PrintableRuns::scan() on the same buffers, checks that both find the
+// same runs, and prints MB/s for each.
+//
+//   mayaStringScanBench [--iterations <n>] [file.mb ...]
+//
+// Without files, a 64 MB synthetic buffer (random binary with embedded ASCII
+// and UTF-16LE paths) is used.
+
+#include "MappedFile.h"
+#include "PrintableRuns.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kMinLength = 6;
+
+// ---- Previous implementation (FileAnalyzer before the single-pass scan) ----
+
+std::vector<std::string> legacyAscii(const char* data, size_t size, int minLength)
+{
+    std::vector<std::string> strings;
+    std::string current;
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char byte = (unsigned char)data[i];
+        if (byte >= 32 && byte <= 126) {
+            current += (char)byte;
+        } else {
+            if ((int)current.size() >= minLength) strings.push_back(current);
+            current.clear();
+        }
+    }
+    if ((int)current.size() >= minLength) strings.push_back(current);
+    return strings;
+}
+
+std::vector<std::string> legacyUtf16(const char* data, size_t size, int minLength)
+{
+    std::vector<std::string> strings;
+    std::string chars;
+    for (size_t i = 0; i + 1 < size; i += 2) {
+        unsigned char lo = (unsigned char)data[i];
+        unsigned char hi = (unsigned char)data[i + 1];
+        if (hi == 0 && lo >= 32 && lo <= 126) {
+            chars += (char)lo;
+        } else {
+            if ((int)chars.size() >= minLength) strings.push_back(chars);
+            chars.clear();
+        }
+    }
+    if ((int)chars.size() >= minLength) strings.push_back(chars);
+    return strings;
+}
+
+// Checksum over run lengths and first/last characters, so the compiler
+// cannot drop the work and both scanners can be compared cheaply.
+struct Digest {
+    uint64_t runs = 0;
+    uint64_t hash = 0;
+
+    void add(const char* s, size_t n)
+    {
+        ++runs;
+        hash = hash * 1099511628211ULL + n;
+        hash ^= (unsigned char)s[0] | ((uint64_t)(unsigned char)s[n - 1] << 8);
+    }
+    bool operator==(const Digest& o) const { return runs == o.runs && hash == o.hash; }
+};
+
+struct ScanDigest {
+    Digest ascii;
+    Digest utf16;
+    uint64_t runs() const { return ascii.runs + utf16.runs; }
+    bool operator==(const ScanDigest& o) const { return ascii == o.ascii && utf16 == o.utf16; }
+};
+
+ScanDigest runLegacy(const char* data, size_t size)
+{
+    ScanDigest d;
+    for (const auto& s : legacyAscii(data, size, kMinLength)) d.ascii.add(s.data(), s.size());
+    for (const auto& s : legacyUtf16(data, size, kMinLength)) d.utf16.add(s.data(), s.size());
+    return d;
+}
+
+ScanDigest runSinglePass(const char* data, size_t size)
+{
+    ScanDigest d;
+    PrintableRuns::scan(data, size, kMinLength, [&](std::string_view run, PrintableRuns::Encoding e) {
+        (e == PrintableRuns::Encoding::Ascii ? d.ascii : d.utf16).add(run.data(), run.size());
+    });
+    return d;
+}
+
+std::vector<char> syntheticBuffer(size_t size)
+{
+    std::vector<char> buf(size);
+    std::mt19937_64 rng(12345);
+    for (auto& c : buf) c = (char)(rng() & 0xFF);
+
+    const std::string paths[] = {
+        "C:/proj/assets/chr/hero/rig/hero_rig_v012.ma",
+        "//server/show/seq010/sh0100/anim/cache/hero.abc",
+        "/mnt/proj/tex/hero_diffuse.1001.exr",
+        "D:/textures/env/forest_ground_albedo.tx",
+    };
+    for (size_t pos = 0, i = 0; pos + 256 < size; pos += 4096, ++i) {
+        const std::string& p = paths[i % 4];
+        if (i % 2 == 0) {
+            std::copy(p.begin(), p.end(), buf.begin() + pos);
+            buf[pos + p.size()] = 0;
+        } else {
+            pos &= ~(size_t)1;
+            for (size_t k = 0; k < p.size(); ++k) {
+                buf[pos + 2 * k] = p[k];
+                buf[pos + 2 * k + 1] = 0;
+            }
+            buf[pos + 2 * p.size()] = 0;
+            buf[pos + 2 * p.size() + 1] = 0;
+        }
+    }
+    return buf;
+}
+
+template <typename Fn>
+double bestSeconds(int iterations, Fn&& fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < iterations; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+bool benchBuffer(const std::string& name, const char* data, size_t size, int iterations)
+{
+    ScanDigest legacy, fast;
+    double tLegacy = bestSeconds(iterations, [&]() { legacy = runLegacy(data, size); });
+    double tFast = bestSeconds(iterations, [&]() { fast = runSinglePass(data, size); });
+
+    double mb = size / (1024.0 * 1024.0);
+    std::cout << name << " (" << mb << " MB, " << legacy.runs() << " runs)\n"
+              << "  legacy two-pass:  " << mb / tLegacy << " MB/s\n"
+              << "  single-pass " << PrintableRuns::implementation() << ": " << mb / tFast << " MB/s ("
+              << tLegacy / tFast << "x)\n";
+    if (!(legacy == fast)) {
+        std::cout << "  MISMATCH: single-pass found " << fast.runs() << " runs\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int iterations = 5;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if ((a == "--iterations" || a == "-n") && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else {
+            files.push_back(a);
+        }
+    }
+
+    bool ok = true;
+    if (files.empty()) {
+        std::vector<char> buf = syntheticBuffer(64 * 1024 * 1024);
+        ok = benchBuffer("synthetic", buf.data(), buf.size(), iterations);
+    }
+    for (const auto& f : files) {
+        MappedFile file;
+        if (!file.open(f)) {
+            std::cerr << "error: cannot open " << f << "\n";
+            ok = false;
+            continue;
+        }
+        ok = benchBuffer(f, file.data(), file.size(), iterations) && ok;
+    }
+    return ok ? 0 : 1;
+}
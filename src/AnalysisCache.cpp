@@ -0,0 +1,253 @@
+#include "AnalysisCache.h"
+#include "FileFingerprint.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// File layout (little-endian):
+//   "MDCACHE\0" u32 version u32 entryCount
+//   per entry: str path, u64 size, i64 mtime, u64 fingerprint,
+//              5 x (u32 count, count x str)  references/textures/caches/
+//                                            requiredPlugins/warnings
+//   str = u32 byteLength + UTF-8 bytes
+//
+// Bump kVersion whenever FileAnalyzer changes what it extracts, so stale
+// results from an older parser are dropped instead of replayed.
+const char kMagic[8] = {'M', 'D', 'C', 'A', 'C', 'H', 'E', '\0'};
+const uint32_t kVersion = 4;  // 4: dependency paths stored absolute
+
+void putU32(std::string& out, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out += (char)((v >> (8 * i)) & 0xFF);
+}
+
+void putU64(std::string& out, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) out += (char)((v >> (8 * i)) & 0xFF);
+}
+
+void putStr(std::string& out, const std::string& s)
+{
+    putU32(out, (uint32_t)s.size());
+    out += s;
+}
+
+void putList(std::string& out, const std::vector<std::string>& list)
+{
+    putU32(out, (uint32_t)list.size());
+    for (const auto& s : list) putStr(out, s);
+}
+
+// Bounds-checked reader over the mapped cache file; any overrun marks the
+// whole file as corrupt.
+struct Reader {
+    const unsigned char* p;
+    const unsigned char* end;
+    bool ok = true;
+
+    uint64_t get(int bytes)
+    {
+        if (!ok || end - p < bytes) {
+            ok = false;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+        p += bytes;
+        return v;
+    }
+
+    std::string str()
+    {
+        uint64_t n = get(4);
+        if (!ok || (uint64_t)(end - p) < n) {
+            ok = false;
+            return std::string();
+        }
+        std::string s((const char*)p, (size_t)n);
+        p += n;
+        return s;
+    }
+
+    void list(std::vector<std::string>& out)
+    {
+        uint64_t n = get(4);
+        for (uint64_t i = 0; ok && i < n; ++i) out.push_back(str());
+    }
+};
+
+} // namespace
+
+AnalysisCache::AnalysisCache(bool fingerprint)
+    : fingerprint_(fingerprint)
+{
+}
+
+bool AnalysisCache::load(const std::string& cachePath)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    dirty_ = false;
+
+    std::error_code ec;
+    if (!fs::exists(fs::u8path(cachePath), ec)) return true;
+
+    MappedFile file;
+    if (!file.open(cachePath)) return false;
+
+    Reader r{reinterpret_cast<const unsigned char*>(file.data()),
+             reinterpret_cast<const unsigned char*>(file.data()) + file.size()};
+    if (file.size() < sizeof(kMagic) || std::memcmp(file.data(), kMagic, sizeof(kMagic)) != 0) return false;
+    r.p += sizeof(kMagic);
+    if (r.get(4) != kVersion) return true;  // older format: start empty
+
+    uint64_t count = r.get(4);
+    std::unordered_map<std::string, Entry> loaded;
+    for (uint64_t i = 0; r.ok && i < count; ++i) {
+        std::string path = r.str();
+        Entry e;
+        e.size = r.get(8);
+        e.mtime = (int64_t)r.get(8);
+        e.fingerprint = r.get(8);
+        r.list(e.analysis.references);
+        r.list(e.analysis.textures);
+        r.list(e.analysis.caches);
+        r.list(e.analysis.requiredPlugins);
+        r.list(e.analysis.warnings);
+        if (r.ok) loaded[std::move(path)] = std::move(e);
+    }
+    if (!r.ok) return false;
+
+    entries_.swap(loaded);
+    return true;
+}
+
+bool AnalysisCache::save(const std::string& cachePath) const
+{
+    std::string buf;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_) return true;
+
+        buf.append(kMagic, sizeof(kMagic));
+        putU32(buf, kVersion);
+        putU32(buf, (uint32_t)entries_.size());
+        for (const auto& kv : entries_) {
+            const Entry& e = kv.second;
+            putStr(buf, kv.first);
+            putU64(buf, e.size);
+            putU64(buf, (uint64_t)e.mtime);
+            putU64(buf, e.fingerprint);
+            putList(buf, e.analysis.references);
+            putList(buf, e.analysis.textures);
+            putList(buf, e.analysis.caches);
+            putList(buf, e.analysis.requiredPlugins);
+            putList(buf, e.analysis.warnings);
+        }
+    }
+
+    // Runs sharing one cache file (nightly preflight) each write their own
+    // temp file, named after their process and thread; the last rename wins.
+#ifdef _WIN32
+    const unsigned long pid = GetCurrentProcessId();
+#else
+    const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    fs::path target = fs::u8path(cachePath);
+    fs::path temp = target;
+    temp += "." + std::to_string(pid) + "-" +
+            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFFFF) + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(buf.data(), (std::streamsize)buf.size());
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool AnalysisCache::identify(const std::string& path, FileIdentity& id) const
+{
+    std::error_code ec;
+    fs::path p = fs::absolute(fs::u8path(path), ec);
+    if (ec) return false;
+
+    uint64_t size = fs::file_size(p, ec);
+    if (ec) return false;
+    auto mtime = fs::last_write_time(p, ec);
+    if (ec) return false;
+
+    id.path = p.lexically_normal().generic_u8string();
+    id.size = size;
+    id.mtime = (int64_t)mtime.time_since_epoch().count();
+    id.fingerprint = fingerprint_ ? FileFingerprint::sampled(path, size) : 0;
+    return true;
+}
+
+bool AnalysisCache::lookup(const FileIdentity& id, CachedAnalysis& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id.path);
+    if (it == entries_.end() || it->second.size != id.size || it->second.mtime != id.mtime ||
+        it->second.fingerprint != id.fingerprint) {
+        ++misses_;
+        return false;
+    }
+    out = it->second.analysis;
+    ++hits_;
+    return true;
+}
+
+void AnalysisCache::store(const FileIdentity& id, const CachedAnalysis& entry)
+{
+    Entry e;
+    e.size = id.size;
+    e.mtime = id.mtime;
+    e.fingerprint = id.fingerprint;
+    e.analysis = entry;
+
+    // Entries are keyed by absolute scene path, so a dependency path that
+    // is relative to the current directory (scene given as a relative
+    // path) would resolve wrongly when replayed from another directory.
+    auto absolutize = [](std::vector<std::string>& paths) {
+        for (auto& p : paths) {
+            fs::path fp = fs::u8path(p);
+            if (p.empty() || !fp.is_relative()) continue;
+            std::error_code ec;
+            fs::path abs = fs::absolute(fp, ec);
+            if (!ec) p = abs.lexically_normal().generic_u8string();
+        }
+    };
+    absolutize(e.analysis.references);
+    absolutize(e.analysis.textures);
+    absolutize(e.analysis.caches);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[id.path] = std::move(e);
+    dirty_ = true;
+}
+
+size_t AnalysisCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Identity of a scene file on disk. Two identities match when path, size
+// and modification time are equal (and the fingerprint, when enabled).
+struct FileIdentity {
+    std::string path;          // absolute, forward slashes
+    uint64_t size = 0;
+    int64_t mtime = 0;         // filesystem clock ticks
+    uint64_t fingerprint = 0;  // 0 when fingerprinting is off
+};
+
+// What FileAnalyzer extracted from one scene: dependency paths (already
+// normalized; store() makes relative ones absolute), `requires` entries and
+// parser warnings. Existence and size are not stored; they are checked
+// again on every lookup.
+struct CachedAnalysis {
+    std::vector<std::string> references;
+    std::vector<std::string> textures;
+    std::vector<std::string> caches;
+    std::vector<std::string> requiredPlugins;  // plugin, version, plugin, ...
+    std::vector<std::string> warnings;
+};
+
+// Persistent parse cache shared by FileAnalyzer instances.
+//
+// A repeat analysis of an unchanged scene becomes a lookup instead of a
+// parse. The cache lives in one binary file per project (load()/save());
+// entries for files that changed are replaced on the next store(). All
+// methods are thread-safe.
+class AnalysisCache {
+public:
+    // With fingerprint on, identify() also takes the file's sampled
+    // fingerprint (FileFingerprint), which catches rewrites that keep size
+    // and mtime.
+    explicit AnalysisCache(bool fingerprint = false);
+
+    // Read a cache file. A missing file is an empty cache; a corrupt or
+    // outdated file is discarded. Returns false only if the file exists but
+    // could not be used.
+    bool load(const std::string& cachePath);
+
+    // Write the cache atomically (temp file + rename). No-op when nothing
+    // was stored since load().
+    bool save(const std::string& cachePath) const;
+
+    // Stat (and optionally fingerprint) a file. False if it cannot be read.
+    bool identify(const std::string& path, FileIdentity& id) const;
+
+    bool lookup(const FileIdentity& id, CachedAnalysis& out) const;
+    void store(const FileIdentity& id, const CachedAnalysis& entry);
+
+    size_t size() const;
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+private:
+    struct Entry {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t fingerprint = 0;
+        CachedAnalysis analysis;
+    };
+
+    bool fingerprint_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    bool dirty_ = false;
+    mutable std::atomic<size_t> hits_{0};
+    mutable std::atomic<size_t> misses_{0};
+};
+
+#endif // ANALYSISCACHE_H
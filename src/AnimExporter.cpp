@@ -1,4 +1,6 @@
 ﻿#include "AnimExporter.h"
+#include "MayaSceneQuery.h"
+#include "SceneAnalysis.h"
 #include "NamingUtils.h"
 #include "PluginLog.h"
 
@@ -434,13 +436,11 @@ static std::vector<std::string> collectMeshTransformsUnderNode(const std::string
     std::set<std::string> meshTransforms;
     if (node.empty()) return std::vector<std::string>();
 
-    std::vector<std::string> meshShapes = melQueryStringArray(
-        "listRelatives -allDescendents -type \"mesh\" -fullPath \"" + node + "\"");
-    for (const auto& shape : meshShapes) {
-        std::vector<std::string> parent = melQueryStringArray(
-            "listRelatives -parent -fullPath \"" + shape + "\"");
+    MayaSceneQuery scene;
+    for (const auto& shape : scene.descendants(node, "mesh")) {
+        std::string parent = scene.parent(shape);
         if (!parent.empty()) {
-            meshTransforms.insert(parent[0]);
+            meshTransforms.insert(parent);
         }
     }
 
@@ -464,14 +464,18 @@ static std::vector<std::string> collectMeshTransformsByNamespace(const std::stri
         return std::vector<std::string>();
     }
 
-    std::vector<std::string> meshShapes = melQueryStringArray(
-        "ls -long -type \"mesh\" \"" + ns + ":*\"");
-
-    for (const auto& shape : meshShapes) {
-        std::vector<std::string> parent = melQueryStringArray(
-            "listRelatives -parent -fullPath \"" + shape + "\"");
+    // Meshes directly in the namespace (`ls "<ns>:*"`)
+    MayaSceneQuery scene;
+    const std::string prefix = ns + ":";
+    for (const auto& shape : scene.nodesOfType("mesh")) {
+        std::string shapeLeaf = SceneAnalysis::shortName(shape);
+        if (shapeLeaf.compare(0, prefix.size(), prefix) != 0 ||
+            shapeLeaf.find(':', prefix.size()) != std::string::npos) {
+            continue;
+        }
+        std::string parent = scene.parent(shape);
         if (!parent.empty()) {
-            meshTransforms.insert(parent[0]);
+            meshTransforms.insert(parent);
         }
     }
 
@@ -484,37 +488,31 @@ static std::vector<std::string> collectSkinnedMeshTransformsForJoints(const std:
     std::set<std::string> skinClusters;
     std::set<std::string> meshShapes;
     std::set<std::string> meshTransforms;
+    MayaSceneQuery scene;
 
     for (const auto& j : joints) {
-        std::vector<std::string> clusters = melQueryStringArray(
-            "listConnections -source true -destination false -type \"skinCluster\" \"" + j + "\"");
+        std::vector<std::string> clusters = scene.connections(j, "skinCluster", true, false);
 
         // Fallback: some rigs connect skinClusters in both directions or via intermediate nodes.
         if (clusters.empty()) {
-            clusters = melQueryStringArray(
-                "listConnections -source true -destination true -type \"skinCluster\" \"" + j + "\"");
+            clusters = scene.connections(j, "skinCluster", true, true);
         }
 
         skinClusters.insert(clusters.begin(), clusters.end());
     }
 
     for (const auto& skin : skinClusters) {
-        std::vector<std::string> geos = melQueryStringArray("skinCluster -q -g \"" + skin + "\"");
-        for (const auto& g : geos) {
-            std::vector<std::string> full = melQueryStringArray("ls -long \"" + g + "\"");
-            std::string geo = full.empty() ? g : full[0];
-            std::string geoType = melQueryString("nodeType \"" + geo + "\"");
+        for (const auto& geo : scene.deformedGeometry(skin)) {
+            std::string geoType = scene.nodeType(geo);
 
             if (geoType == "mesh") {
                 meshShapes.insert(geo);
-                std::vector<std::string> parent = melQueryStringArray(
-                    "listRelatives -parent -fullPath \"" + geo + "\"");
+                std::string parent = scene.parent(geo);
                 if (!parent.empty()) {
-                    meshTransforms.insert(parent[0]);
+                    meshTransforms.insert(parent);
                 }
             } else if (geoType == "transform") {
-                std::vector<std::string> shapes = melQueryStringArray(
-                    "listRelatives -children -type \"mesh\" -fullPath \"" + geo + "\"");
+                std::vector<std::string> shapes = scene.children(geo, "mesh");
                 if (!shapes.empty()) {
                     meshShapes.insert(shapes.begin(), shapes.end());
                     meshTransforms.insert(geo);
@@ -756,7 +754,8 @@ void restoreSceneTimeUnit(const std::string& previousUnit) {
 }
 
 std::set<int> batchBakeAll(const std::vector<ExportItem>& selectedItems,
-                           int startFrame, int endFrame) {
+                           int startFrame, int endFrame,
+                           const SceneQuery& scene) {
     std::vector<std::string> transformNodes;
     std::vector<std::string> bsAttrs;
     std::set<int> failedIndices;
@@ -791,8 +790,7 @@ std::set<int> batchBakeAll(const std::vector<ExportItem>& selectedItems,
             // Many production rigs lock or drive joint channels; baking all joints first can
             // accidentally flatten the motion to static keys. Skeleton baking is handled in
             // exportSkeletonFbx/exportSkeletonFbxViaDuplicate per-rig.
-            std::string listCmd = "listRelatives -allDescendents -type \"joint\" -fullPath \"" + item.node + "\"";
-            std::vector<std::string> allJoints = melQueryStringArray(listCmd);
+            std::vector<std::string> allJoints = scene.descendants(item.node, "joint");
             allJoints.push_back(item.node);
             {
                 std::ostringstream dbg;
@@ -823,10 +821,10 @@ std::set<int> batchBakeAll(const std::vector<ExportItem>& selectedItems,
                 PluginLog::warn("AnimExporter", "BatchBake: Mesh node missing: " + item.node);
                 failedIndices.insert(idx);
                 continue;
-            }            // Find blendShape nodes in history (robust path).
-            std::string histCmd = "listHistory -pruneDagObjects true \"" + item.node + "\"";
+            }
+            // Find blendShape nodes in history (robust path).
             std::vector<std::string> history;
-            if (!melQueryStringArrayChecked(histCmd, history)) {
+            if (!scene.history(item.node, history)) {
                 debugWarn("batchBakeAll: listHistory failed on mesh: " + item.node);
                 failedIndices.insert(idx);
                 continue;
@@ -835,32 +833,12 @@ std::set<int> batchBakeAll(const std::vector<ExportItem>& selectedItems,
             bool foundBS = false;
             int blendShapeCount = 0;
             for (const auto& histNode : history) {
-                std::string typeCmd = "nodeType \"" + histNode + "\"";
-                MString nodeType;
-                MGlobal::executeCommand(utf8ToMString(typeCmd), nodeType);
-                if (toUtf8(nodeType) != "blendShape") continue;
+                if (scene.nodeType(histNode) != "blendShape") continue;
 
                 foundBS = true;
                 ++blendShapeCount;
 
-                std::string wcCmd = "blendShape -q -weightCount \"" + histNode + "\"";
-                int weightCount = 0;
-                MGlobal::executeCommand(utf8ToMString(wcCmd), weightCount);
-
-                for (int i = 0; i < weightCount; ++i) {
-                    std::ostringstream attrCmd;
-                    attrCmd << "aliasAttr -q \"" << histNode << ".weight[" << i << "]\"";
-                    MString alias;
-                    MStatus status = MGlobal::executeCommand(utf8ToMString(attrCmd.str()), alias);
-
-                    std::string attrName;
-                    if (status == MS::kSuccess && alias.length() > 0) {
-                        attrName = histNode + "." + toUtf8(alias);
-                    } else {
-                        std::ostringstream fallback;
-                        fallback << histNode << ".weight[" << i << "]";
-                        attrName = fallback.str();
-                    }
+                for (const auto& attrName : SceneAnalysis::blendShapeWeightAttrs(scene, histNode)) {
                     if (seenAttrs.count(attrName) == 0) {
                         seenAttrs.insert(attrName);
                         bsAttrs.push_back(attrName);
@@ -1088,20 +1066,18 @@ static ExportResult exportSkeletonFbxViaDuplicate(const std::string& srcRootJoin
         // Some rigs parent meshes/controllers under joints; FBXExport -s includes descendants, which would
         // accidentally export meshes even when we only select joints.
         if (opts.skelAnimationOnly) {
-            std::vector<std::string> meshShapes = melQueryStringArray(
-                "listRelatives -allDescendents -type \"mesh\" -fullPath \"" + dupRoot + "\"");
+            MayaSceneQuery scene;
+            std::vector<std::string> meshShapes = scene.descendants(dupRoot, "mesh");
 
             std::set<std::string> meshParentTransforms;
             int meshShapesDeleted = 0;
             int meshParentsDeleted = 0;
 
             for (const auto& shape : meshShapes) {
-                std::vector<std::string> parents = melQueryStringArray(
-                    "listRelatives -parent -fullPath \"" + shape + "\"");
-                if (parents.empty()) continue;
+                std::string parent = scene.parent(shape);
+                if (parent.empty()) continue;
 
-                std::string parent = parents[0];
-                std::string parentType = melQueryString("nodeType \"" + parent + "\"");
+                std::string parentType = scene.nodeType(parent);
                 if (parentType == "joint") {
                     // Rare case: mesh shape directly under a joint. Delete the shape only.
                     if (melExec("delete \"" + shape + "\"")) {
@@ -1126,12 +1102,10 @@ static ExportResult exportSkeletonFbxViaDuplicate(const std::string& srcRootJoin
         }
 
         // 3) Collect original + duplicate joint lists (order must match)
-        std::vector<std::string> origJoints = melQueryStringArray(
-            "listRelatives -allDescendents -type \"joint\" -fullPath \"" + srcRootJoint + "\"");
+        std::vector<std::string> origJoints = MayaSceneQuery().descendants(srcRootJoint, "joint");
         origJoints.push_back(srcRootJoint);
 
-        std::vector<std::string> dupJoints = melQueryStringArray(
-            "listRelatives -allDescendents -type \"joint\" -fullPath \"" + dupRoot + "\"");
+        std::vector<std::string> dupJoints = MayaSceneQuery().descendants(dupRoot, "joint");
         dupJoints.push_back(dupRoot);
 
         {
@@ -1277,8 +1251,7 @@ static ExportResult exportSkeletonFbxViaDuplicate(const std::string& srcRootJoin
                 dupRoot = toUtf8(fn.fullPathName());
             }
 
-            std::vector<std::string> allJoints = melQueryStringArray(
-                "listRelatives -allDescendents -type \"joint\" -fullPath \"" + dupRoot + "\"");
+            std::vector<std::string> allJoints = MayaSceneQuery().descendants(dupRoot, "joint");
             allJoints.push_back(dupRoot);
 
             int namespacedCount = 0;
@@ -1901,10 +1874,10 @@ ExportResult exportSkeletonFbx(const std::string& skeletonRoot,
         // Validate that rootJoint is actually a joint. If a group/transform is
         // accidentally passed in, find the most likely root joint under it.
         {
-            std::string type = melQueryString("nodeType \"" + rootJoint + "\"");
+            MayaSceneQuery scene;
+            std::string type = scene.nodeType(rootJoint);
             if (type != "joint") {
-                std::vector<std::string> joints = melQueryStringArray(
-                    "listRelatives -allDescendents -type \"joint\" -fullPath \"" + rootJoint + "\"");
+                std::vector<std::string> joints = scene.descendants(rootJoint, "joint");
                 if (joints.empty()) {
                     return makeResult(false, outputPath, 0, 0.0, {},
                                       {"No joints found under: " + rootJoint});
@@ -1914,9 +1887,8 @@ ExportResult exportSkeletonFbx(const std::string& skeletonRoot,
                 std::set<std::string> jointSet(joints.begin(), joints.end());
                 std::vector<std::string> candidates;
                 for (const auto& j : joints) {
-                    std::vector<std::string> parents = melQueryStringArray(
-                        "listRelatives -parent -type \"joint\" -fullPath \"" + j + "\"");
-                    if (parents.empty() || jointSet.count(parents[0]) == 0) {
+                    std::string parent = scene.parent(j, "joint");
+                    if (parent.empty() || jointSet.count(parent) == 0) {
                         candidates.push_back(j);
                     }
                 }
@@ -1925,10 +1897,9 @@ ExportResult exportSkeletonFbx(const std::string& skeletonRoot,
                     std::string best = candidates[0];
                     int bestCount = -1;
                     for (const auto& c : candidates) {
-                        std::vector<std::string> desc = melQueryStringArray(
-                            "listRelatives -allDescendents -type \"joint\" -fullPath \"" + c + "\"");
-                        if ((int)desc.size() > bestCount) {
-                            bestCount = (int)desc.size();
+                        int count = static_cast<int>(scene.descendants(c, "joint").size());
+                        if (count > bestCount) {
+                            bestCount = count;
                             best = c;
                         }
                     }
@@ -1963,8 +1934,7 @@ ExportResult exportSkeletonFbx(const std::string& skeletonRoot,
             warnings.push_back("Referenced export keeps original bone names; namespaces may remain");
             debugWarn("exportSkeletonFbx: referenced skeleton + AnimationOnly=false, using in-place export path");
 
-            std::vector<std::string> allJoints = melQueryStringArray(
-                "listRelatives -allDescendents -type \"joint\" -fullPath \"" + rootJoint + "\"");
+            std::vector<std::string> allJoints = MayaSceneQuery().descendants(rootJoint, "joint");
             allJoints.push_back(rootJoint);
             if (allJoints.empty()) {
                 return makeResult(false, outputPath, 0, 0.0, warnings,
@@ -2130,8 +2100,7 @@ ExportResult exportSkeletonFbx(const std::string& skeletonRoot,
         }
 
         // Collect all joints under rootJoint (full paths).
-        std::vector<std::string> jointPaths = melQueryStringArray(
-            "listRelatives -allDescendents -type \"joint\" -fullPath \"" + rootJoint + "\"");
+        std::vector<std::string> jointPaths = MayaSceneQuery().descendants(rootJoint, "joint");
         jointPaths.push_back(rootJoint);
 
         {
@@ -2234,8 +2203,7 @@ ExportResult exportSkeletonFbx(const std::string& skeletonRoot,
         }
         // Re-select all joints by querying from the (possibly renamed) rootJoint.
         {
-            std::vector<std::string> allJoints = melQueryStringArray(
-                "listRelatives -allDescendents -type \"joint\" -fullPath \"" + rootJoint + "\"");
+            std::vector<std::string> allJoints = MayaSceneQuery().descendants(rootJoint, "joint");
             allJoints.push_back(rootJoint);
 
             // Safety check: exported skeleton joints must not keep namespace prefixes.
@@ -2483,9 +2451,9 @@ ExportResult exportBlendShapeFbx(const std::string& meshNode,
         if (!outDir.empty()) ensureDir(outDir);
 
         // Verify blendShape deformers exist on this mesh before export.
+        MayaSceneQuery scene;
         std::vector<std::string> history;
-        std::string histCmd = "listHistory -pruneDagObjects true \"" + meshNode + "\"";
-        if (!melQueryStringArrayChecked(histCmd, history)) {
+        if (!scene.history(meshNode, history)) {
             return makeResult(false, outputPath, 0, 0.0, warnings,
                               {"Failed to query mesh history: " + meshNode});
         }
@@ -2493,7 +2461,7 @@ ExportResult exportBlendShapeFbx(const std::string& meshNode,
         std::vector<std::string> blendShapeNodes;
         std::vector<std::string> skinClusterNodes;
         for (const auto& n : history) {
-            std::string t = melQueryString("nodeType \"" + n + "\"");
+            std::string t = scene.nodeType(n);
             if (t == "blendShape") blendShapeNodes.push_back(n);
             if (t == "skinCluster") skinClusterNodes.push_back(n);
         }
@@ -2512,12 +2480,11 @@ ExportResult exportBlendShapeFbx(const std::string& meshNode,
                     if (seen.insert(fp).second)
                         bsSkelJoints.push_back(fp);
                     // Include non-joint parent (e.g. Face_Root transform)
-                    auto parents = melQueryStringArray(
-                        "listRelatives -parent -fullPath \"" + fp + "\"");
-                    if (!parents.empty()) {
-                        std::string pt = melQueryString("nodeType \"" + parents[0] + "\"");
-                        if (pt == "transform" && seen.insert(parents[0]).second)
-                            bsSkelTransforms.push_back(parents[0]);
+                    std::string parent = scene.parent(fp);
+                    if (!parent.empty()) {
+                        std::string pt = scene.nodeType(parent);
+                        if (pt == "transform" && seen.insert(parent).second)
+                            bsSkelTransforms.push_back(parent);
                     }
                 }
             }
@@ -2589,8 +2556,7 @@ ExportResult exportBlendShapeFbx(const std::string& meshNode,
         // When includeSkeleton is true, keep skinCluster so FBX exporter pulls in joints.
         {
             std::vector<std::string> dupHistory;
-            std::string dupHistCmd = "listHistory -pruneDagObjects true \"" + dupMesh + "\"";
-            melQueryStringArrayChecked(dupHistCmd, dupHistory);
+            scene.history(dupMesh, dupHistory);
 
             int deletedSkinClusters = 0;
             int keptSkinClusters = 0;
@@ -3125,10 +3091,10 @@ ExportResult exportSkeletonBlendShapeFbx(
     bool rootReferenced = false;
 
     {
-        std::string type = melQueryString("nodeType \"" + rootJoint + "\"");
+        MayaSceneQuery scene;
+        std::string type = scene.nodeType(rootJoint);
         if (type != "joint") {
-            std::vector<std::string> joints = melQueryStringArray(
-                "listRelatives -allDescendents -type \"joint\" -fullPath \"" + rootJoint + "\"");
+            std::vector<std::string> joints = scene.descendants(rootJoint, "joint");
             if (joints.empty()) {
                 return makeResult(false, outputPath, 0, 0.0, {},
                                   {"No joints found under: " + rootJoint});
@@ -3136,9 +3102,8 @@ ExportResult exportSkeletonBlendShapeFbx(
             std::set<std::string> jointSet(joints.begin(), joints.end());
             std::vector<std::string> candidates;
             for (const auto& j : joints) {
-                std::vector<std::string> parents = melQueryStringArray(
-                    "listRelatives -parent -type \"joint\" -fullPath \"" + j + "\"");
-                if (parents.empty() || jointSet.count(parents[0]) == 0) {
+                std::string parent = scene.parent(j, "joint");
+                if (parent.empty() || jointSet.count(parent) == 0) {
                     candidates.push_back(j);
                 }
             }
@@ -3146,10 +3111,9 @@ ExportResult exportSkeletonBlendShapeFbx(
                 std::string best = candidates[0];
                 int bestCount = -1;
                 for (const auto& c : candidates) {
-                    std::vector<std::string> desc = melQueryStringArray(
-                        "listRelatives -allDescendents -type \"joint\" -fullPath \"" + c + "\"");
-                    if ((int)desc.size() > bestCount) {
-                        bestCount = (int)desc.size();
+                    int count = static_cast<int>(scene.descendants(c, "joint").size());
+                    if (count > bestCount) {
+                        bestCount = count;
                         best = c;
                     }
                 }
@@ -3180,8 +3144,7 @@ ExportResult exportSkeletonBlendShapeFbx(
     }
 
     // Collect all joints
-    std::vector<std::string> allJoints = melQueryStringArray(
-        "listRelatives -allDescendents -type \"joint\" -fullPath \"" + rootJoint + "\"");
+    std::vector<std::string> allJoints = MayaSceneQuery().descendants(rootJoint, "joint");
     allJoints.push_back(rootJoint);
 
     // Collect skinned mesh transforms for these joints
@@ -3361,8 +3324,7 @@ ExportResult exportSkeletonBlendShapeFbx(
     }
 
     // Re-query joints after possible rename
-    allJoints = melQueryStringArray(
-        "listRelatives -allDescendents -type \"joint\" -fullPath \"" + rootJoint + "\"");
+    allJoints = MayaSceneQuery().descendants(rootJoint, "joint");
     allJoints.push_back(rootJoint);
 
     // Safety check: verify namespace cleanup result when rename path is enabled
@@ -3696,7 +3658,7 @@ static std::pair<int, int> resolveQuerySampleRange() {
     return std::make_pair(sampleStart, sampleEnd);
 }
 
-FrameRangeInfo queryFrameRange(const ExportItem& item) {
+FrameRangeInfo queryFrameRange(const ExportItem& item, const SceneQuery& scene) {
     FrameRangeInfo info;
     info.name     = item.name;
     info.type     = item.type;
@@ -3721,8 +3683,7 @@ FrameRangeInfo queryFrameRange(const ExportItem& item) {
 
     if (item.type == "camera") {
         // Camera: query transform + shape (focalLength and common shape attrs).
-        std::vector<std::string> camShapes = melQueryStringArray(
-            "listRelatives -shapes -type \"camera\" -fullPath \"" + item.node + "\"");
+        std::vector<std::string> camShapes = scene.children(item.node, "camera");
 
         if (hasKeys(item.node)) {
             double first = findKey(item.node, "first");
@@ -3817,9 +3778,7 @@ FrameRangeInfo queryFrameRange(const ExportItem& item) {
         // 1) Try explicit keyframe queries first.
         // 2) If no explicit keys exist (common for constraint-driven rigs),
         //    sample transform deltas across playback range as fallback.
-        std::string listCmd = "listRelatives -allDescendents -type \"joint\" -fullPath \""
-                              + item.node + "\"";
-        std::vector<std::string> allJoints = melQueryStringArray(listCmd);
+        std::vector<std::string> allJoints = scene.descendants(item.node, "joint");
         allJoints.push_back(item.node);
 
         for (const auto& jnt : allJoints) {
@@ -3904,11 +3863,11 @@ FrameRangeInfo queryFrameRange(const ExportItem& item) {
 
     } else if (item.type == "blendshape") {
         // BlendShape: query mesh history and filter blendShape deformers
-        std::vector<std::string> history = melQueryStringArray(
-            "listHistory -pruneDagObjects true \"" + item.node + "\"");
+        std::vector<std::string> history;
+        scene.history(item.node, history);
 
         for (const auto& histNode : history) {
-            if (melQueryString("nodeType \"" + histNode + "\"") != "blendShape") continue;
+            if (scene.nodeType(histNode) != "blendShape") continue;
             if (!hasKeys(histNode)) continue;
 
             double first = findKey(histNode, "first");
@@ -9,6 +9,7 @@
 
 // Forward declaration — full definition in NamingUtils.h
 struct ExportItem;
+class SceneQuery;
 
 struct ExportResult {
     bool success;
@@ -63,8 +64,11 @@ namespace AnimExporter {
     // Single-pass batch bake: collects ALL transform nodes and BS attrs
     // from selectedItems, then calls bakeResults once for transforms and
     // once for BS attrs.  Returns set of failed item indices.
+    // Joints and mesh histories are read through `scene` (the export's
+    // ScanSession, shared with queryFrameRange).
     std::set<int> batchBakeAll(const std::vector<ExportItem>& selectedItems,
-                               int startFrame, int endFrame);
+                               int startFrame, int endFrame,
+                               const SceneQuery& scene);
 
     // Export camera FBX (no baking, assumes already baked)
     ExportResult exportCameraFbx(const std::string& cameraTransform,
@@ -104,7 +108,7 @@ namespace AnimExporter {
     void restoreSceneTimeUnit(const std::string& previousUnit);
 
     // Query actual keyframe range for an export item (after baking)
-    FrameRangeInfo queryFrameRange(const ExportItem& item);
+    FrameRangeInfo queryFrameRange(const ExportItem& item, const SceneQuery& scene);
     // Write a frame-range log file; returns the output file path
     std::string writeFrameRangeLog(const std::string& outputDir,
                                    const std::vector<FrameRangeInfo>& ranges,
@@ -0,0 +1,419 @@
+#include "AutoMatcher.h"
+#include "FileFingerprint.h"
+#include "GlobPattern.h"
+#include "MetadataExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// Never equal to a real id: components of the original path that no indexed
+// directory has.
+const uint32_t kUnknown = 0xFFFFFFFFu;
+
+// ASCII lowercase with '/' separators, the form every comparison uses.
+std::string normalize(const std::string& path)
+{
+    std::string out = path;
+    for (auto& c : out) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        else if (c == '\\') c = '/';
+    }
+    return out;
+}
+
+// Non-empty '/'-separated parts.
+std::vector<std::string> splitParts(const std::string& path)
+{
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) end = path.size();
+        if (end > start) parts.push_back(path.substr(start, end - start));
+        start = end + 1;
+    }
+    return parts;
+}
+
+std::string extensionOf(const std::string& name)
+{
+    size_t dot = name.rfind('.');
+    return dot == std::string::npos ? std::string() : name.substr(dot);
+}
+
+// Length of a directory as the prefix of the paths FileIndex builds from it,
+// separator included.
+uint32_t prefixLength(const std::string& dir)
+{
+    if (dir.empty()) return 0;
+    return (uint32_t)(dir.back() == '/' ? dir.size() : dir.size() + 1);
+}
+
+struct Candidate {
+    uint32_t index;
+    FileIndex::Entry entry;
+    uint32_t node;
+    std::string name;  // normalized
+};
+
+// results[q] becomes the first of sameName[q] (best first) that agrees with
+// the most of queries[q]'s expected size and fingerprint; unchanged if none
+// agrees with anything.
+void verifyContent(const std::vector<AutoMatcher::Query>& queries,
+                   const std::vector<std::vector<std::string>>& sameName,
+                   std::vector<std::string>& results)
+{
+    std::vector<std::string> paths;
+    for (const auto& group : sameName) paths.insert(paths.end(), group.begin(), group.end());
+    if (paths.empty()) return;
+    std::vector<StatResult> stats = MetadataExecutor::shared().statAll(paths);
+
+    // Only candidates whose size already agrees are read.
+    std::vector<size_t> hashSlot;
+    std::vector<std::string> hashPaths;
+    std::vector<uint64_t> hashSizes;
+    size_t k = 0;
+    for (size_t q = 0; q < sameName.size(); ++q) {
+        const AutoMatcher::Query& query = queries[q];
+        for (size_t i = 0; i < sameName[q].size(); ++i, ++k) {
+            if (query.expectedFingerprint == 0 || stats[k].state != StatResult::Exists) continue;
+            if (query.expectedSize != 0 && (uint64_t)stats[k].size != query.expectedSize) continue;
+            hashSlot.push_back(k);
+            hashPaths.push_back(paths[k]);
+            hashSizes.push_back((uint64_t)stats[k].size);
+        }
+    }
+    std::vector<uint64_t> fingerprints(paths.size(), 0);
+    std::vector<uint64_t> hashes = FileFingerprint::sampledAll(hashPaths, hashSizes);
+    for (size_t h = 0; h < hashes.size(); ++h) fingerprints[hashSlot[h]] = hashes[h];
+
+    k = 0;
+    for (size_t q = 0; q < sameName.size(); ++q) {
+        const AutoMatcher::Query& query = queries[q];
+        int bestAgree = 0;
+        for (size_t i = 0; i < sameName[q].size(); ++i, ++k) {
+            if (stats[k].state != StatResult::Exists) continue;
+            int agree = 0;
+            if (query.expectedSize != 0 && (uint64_t)stats[k].size == query.expectedSize) ++agree;
+            if (query.expectedFingerprint != 0 && fingerprints[k] == query.expectedFingerprint) ++agree;
+            if (agree > bestAgree) {
+                bestAgree = agree;
+                results[q] = sameName[q][i];
+            }
+        }
+    }
+}
+
+} // namespace
+
+AutoMatcher::AutoMatcher(const std::vector<std::shared_ptr<FileIndex>>& indexes)
+    : indexes_(indexes)
+{
+    nodes_.push_back(Node{0, 0, 0, 0, 0});
+    indexDirs_.resize(indexes_.size());
+    for (size_t i = 0; i < indexes_.size(); ++i) {
+        const FileIndex& index = *indexes_[i];
+        IndexDirs& dirs = indexDirs_[i];
+        dirs.node.reserve(index.dirCount());
+        dirs.pathLen.reserve(index.dirCount());
+        for (size_t d = 0; d < index.dirCount(); ++d) {
+            std::string dir = index.dirPath(d);
+            uint32_t node = 0;
+            for (const auto& part : splitParts(normalize(dir))) {
+                node = childNode(node, internComponent(part));
+            }
+            dirs.node.push_back(node);
+            dirs.pathLen.push_back(prefixLength(dir));
+        }
+    }
+}
+
+uint32_t AutoMatcher::internComponent(const std::string& lowered)
+{
+    return components_.emplace(lowered, (uint32_t)components_.size()).first->second;
+}
+
+uint32_t AutoMatcher::childNode(uint32_t parent, uint32_t component)
+{
+    uint64_t key = ((uint64_t)parent << 32) | component;
+    auto it = children_.find(key);
+    if (it != children_.end()) return it->second;
+
+    Node node;
+    node.parent = parent;
+    node.depth = nodes_[parent].depth + 1;
+
+    // The parent's components plus this one, then the same set sorted.
+    node.partsOff = (uint32_t)arena_.size();
+    size_t parentOff = nodes_[parent].partsOff;
+    for (uint32_t k = 0; k + 1 < node.depth; ++k) arena_.push_back(arena_[parentOff + k]);
+    arena_.push_back(component);
+
+    node.distinctOff = (uint32_t)arena_.size();
+    for (uint32_t k = 0; k < node.depth; ++k) arena_.push_back(arena_[node.partsOff + k]);
+    auto first = arena_.begin() + node.distinctOff;
+    std::sort(first, arena_.end());
+    arena_.erase(std::unique(first, arena_.end()), arena_.end());
+    node.distinctCount = (uint32_t)(arena_.size() - node.distinctOff);
+
+    uint32_t id = (uint32_t)nodes_.size();
+    nodes_.push_back(node);
+    children_.emplace(key, id);
+    return id;
+}
+
+uint32_t AutoMatcher::componentId(const std::string& lowered) const
+{
+    auto it = components_.find(lowered);
+    return it == components_.end() ? kUnknown : it->second;
+}
+
+std::string AutoMatcher::match(const Query& query) const
+{
+    std::vector<std::vector<std::string>> sameName(1);
+    std::vector<std::string> results{rank(query, &sameName[0])};
+    if (!sameName[0].empty()) verifyContent({query}, sameName, results);
+    return results[0];
+}
+
+std::string AutoMatcher::rank(const Query& query, std::vector<std::string>* sameName) const
+{
+    // ---- Candidates, in key order ----
+    // A collapsed sequence answers a sequence dependency directly; the
+    // wildcard keys are only the fallback when none was found.
+    std::vector<Candidate> found;
+    std::vector<FileIndex::Entry> entries;
+    auto collect = [&](uint32_t i) {
+        for (const auto& e : entries) found.push_back({i, e, indexDirs_[i].node[e.dir], std::string()});
+        entries.clear();
+    };
+    bool sequenceFound = false;
+    for (const auto& seqKey : query.sequenceKeys) {
+        for (uint32_t i = 0; i < indexes_.size(); ++i) {
+            if (indexes_[i]->findSequence(seqKey, entries) > 0) sequenceFound = true;
+            collect(i);
+        }
+    }
+    for (const auto& key : query.keys) {
+        if (key.wildcard) {
+            if (sequenceFound) continue;
+            GlobPattern glob(key.text);
+            for (uint32_t i = 0; i < indexes_.size(); ++i) {
+                indexes_[i]->match(glob, entries);
+                collect(i);
+            }
+        } else {
+            for (uint32_t i = 0; i < indexes_.size(); ++i) {
+                indexes_[i]->find(key.text, entries);
+                collect(i);
+            }
+        }
+    }
+    if (found.empty()) return "";
+    if (found.size() == 1) return indexes_[found[0].index]->path(found[0].entry);
+
+    // Overlapping roots can return one file twice (same trie node, same
+    // name): keep the first.
+    for (auto& c : found) c.name = normalize(indexes_[c.index]->name(c.entry));
+    std::vector<uint32_t> order(found.size());
+    for (uint32_t k = 0; k < order.size(); ++k) order[k] = k;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (found[a].node != found[b].node) return found[a].node < found[b].node;
+        return found[a].name < found[b].name;
+    });
+    std::vector<bool> duplicate(found.size(), false);
+    for (size_t k = 1; k < order.size(); ++k) {
+        const Candidate& prev = found[order[k - 1]];
+        const Candidate& cur = found[order[k]];
+        if (cur.node == prev.node && cur.name == prev.name) duplicate[order[k]] = true;
+    }
+
+    // ---- Original path, in the same component ids ----
+    std::vector<std::string> origParts = splitParts(normalize(query.originalPath));
+    std::string origName = origParts.empty() ? std::string() : origParts.back();
+    std::string origExt = extensionOf(origName);
+    std::vector<uint32_t> origDirs;
+    std::vector<uint32_t> origSet;
+    for (size_t i = 0; i < origParts.size(); ++i) {
+        uint32_t id = componentId(origParts[i]);
+        if (i + 1 < origParts.size()) origDirs.push_back(id);
+        if (id != kUnknown) origSet.push_back(id);
+    }
+    std::sort(origSet.begin(), origSet.end());
+    origSet.erase(std::unique(origSet.begin(), origSet.end()), origSet.end());
+
+    // ---- Score ----
+    int bestScore = -1;
+    int bestTieBreak = 0;
+    size_t best = 0;
+    std::vector<int> scores(found.size(), 0);
+    std::vector<int> tieBreaks(found.size(), 0);
+    for (size_t c = 0; c < found.size(); ++c) {
+        if (duplicate[c]) continue;
+        const Candidate& cand = found[c];
+        const Node& node = nodes_[cand.node];
+        const uint32_t* parts = arena_.data() + node.partsOff;
+        const uint32_t* distinct = arena_.data() + node.distinctOff;
+        std::string candExt = extensionOf(cand.name);
+
+        int score = 0;
+        if (cand.name == origName) score += 120;
+        if (!candExt.empty() && candExt == origExt) score += 25;
+
+        // Trailing directories shared with the original path
+        size_t oi = origDirs.size();
+        size_t ci = node.depth;
+        while (oi > 0 && ci > 0 && origDirs[oi - 1] == parts[ci - 1]) {
+            score += 15;
+            --oi;
+            --ci;
+        }
+
+        // Distinct components (directories and the name) in the original
+        size_t a = 0, b = 0;
+        while (a < node.distinctCount && b < origSet.size()) {
+            if (distinct[a] < origSet[b]) {
+                ++a;
+            } else if (origSet[b] < distinct[a]) {
+                ++b;
+            } else {
+                ++score;
+                ++a;
+                ++b;
+            }
+        }
+        if (std::find(origParts.begin(), origParts.end(), cand.name) != origParts.end()) {
+            uint32_t nameId = componentId(cand.name);
+            bool nameIsDir = nameId != kUnknown &&
+                             std::binary_search(distinct, distinct + node.distinctCount, nameId);
+            if (!nameIsDir) ++score;
+        }
+
+        uint32_t length = indexDirs_[cand.index].pathLen[cand.entry.dir] + (uint32_t)cand.name.size();
+        int tieBreak = -static_cast<int>(length);
+        scores[c] = score;
+        tieBreaks[c] = tieBreak;
+        if (score > bestScore || (score == bestScore && tieBreak > bestTieBreak)) {
+            bestScore = score;
+            bestTieBreak = tieBreak;
+            best = c;
+        }
+    }
+
+    // ---- Same-name candidates, for content verification ----
+    if (sameName && (query.expectedSize != 0 || query.expectedFingerprint != 0)) {
+        std::vector<size_t> group;
+        for (size_t c = 0; c < found.size(); ++c) {
+            if (!duplicate[c] && found[c].name == found[best].name) group.push_back(c);
+        }
+        if (group.size() > 1) {
+            std::stable_sort(group.begin(), group.end(), [&](size_t a, size_t b) {
+                if (scores[a] != scores[b]) return scores[a] > scores[b];
+                return tieBreaks[a] > tieBreaks[b];
+            });
+            if (group.size() > kMaxVerify) group.resize(kMaxVerify);
+            for (size_t c : group) sameName->push_back(indexes_[found[c].index]->path(found[c].entry));
+        }
+    }
+    return indexes_[found[best].index]->path(found[best].entry);
+}
+
+std::vector<std::string> AutoMatcher::matchAll(const std::vector<Query>& queries,
+                                               const ProgressFn& progress,
+                                               unsigned threads) const
+{
+    std::vector<std::string> results(queries.size());
+    std::vector<std::vector<std::string>> sameName(queries.size());
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::atomic<bool> stop{false};
+
+    auto worker = [&]() {
+        while (!stop.load()) {
+            size_t i = next.fetch_add(1);
+            if (i >= queries.size()) break;
+            results[i] = rank(queries[i], &sameName[i]);
+            done.fetch_add(1);
+        }
+    };
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned n = (unsigned)std::min<size_t>(threads, queries.size());
+    if (n <= 1 && !progress) {
+        worker();
+        verifyContent(queries, sameName, results);
+        return results;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(n);
+    for (unsigned t = 0; t < n; ++t) pool.emplace_back(worker);
+    while (done.load() < queries.size() && !stop.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        if (progress && !progress(done.load())) stop = true;
+    }
+    for (auto& t : pool) t.join();
+    if (progress && !stop.load()) progress(done.load());
+    if (!stop.load()) verifyContent(queries, sameName, results);
+    return results;
+}
+
+StreamMatcher::StreamMatcher(const std::vector<AutoMatcher::Query>& queries)
+    : parentDir_(queries.size())
+    , matched_(queries.size(), 0)
+{
+    for (size_t q = 0; q < queries.size(); ++q) {
+        std::vector<std::string> parts = splitParts(normalize(queries[q].originalPath));
+        if (parts.size() < 2) continue;  // no parent directory to confirm with
+        parentDir_[q] = FileIndex::foldCase(parts[parts.size() - 2]);
+        for (const auto& key : queries[q].keys) {
+            if (!key.wildcard) byKey_.emplace(key.text, q);
+        }
+    }
+}
+
+void StreamMatcher::offer(const std::string& dir, const std::vector<std::string>& names)
+{
+    if (byKey_.empty()) return;
+    std::string dirName = dir;
+    while (dirName.size() > 1 && dirName.back() == '/') dirName.pop_back();
+    dirName = FileIndex::foldCase(dirName.substr(dirName.rfind('/') + 1));
+
+    std::vector<Hit> found;
+    for (const auto& name : names) {
+        auto range = byKey_.equal_range(FileIndex::foldCase(name));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (parentDir_[it->second] != dirName) continue;
+            std::string path = dir;
+            if (path.empty() || path.back() != '/') path += '/';
+            found.push_back({it->second, path + name});
+        }
+    }
+    if (found.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& hit : found) {
+        if (matched_[hit.query]) continue;
+        matched_[hit.query] = 1;
+        ++hitCount_;
+        hits_.push_back(std::move(hit));
+    }
+}
+
+std::vector<StreamMatcher::Hit> StreamMatcher::takeHits()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Hit> out;
+    out.swap(hits_);
+    return out;
+}
+
+size_t StreamMatcher::hitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hitCount_;
+}
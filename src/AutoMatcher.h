@@ -0,0 +1,147 @@
+#pragma once
+#ifndef AUTOMATCHER_H
+#define AUTOMATCHER_H
+
+#include "FileIndex.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Batch Locate auto-match: finds the best replacement path for each missing
+// dependency among the files of one or more FileIndexes.
+//
+// Constructing a matcher maps every directory of the indexes into one
+// directory trie: each lowercased path component is interned once, each
+// directory is a node (parent, component) and keeps its component ids in a
+// shared arena. Roots that overlap share nodes. Lookups return
+// FileIndex::Entry values; a candidate is its trie node plus its name, so
+// duplicates from overlapping roots are dropped by node id, and only the
+// winning candidate's full path is built.
+//
+// Candidates are scored with integer comparisons only (exact name +120, same
+// extension +25, +15 per trailing directory shared with the original path,
+// +1 per distinct shared component; ties go to the shorter path, then to the
+// earlier candidate).
+//
+// When several candidates share the winner's file name and the query says
+// what the missing file looked like (expectedSize, expectedFingerprint, from
+// FileRecords), up to kMaxVerify of them are checked: one MetadataExecutor
+// stat batch, then FileFingerprint::sampled() on a small pool for those
+// whose size agrees. The best-scoring candidate that agrees with the most of
+// what is known wins; if none agrees the score alone decides. Unambiguous
+// queries read nothing from disk.
+//
+// matchAll() matches many dependencies on a thread pool. Every query is
+// scored on its own, in the same candidate order, so the results do not
+// depend on the thread count.
+class AutoMatcher {
+public:
+    struct Key {
+        std::string text;       // case-folded file name or wildcard pattern
+        bool wildcard = false;
+    };
+
+    struct Query {
+        std::string originalPath;               // scored against candidates
+        std::vector<std::string> sequenceKeys;  // FileIndex::findSequence keys
+        std::vector<Key> keys;                  // in priority order
+        uint64_t expectedSize = 0;              // bytes; 0 = unknown
+        uint64_t expectedFingerprint = 0;       // FileFingerprint::sampled; 0 = unknown
+    };
+
+    // Called on the calling thread with the number of queries done; return
+    // false to cancel the remaining ones.
+    using ProgressFn = std::function<bool(size_t done)>;
+
+    explicit AutoMatcher(const std::vector<std::shared_ptr<FileIndex>>& indexes);
+
+    AutoMatcher(const AutoMatcher&) = delete;
+    AutoMatcher& operator=(const AutoMatcher&) = delete;
+
+    // Best candidate path, or "" if no file matches any key.
+    std::string match(const Query& query) const;
+
+    // results[i] is match(queries[i]); queries not reached before a cancel
+    // get "". threads == 0: one per core.
+    std::vector<std::string> matchAll(const std::vector<Query>& queries,
+                                      const ProgressFn& progress = nullptr,
+                                      unsigned threads = 0) const;
+
+    // Same-name candidates checked per query, at most.
+    static constexpr size_t kMaxVerify = 16;
+
+    size_t componentCount() const { return components_.size(); }
+    size_t directoryCount() const { return nodes_.size() - 1; }
+
+private:
+    // Directory trie node. Node 0 is the empty root above every index root.
+    struct Node {
+        uint32_t parent;
+        uint32_t depth;        // number of components
+        uint32_t partsOff;     // arena_: component ids, outermost first
+        uint32_t distinctOff;  // arena_: the same ids, sorted and unique
+        uint32_t distinctCount;
+    };
+
+    struct IndexDirs {
+        std::vector<uint32_t> node;     // FileIndex directory -> trie node
+        std::vector<uint32_t> pathLen;  // length of the directory as in its paths
+    };
+
+    // The best candidate's path. With `sameName` and an expected size or
+    // fingerprint in the query, also every candidate with the best one's
+    // name when there are several, best first (at most kMaxVerify).
+    std::string rank(const Query& query, std::vector<std::string>* sameName) const;
+
+    uint32_t internComponent(const std::string& lowered);
+    uint32_t childNode(uint32_t parent, uint32_t component);
+    uint32_t componentId(const std::string& lowered) const;
+
+    std::vector<std::shared_ptr<FileIndex>> indexes_;
+    std::vector<IndexDirs> indexDirs_;                      // parallel to indexes_
+    std::unordered_map<std::string, uint32_t> components_;  // lowercased component -> id
+    std::unordered_map<uint64_t, uint32_t> children_;       // (parent << 32 | component) -> node
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> arena_;
+};
+
+// Provisional matches while Batch Locate is still walking. Offered each
+// directory's files as the walk indexes them (FileIndex::DirectoryFn, any
+// thread), it records a match for a query as soon as a file named by one of
+// its exact keys appears in a directory with the same name as the original
+// file's parent directory. The AutoMatcher pass over the finished index
+// has the final say.
+class StreamMatcher {
+public:
+    struct Hit {
+        size_t query;      // index into the queries given to the constructor
+        std::string path;
+    };
+
+    explicit StreamMatcher(const std::vector<AutoMatcher::Query>& queries);
+
+    StreamMatcher(const StreamMatcher&) = delete;
+    StreamMatcher& operator=(const StreamMatcher&) = delete;
+
+    void offer(const std::string& dir, const std::vector<std::string>& names);
+
+    // Hits found since the last call; each query is reported once.
+    std::vector<Hit> takeHits();
+    size_t hitCount() const;
+
+private:
+    std::unordered_multimap<std::string, size_t> byKey_;  // exact key -> query
+    std::vector<std::string> parentDir_;                  // folded, per query
+
+    mutable std::mutex mutex_;
+    std::vector<char> matched_;
+    std::vector<Hit> hits_;
+    size_t hitCount_ = 0;
+};
+
+#endif // AUTOMATCHER_H
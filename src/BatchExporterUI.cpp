@@ -1,6 +1,9 @@
 ﻿#include "BatchExporterUI.h"
 #include "SceneScanner.h"
 #include "AnimExporter.h"
+#include "MayaSceneQuery.h"
+#include "ScanSession.h"
+#include "SceneSnapshot.h"
 #include "PluginLog.h"
 
 #include <maya/MGlobal.h>
@@ -717,9 +720,12 @@ void BatchExporterUI::onScanScene()
     logTokens("initial");
 
     // Scan scene first, then infer missing tokens from actual node paths/names.
-    std::vector<CameraInfo> cameras = SceneScanner::findNonDefaultCameras();
-    std::vector<CharacterInfo> characters = SceneScanner::findCharacters();
-    std::vector<BlendShapeGroupInfo> bsGroups = SceneScanner::findBlendShapeGroups();
+    // One snapshot of the DAG and deformers feeds every finder.
+    MayaSceneQuery scene;
+    SceneSnapshot snap = SceneSnapshot::build(scene);
+    std::vector<CameraInfo> cameras = SceneScanner::findNonDefaultCameras(scene);
+    std::vector<CharacterInfo> characters = SceneScanner::findCharacters(snap);
+    std::vector<BlendShapeGroupInfo> bsGroups = SceneScanner::findBlendShapeGroups(snap);
 
     if (!tokensReady(tokens)) {
         int attempts = 0;
@@ -837,7 +843,8 @@ void BatchExporterUI::onScanScene()
     }
 
     // --- Skeleton+BlendShape detection: attach BS info to matching skeleton items ---
-    std::vector<SkeletonBlendShapeInfo> skelBsCombos = SceneScanner::findSkeletonBlendShapeCombos();
+    std::vector<SkeletonBlendShapeInfo> skelBsCombos =
+        SceneScanner::findSkeletonBlendShapeCombos(snap, characters);
     for (const auto& combo : skelBsCombos) {
         // Find the matching skeleton item by root joint path
         for (auto& item : exportItems_) {
@@ -863,6 +870,13 @@ void BatchExporterUI::onScanScene()
         }
     }
 
+    {
+        std::ostringstream dbg;
+        dbg << "scan: snapshotNodes=" << snap.size()
+            << ", dagNodes=" << snap.dagCount();
+        PluginLog::info("BatchExporter", dbg.str());
+    }
+
     // Resolve duplicate filenames
     NamingUtils::deduplicateFilenames(exportItems_, tokens);
 
@@ -1208,7 +1222,11 @@ void BatchExporterUI::onExport()
         }
     }
 
-    std::set<int> failedBakeIndices = AnimExporter::batchBakeAll(selectedItems, startFrame, endFrame);
+    // Joint lists and mesh histories read while baking are reused by the
+    // frame-range log after export.
+    MayaSceneQuery mayaScene;
+    ScanSession scene(mayaScene);
+    std::set<int> failedBakeIndices = AnimExporter::batchBakeAll(selectedItems, startFrame, endFrame, scene);
 
     // Mark items that failed during bake collection
     for (int fi : failedBakeIndices) {
@@ -1347,7 +1365,7 @@ void BatchExporterUI::onExport()
         for (size_t i = 0; i < selectedIndices.size(); ++i) {
             size_t idx = selectedIndices[i];
             if (exportItems_[idx].status == "done") {
-                FrameRangeInfo fri = AnimExporter::queryFrameRange(exportItems_[idx]);
+                FrameRangeInfo fri = AnimExporter::queryFrameRange(exportItems_[idx], scene);
                 if (!fri.valid) {
                     // Keep row visible in log even when range query fails.
                     fri.name     = exportItems_[idx].name;
@@ -0,0 +1,93 @@
+#include "DependencyRegistry.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+DependencyRegistry DependencyRegistry::withDefaults()
+{
+    DependencyRegistry registry;
+    registry.add("file", "fileTextureName", "texture");
+    registry.add("aiImage", "filename", "texture");
+    registry.add("AlembicNode", "abc_File", "cache");
+    registry.add("gpuCache", "cacheFileName", "cache");
+    registry.add("audio", "filename", "audio");
+    return registry;
+}
+
+const DependencyRegistry& DependencyRegistry::shared()
+{
+    static const DependencyRegistry registry = []() {
+        DependencyRegistry r = withDefaults();
+        const char* env = std::getenv("MAYA_REF_CHECKER_DEPENDENCY_TYPES");
+        if (!env) return r;
+#ifdef _WIN32
+        const char separator = ';';
+#else
+        const char separator = ':';
+#endif
+        std::stringstream list(env);
+        std::string path;
+        while (std::getline(list, path, separator)) {
+            if (path.empty()) continue;
+            std::string error;
+            r.loadFile(path, &error);
+            if (!error.empty()) r.errors_.push_back(error);
+        }
+        return r;
+    }();
+    return registry;
+}
+
+void DependencyRegistry::add(const DependencySource& source)
+{
+    for (auto& s : sources_) {
+        if (s.nodeType == source.nodeType && s.attribute == source.attribute) {
+            s.category = source.category;
+            return;
+        }
+    }
+    sources_.push_back(source);
+}
+
+void DependencyRegistry::add(const std::string& nodeType, const std::string& attribute, const std::string& category)
+{
+    add(DependencySource{nodeType, attribute, category});
+}
+
+bool DependencyRegistry::loadFile(const std::string& path, std::string* error)
+{
+    std::ifstream in(path);
+    if (!in) {
+        if (error) *error = "cannot read dependency types file: " + path;
+        return false;
+    }
+
+    std::string bad;
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream fields(line);
+        DependencySource source;
+        std::string extra;
+        if (!(fields >> source.nodeType)) continue;  // blank or comment
+        if (!(fields >> source.attribute >> source.category) || (fields >> extra)) {
+            bad += (bad.empty() ? "" : ", ") + std::to_string(lineNo);
+            continue;
+        }
+        add(source);
+    }
+
+    if (!bad.empty() && error) *error = path + ": skipped malformed line(s) " + bad;
+    return true;
+}
+
+std::string DependencyRegistry::categoryLabel(const std::string& category)
+{
+    std::string label = category;
+    if (!label.empty()) label[0] = static_cast<char>(toupper(static_cast<unsigned char>(label[0])));
+    return label;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef DEPENDENCYREGISTRY_H
+#define DEPENDENCYREGISTRY_H
+
+#include <string>
+#include <vector>
+
+// One kind of file dependency: the string attribute of a node type that
+// holds a path, and the category it is listed under ("texture", "cache",
+// "audio", ...).
+struct DependencySource {
+    std::string nodeType;
+    std::string attribute;
+    std::string category;
+};
+
+// Node types the dependency scan reads paths from. SceneScanner iterates
+// the dependency graph once and reads every registered attribute of each
+// node whose type is registered, so new node types (RenderMan, Redshift,
+// USD, in-house nodes) are added here rather than in the scan.
+//
+// Types file format, one source per line, '#' starts a comment:
+//     nodeType  attribute  category
+//     PxrTexture          filename  texture
+//     mayaUsdProxyShape   filePath  cache
+class DependencyRegistry {
+public:
+    // The built-in sources: file, aiImage, AlembicNode, gpuCache, audio.
+    static DependencyRegistry withDefaults();
+
+    // withDefaults() plus the types files listed in the environment variable
+    // MAYA_REF_CHECKER_DEPENDENCY_TYPES (';'-separated on Windows, ':'
+    // elsewhere). Loaded once per process.
+    static const DependencyRegistry& shared();
+
+    // Adds a source, or changes the category of an existing (type, attribute).
+    void add(const DependencySource& source);
+    void add(const std::string& nodeType, const std::string& attribute, const std::string& category);
+
+    // Adds the sources of a types file. Returns false and sets `error` if the
+    // file cannot be read; malformed lines are reported in `error` and skipped.
+    bool loadFile(const std::string& path, std::string* error = nullptr);
+
+    // In registration order; the scan lists dependencies in this order.
+    const std::vector<DependencySource>& sources() const { return sources_; }
+
+    // Problems met while loading the types files of shared().
+    const std::vector<std::string>& errors() const { return errors_; }
+
+    // Display label of a category: "texture" -> "Texture".
+    static std::string categoryLabel(const std::string& category);
+
+private:
+    std::vector<DependencySource> sources_;
+    std::vector<std::string> errors_;
+};
+
+#endif // DEPENDENCYREGISTRY_H
@@ -0,0 +1,288 @@
+#include "DirectoryWalker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace {
+
+// Worker identity for push() calls made from inside a task.
+thread_local DirectoryWalker* tlsWalker = nullptr;
+thread_local unsigned tlsWorker = 0;
+
+// Same folding as FileIndex::foldCase for the ASCII names in the skip list.
+std::string asciiLower(const std::string& s)
+{
+    std::string out = s;
+    for (auto& c : out) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return out;
+}
+
+#ifdef _WIN32
+std::wstring utf8ToWide(const std::string& s)
+{
+    if (s.empty()) return {};
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
+    if (len <= 0) return {};
+    std::wstring w(len, 0);
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &w[0], len);
+    return w;
+}
+
+std::string wideToUtf8(const std::wstring& w)
+{
+    if (w.empty()) return {};
+    int len = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return {};
+    std::string s(len, 0);
+    WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), &s[0], len, nullptr, nullptr);
+    return s;
+}
+#else
+int64_t statMtime(const struct stat& st)
+{
+#ifdef __APPLE__
+    return (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    return (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+// Classify an entry whose d_type did not say: never follow linked
+// directories, index linked files.
+void classifySlow(int dirFd, const char* name, bool& isDir, bool& isFile)
+{
+    struct stat st;
+    if (fstatat(dirFd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) return;
+    if (S_ISDIR(st.st_mode)) {
+        isDir = true;
+    } else if (S_ISLNK(st.st_mode)) {
+        isFile = fstatat(dirFd, name, &st, 0) == 0 && S_ISREG(st.st_mode);
+    } else {
+        isFile = S_ISREG(st.st_mode);
+    }
+}
+
+void addEntry(DirectoryWalker::Listing& out, const char* name, unsigned char type, int dirFd)
+{
+    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) return;
+
+    bool isDir = type == DT_DIR;
+    bool isFile = type == DT_REG;
+    if (type != DT_DIR && type != DT_REG) classifySlow(dirFd, name, isDir, isFile);
+
+    if (isDir) {
+        std::string n = name;
+        if (!DirectoryWalker::skipDirectory(asciiLower(n))) out.subdirs.push_back(std::move(n));
+    } else if (isFile) {
+        out.files.emplace_back(name);
+    }
+}
+#endif
+
+} // namespace
+
+bool DirectoryWalker::skipDirectory(const std::string& nameLower)
+{
+    return nameLower.empty() || nameLower[0] == '.' || nameLower == "__pycache__" ||
+           nameLower == "node_modules";
+}
+
+int64_t DirectoryWalker::mtime(const std::string& path)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(utf8ToWide(path).c_str(), GetFileExInfoStandard, &data)) return kNoMtime;
+    if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) return kNoMtime;
+    return (int64_t)(((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime);
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return kNoMtime;
+    return statMtime(st);
+#endif
+}
+
+bool DirectoryWalker::list(const std::string& path, Listing& out)
+{
+#ifdef _WIN32
+    out.mtime = mtime(path);
+    if (out.mtime == kNoMtime) return false;
+
+    std::wstring pattern = utf8ToWide(path);
+    if (!pattern.empty() && pattern.back() != L'/' && pattern.back() != L'\\') pattern += L'\\';
+    pattern += L'*';
+
+    WIN32_FIND_DATAW fd;
+    HANDLE hFind = FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &fd, FindExSearchNameMatch,
+                                    nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind == INVALID_HANDLE_VALUE) return false;
+    do {
+        std::wstring nameW(fd.cFileName);
+        if (nameW == L"." || nameW == L"..") continue;
+        std::string name = wideToUtf8(nameW);
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+            if (skipDirectory(asciiLower(name))) continue;
+            out.subdirs.push_back(std::move(name));
+        } else {
+            out.files.push_back(std::move(name));
+        }
+    } while (FindNextFileW(hFind, &fd));
+    FindClose(hFind);
+    return true;
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    out.mtime = statMtime(st);
+
+#ifdef __linux__
+    // struct linux_dirent64: u64 ino, s64 off, u16 reclen, u8 type, name.
+    alignas(8) char buf[64 * 1024];
+    for (;;) {
+        long n = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        for (long pos = 0; pos < n;) {
+            unsigned short reclen;
+            std::memcpy(&reclen, buf + pos + 16, sizeof(reclen));
+            addEntry(out, buf + pos + 19, (unsigned char)buf[pos + 18], fd);
+            pos += reclen;
+        }
+    }
+    close(fd);
+#else
+    DIR* dir = fdopendir(fd);
+    if (!dir) {
+        close(fd);
+        return false;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        addEntry(out, entry->d_name, entry->d_type, fd);
+    }
+    closedir(dir);  // closes fd
+#endif
+    return true;
+#endif
+}
+
+DirectoryWalker::DirectoryWalker(unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::max(8u, std::min(64u, 2 * std::thread::hardware_concurrency()));
+    }
+    threads_ = threads;
+    for (unsigned i = 0; i < threads_; ++i) workers_.push_back(std::make_unique<Worker>());
+}
+
+DirectoryWalker::~DirectoryWalker() = default;
+
+void DirectoryWalker::push(uint32_t id)
+{
+    unsigned w = (tlsWalker == this) ? tlsWorker : 0;
+    pending_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(workers_[w]->mutex);
+        workers_[w]->queue.push_back(id);
+    }
+    idle_.notify_one();
+}
+
+bool DirectoryWalker::take(unsigned index, uint32_t& id)
+{
+    {
+        Worker& own = *workers_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.queue.empty()) {
+            id = own.queue.back();
+            own.queue.pop_back();
+            return true;
+        }
+    }
+    for (unsigned k = 1; k < threads_; ++k) {
+        Worker& victim = *workers_[(index + k) % threads_];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.queue.empty()) {
+            id = victim.queue.front();
+            victim.queue.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirectoryWalker::workerLoop(unsigned index)
+{
+    tlsWalker = this;
+    tlsWorker = index;
+    while (!stop_.load()) {
+        uint32_t id;
+        if (take(index, id)) {
+            (*task_)(id);
+            if (pending_.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(idleMutex_);
+                idle_.notify_all();
+            }
+            continue;
+        }
+        if (pending_.load() == 0) break;
+        // Nothing to steal yet: another worker is still listing.
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        idle_.wait_for(lock, std::chrono::milliseconds(1));
+    }
+    tlsWalker = nullptr;
+}
+
+bool DirectoryWalker::run(const std::vector<uint32_t>& roots,
+                          const std::function<void(uint32_t)>& task,
+                          const std::function<bool()>& tick,
+                          const std::atomic<bool>* cancel)
+{
+    task_ = &task;
+    stop_ = false;
+    pending_ = roots.size();
+    for (size_t i = 0; i < roots.size(); ++i) {
+        workers_[i % threads_]->queue.push_back(roots[i]);
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads_);
+    for (unsigned i = 0; i < threads_; ++i) pool.emplace_back(&DirectoryWalker::workerLoop, this, i);
+
+    bool stopped = false;
+    while (pending_.load() > 0) {
+        {
+            std::unique_lock<std::mutex> lock(idleMutex_);
+            idle_.wait_for(lock, std::chrono::milliseconds(50), [this]() { return pending_.load() == 0; });
+        }
+        if ((cancel && cancel->load()) || (tick && !tick())) {
+            stopped = true;
+            stop_ = true;
+            idle_.notify_all();
+            break;
+        }
+    }
+    for (auto& t : pool) t.join();
+
+    for (auto& w : workers_) w->queue.clear();
+    task_ = nullptr;
+    return !stopped;
+}
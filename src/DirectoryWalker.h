@@ -0,0 +1,89 @@
+#pragma once
+#ifndef DIRECTORYWALKER_H
+#define DIRECTORYWALKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Work-stealing thread pool for directory trees, plus the portable
+// single-directory listing it is used with.
+//
+// Work items are caller-defined ids (typically an index into the caller's
+// directory table). Each worker owns a deque: the task function pushes the
+// subdirectories it finds onto its own deque and keeps popping from the back
+// (depth-first, good locality); an idle worker steals from the front of
+// another worker's deque (the oldest, usually largest subtrees). On network
+// storage every listing is a round trip, so many directories are in flight
+// at once instead of one.
+class DirectoryWalker {
+public:
+    // One directory level. Subdirectories that are hidden, in the skip list
+    // or reparse points / symlinks are left out; links to files are files.
+    struct Listing {
+        std::vector<std::string> files;
+        std::vector<std::string> subdirs;
+        int64_t mtime = 0;  // of the directory itself, taken when it was opened
+    };
+
+    // Linux: open + getdents64, using d_type so entries are never stat'ed
+    // (except symlinks and file systems without d_type). Windows:
+    // FindFirstFileExW with large fetch. Elsewhere: opendir/readdir.
+    static bool list(const std::string& path, Listing& out);
+
+    // Directory mtime, or kNoMtime if it is missing or not a directory.
+    static int64_t mtime(const std::string& path);
+    static constexpr int64_t kNoMtime = INT64_MIN;
+
+    // Hidden directories, __pycache__, node_modules (.git and .svn are
+    // hidden). nameLower is the case-folded directory name.
+    static bool skipDirectory(const std::string& nameLower);
+
+    // threads == 0: twice the core count, at least 8 and at most 64 (the
+    // workers mostly wait on I/O).
+    explicit DirectoryWalker(unsigned threads = 0);
+    ~DirectoryWalker();
+
+    DirectoryWalker(const DirectoryWalker&) = delete;
+    DirectoryWalker& operator=(const DirectoryWalker&) = delete;
+
+    // Run task(id) for every root and every id pushed from inside a task,
+    // until none are left. While waiting, tick() is called on the calling
+    // thread about every 50 ms; returning false (or setting *cancel) stops
+    // the walk after the tasks in progress. Returns false if stopped.
+    bool run(const std::vector<uint32_t>& roots,
+             const std::function<void(uint32_t id)>& task,
+             const std::function<bool()>& tick = nullptr,
+             const std::atomic<bool>* cancel = nullptr);
+
+    // Schedule more work; only valid inside a task.
+    void push(uint32_t id);
+
+    unsigned threads() const { return threads_; }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<uint32_t> queue;
+    };
+
+    void workerLoop(unsigned index);
+    bool take(unsigned index, uint32_t& id);
+
+    unsigned threads_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    const std::function<void(uint32_t)>* task_ = nullptr;
+    std::atomic<size_t> pending_{0};  // pushed and not yet finished
+    std::atomic<bool> stop_{false};
+
+    std::mutex idleMutex_;
+    std::condition_variable idle_;
+};
+
+#endif // DIRECTORYWALKER_H
@@ -1,12 +1,20 @@
 #include "FileAnalyzer.h"
-
+#include "AnalysisCache.h"
+#include "MappedFile.h"
+#include "MaStatementScanner.h"
+#include "MbIffReader.h"
+#include "MetadataExecutor.h"
+#include "PrintableRuns.h"
+
+#include <filesystem>
 #include <fstream>
 #include <sstream>
-#include <regex>
 #include <algorithm>
 #include <iomanip>
 #include <sys/stat.h>
 #include <cstring>
+#include <cctype>
+#include <functional>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -26,6 +34,29 @@ static std::wstring utf8ToWide(const std::string& utf8) {
 }
 #endif
 
+// Maya binary chunks that carry path strings:
+//   FREF - file reference (referenced path plus namespace/options strings)
+//   "STR " - string attribute value (fileTextureName, abc_File, ...)
+static const uint32_t kFileReferenceChunk = MbIff::makeTag('F', 'R', 'E', 'F');
+static const uint32_t kStringAttrChunk = MbIff::makeTag('S', 'T', 'R', ' ');
+
+// Call fn for every run of text in a chunk payload. Strings are separated by
+// NUL (or other control) bytes; bytes >= 0x80 are kept so UTF-8 paths survive.
+static void forEachChunkString(const char* data, uint64_t size,
+                               const std::function<void(const std::string&)>& fn) {
+    std::string current;
+    for (uint64_t i = 0; i < size; ++i) {
+        unsigned char byte = (unsigned char)data[i];
+        if (byte >= 32 && byte != 127) {
+            current += (char)byte;
+        } else if (!current.empty()) {
+            fn(current);
+            current.clear();
+        }
+    }
+    if (!current.empty()) fn(current);
+}
+
 // Static member initialization
 const std::set<std::string> FileAnalyzer::REFERENCE_EXTS = {".ma", ".mb", ".fbx", ".abc"};
 const std::set<std::string> FileAnalyzer::TEXTURE_EXTS = {
@@ -85,6 +116,17 @@ static std::string normalizePath(const std::string& path) {
     return p;
 }
 
+// Helper: strip a trailing Maya reference copy number, e.g. "rig.ma{2}" -> "rig.ma"
+static std::string stripCopyNumber(const std::string& path) {
+    if (path.size() < 3 || path.back() != '}') return path;
+    size_t open = path.rfind('{');
+    if (open == std::string::npos || open + 2 > path.size() - 1) return path;
+    for (size_t i = open + 1; i + 1 < path.size(); ++i) {
+        if (!std::isdigit((unsigned char)path[i])) return path;
+    }
+    return path.substr(0, open);
+}
+
 // Helper: check if path is absolute
 static bool isAbsolutePath(const std::string& path) {
     if (path.empty()) return false;
@@ -117,6 +159,7 @@ bool FileAnalyzer::analyze() {
     caches.clear();
     errors.clear();
     warnings.clear();
+    requiredPlugins.clear();
     seenReferences_.clear();
     seenTextures_.clear();
     seenCaches_.clear();
@@ -127,145 +170,235 @@ bool FileAnalyzer::analyze() {
     }
 
     std::string ext = getLowerExt(filePath_);
-    if (ext == ".ma") {
-        return analyzeMa();
-    }
-    if (ext == ".mb") {
-        return analyzeMb();
+    if (ext != ".ma" && ext != ".mb") {
+        errors.push_back("Unsupported file extension: " + ext);
+        return false;
     }
 
-    errors.push_back("Unsupported file extension: " + ext);
-    return false;
+    // Unchanged scene: skip the parse, refresh existence/size only. The cache
+    // holds full analyses, which also answer the header-only modes.
+    FileIdentity identity;
+    bool cacheable = cache_ && cache_->identify(filePath_, identity);
+    CachedAnalysis cached;
+    if (cacheable && cache_->lookup(identity, cached)) {
+        for (const auto& p : cached.references) references.push_back(makeDep(p, "reference"));
+        if (mode_ == AnalysisMode::Full) {
+            for (const auto& p : cached.textures) textures.push_back(makeDep(p, "texture"));
+            for (const auto& p : cached.caches) caches.push_back(makeDep(p, "cache"));
+        }
+        if (mode_ != AnalysisMode::ReferencesOnly) {
+            for (size_t i = 0; i + 1 < cached.requiredPlugins.size(); i += 2) {
+                requiredPlugins.push_back({cached.requiredPlugins[i], cached.requiredPlugins[i + 1]});
+            }
+        }
+        warnings = std::move(cached.warnings);
+        checkDeps();
+        return true;
+    }
+
+    bool ok = (ext == ".ma") ? analyzeMa() : analyzeMb();
+    if (ok && cacheable && mode_ == AnalysisMode::Full) {
+        for (const auto& r : references) cached.references.push_back(r.path);
+        for (const auto& t : textures) cached.textures.push_back(t.path);
+        for (const auto& c : caches) cached.caches.push_back(c.path);
+        for (const auto& r : requiredPlugins) {
+            cached.requiredPlugins.push_back(r.plugin);
+            cached.requiredPlugins.push_back(r.version);
+        }
+        cached.warnings = warnings;
+        cache_->store(identity, cached);
+    }
+    if (ok) checkDeps();
+    return ok;
 }
 
 bool FileAnalyzer::analyzeMa() {
-#ifdef _WIN32
-    std::ifstream ifs(utf8ToWide(filePath_), std::ios::in | std::ios::binary);
-#else
-    std::ifstream ifs(filePath_, std::ios::in | std::ios::binary);
-#endif
-    if (!ifs.is_open()) {
-        errors.push_back("Failed to read file: " + filePath_);
-        return false;
-    }
-
-    std::string content((std::istreambuf_iterator<char>(ifs)),
-                         std::istreambuf_iterator<char>());
-    ifs.close();
+    MaStatementScanner scanner;
 
-    // Reference pattern: file ... "path.ma|mb|fbx|abc" ;
-    // NOTE: .ma files are multi-line; do not anchor to beginning-of-input.
-    std::regex refPattern(
-        // Use a custom raw-string delimiter because the pattern itself can contain `)"`.
-        R"PT(file\s+[^;]*?"([^"\r\n]+\.(?:ma|mb|fbx|abc))"\s*;)PT",
-        std::regex::icase
-    );
-
-    auto refBegin = std::sregex_iterator(content.begin(), content.end(), refPattern);
-    auto refEnd = std::sregex_iterator();
-    for (auto it = refBegin; it != refEnd; ++it) {
-        addReference((*it)[1].str());
+    // Reference statement: file ... "path.ma|mb|fbx|abc";
+    scanner.onFileStatement = [this](const std::string& path) {
+        if (REFERENCE_EXTS.count(getLowerExt(stripCopyNumber(path)))) {
+            addReference(path);
+        }
+    };
+
+    // Plugin requirement: requires [-nodeType "t"]... "plugin" "version";
+    if (mode_ != AnalysisMode::ReferencesOnly) {
+        scanner.onRequires = [this](const std::vector<std::string>& args) {
+            std::vector<const std::string*> positional;
+            for (size_t i = 0; i < args.size(); ++i) {
+                const std::string& a = args[i];
+                if (a == "-nodeType" || a == "-nt" || a == "-dataType" || a == "-dt") {
+                    ++i;  // flag value
+                } else if (!a.empty() && a[0] != '-') {
+                    positional.push_back(&a);
+                }
+            }
+            if (positional.empty()) return;
+            RequiredPlugin req;
+            req.plugin = *positional[0];
+            if (positional.size() > 1) req.version = *positional[1];
+            requiredPlugins.push_back(std::move(req));
+        };
     }
 
-    // String attribute pattern: setAttr "..." -type "string" "path"
-    std::regex attrPattern(
-        "setAttr\\s+\"[^\"]+\"\\s+-type\\s+\"string\"\\s+\"([^\"\\r\\n]+)\"",
-        std::regex::icase
-    );
+    // Header modes: read in small pieces and stop at the first createNode,
+    // so only the header is ever read from disk. A mapping would let the
+    // kernel read ahead far past it.
+    if (mode_ != AnalysisMode::Full) {
+        scanner.stopAtFirstNode = true;
+        return analyzeMaStream(scanner, std::min<size_t>(memoryLimit_, 16 * 1024));
+    }
 
-    auto attrBegin = std::sregex_iterator(content.begin(), content.end(), attrPattern);
-    auto attrEnd = std::sregex_iterator();
-    for (auto it = attrBegin; it != attrEnd; ++it) {
-        std::string rawPath = (*it)[1].str();
+    // String attribute: setAttr "..." -type "string" "path"
+    scanner.onStringAttr = [this](const std::string& rawPath) {
         std::string ext = getLowerExt(rawPath);
         if (TEXTURE_EXTS.count(ext)) {
             addTexture(rawPath);
         } else if (CACHE_EXTS.count(ext)) {
             addCache(rawPath);
         }
+    };
+
+    // Tokenize the file in a single pass. Only `file`, `requires` and
+    // `setAttr ... -type "string"` statements keep their tokens; all other
+    // statements are skipped without copying. Scenes larger than the memory
+    // limit are streamed instead of mapped, so multi-GB crowd scenes never
+    // have more than one window resident.
+    int64_t size = getFileSize(filePath_);
+    if (size < 0) {
+        errors.push_back("Failed to read file: " + filePath_);
+        return false;
+    }
+    if ((uint64_t)size > memoryLimit_) {
+        return analyzeMaStream(scanner, memoryLimit_);
+    }
+
+    MappedFile file;
+    if (!file.open(filePath_)) {
+        errors.push_back("Failed to read file: " + filePath_);
+        return false;
     }
 
+    scanner.feed(file.data(), file.size());
+    scanner.finish();
     return true;
 }
 
-bool FileAnalyzer::analyzeMb() {
-#ifdef _WIN32
-    std::ifstream ifs(utf8ToWide(filePath_), std::ios::in | std::ios::binary);
-#else
-    std::ifstream ifs(filePath_, std::ios::in | std::ios::binary);
-#endif
-    if (!ifs.is_open()) {
+// Feed the file to the scanner through a buffer of `window` bytes. The
+// scanner keeps any statement split across two reads (bounded by its token
+// limit), so the result does not depend on the window size.
+bool FileAnalyzer::analyzeMaStream(MaStatementScanner& scanner, size_t window) {
+    std::ifstream in(std::filesystem::u8path(filePath_), std::ios::binary);
+    if (!in) {
         errors.push_back("Failed to read file: " + filePath_);
         return false;
     }
 
-    std::vector<char> data((std::istreambuf_iterator<char>(ifs)),
-                            std::istreambuf_iterator<char>());
-    ifs.close();
-
-    std::vector<std::string> strings = extractAsciiStrings(data, 6);
-    std::vector<std::string> utf16Strings = extractUtf16LeStrings(data, 6);
-    strings.insert(strings.end(), utf16Strings.begin(), utf16Strings.end());
-
-    for (const auto& value : strings) {
-        if (!looksLikePath(value)) continue;
-
-        std::string ext = getLowerExt(value);
-        if (ext == ".ma" || ext == ".mb") {
-            addReference(value);
-        } else if (CACHE_EXTS.count(ext)) {
-            addCache(value);
-        } else if (TEXTURE_EXTS.count(ext)) {
-            addTexture(value);
-        }
+    std::vector<char> buf(window);
+    while (!scanner.stopped() && in) {
+        in.read(buf.data(), (std::streamsize)buf.size());
+        std::streamsize got = in.gcount();
+        if (got <= 0) break;
+        scanner.feed(buf.data(), (size_t)got);
     }
-
+    if (in.bad()) {
+        errors.push_back("Failed to read file: " + filePath_);
+        return false;
+    }
+    scanner.finish();
     return true;
 }
 
-std::vector<std::string> FileAnalyzer::extractAsciiStrings(const std::vector<char>& data, int minLength) {
-    std::vector<std::string> strings;
-    std::string current;
+bool FileAnalyzer::analyzeMb() {
+    MappedFile file;
+    if (!file.open(filePath_)) {
+        errors.push_back("Failed to read file: " + filePath_);
+        return false;
+    }
 
-    for (size_t i = 0; i < data.size(); ++i) {
-        unsigned char byte = (unsigned char)data[i];
-        if (byte >= 32 && byte <= 126) {
-            current += (char)byte;
-        } else {
-            if ((int)current.size() >= minLength) {
-                strings.push_back(current);
+    // Walk the IFF chunk tree and read only the chunks that carry paths.
+    // Geometry, animation and other payload chunks are skipped by their
+    // length headers, so their pages are never touched.
+    if (MbIff::isIff(file.data(), file.size())) {
+        std::string walkError;
+        int pathChunks = 0;
+        bool walked = MbIff::walkChunks(file.data(), file.size(),
+            [&](const IffChunk& chunk) {
+                bool isReferenceChunk = (chunk.tag == kFileReferenceChunk);
+                if (!isReferenceChunk && chunk.tag != kStringAttrChunk) return;
+                ++pathChunks;
+                forEachChunkString(chunk.data, chunk.size, [&](const std::string& value) {
+                    addMbPath(value, isReferenceChunk);
+                });
+            },
+            walkError);
+
+        if (walked && pathChunks > 0) return true;
+
+        warnings.push_back(walked
+            ? "No file reference or string chunks found; falling back to a full string scan"
+            : "Malformed IFF structure (" + walkError + "); falling back to a full string scan");
+    } else {
+        warnings.push_back("Missing FOR4/FOR8 header; falling back to a full string scan");
+    }
+
+    // One vectorized pass finds ASCII and UTF-16LE runs; only runs with a
+    // known path extension are copied. UTF-16 candidates are applied after
+    // the ASCII ones so dependency order matches the old two-pass scan.
+    std::vector<std::string> utf16Candidates;
+    PrintableRuns::scan(file.data(), file.size(), 6,
+        [&](std::string_view run, PrintableRuns::Encoding encoding) {
+            if (!hasPathExtension(run)) return;
+            if (encoding == PrintableRuns::Encoding::Ascii) {
+                addMbPath(std::string(run), false);
+            } else {
+                utf16Candidates.emplace_back(run);
             }
-            current.clear();
-        }
-    }
-    if ((int)current.size() >= minLength) {
-        strings.push_back(current);
+        });
+    for (const auto& value : utf16Candidates) {
+        addMbPath(value, false);
     }
 
-    return strings;
+    return true;
 }
 
-std::vector<std::string> FileAnalyzer::extractUtf16LeStrings(const std::vector<char>& data, int minLength) {
-    std::vector<std::string> strings;
-    std::string chars;
-
-    for (size_t i = 0; i + 1 < data.size(); i += 2) {
-        unsigned char lo = (unsigned char)data[i];
-        unsigned char hi = (unsigned char)data[i + 1];
-        if (hi == 0 && lo >= 32 && lo <= 126) {
-            chars += (char)lo;
-        } else {
-            if ((int)chars.size() >= minLength) {
-                strings.push_back(chars);
+// Cheap pre-filter for the fallback scan: the extension test addMbPath()
+// would apply (after dropping a copy number and trailing quotes), done on
+// the view so the vast majority of binary noise is never copied.
+bool FileAnalyzer::hasPathExtension(std::string_view run) {
+    if (!run.empty() && run.back() == '}') {
+        size_t open = run.rfind('{');
+        if (open != std::string_view::npos && open + 2 <= run.size() - 1) {
+            bool digits = true;
+            for (size_t i = open + 1; i + 1 < run.size(); ++i) {
+                if (!std::isdigit((unsigned char)run[i])) digits = false;
             }
-            chars.clear();
+            if (digits) run = run.substr(0, open);
         }
     }
-    if ((int)chars.size() >= minLength) {
-        strings.push_back(chars);
-    }
+    while (!run.empty() && (run.back() == '"' || run.back() == '\'' || run.back() == ' ')) run.remove_suffix(1);
 
-    return strings;
+    size_t dot = run.rfind('.');
+    if (dot == std::string_view::npos || run.size() - dot > 6) return false;
+    std::string ext(run.substr(dot));
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return (char)std::tolower(c); });
+    return PATH_EXTS.count(ext) > 0;
+}
+
+void FileAnalyzer::addMbPath(const std::string& value, bool fromReferenceChunk) {
+    std::string path = stripCopyNumber(value);
+    if (!looksLikePath(path)) return;
+
+    std::string ext = getLowerExt(path);
+    if (fromReferenceChunk ? REFERENCE_EXTS.count(ext) > 0 : (ext == ".ma" || ext == ".mb")) {
+        addReference(value);
+    } else if (CACHE_EXTS.count(ext)) {
+        addCache(value);
+    } else if (TEXTURE_EXTS.count(ext)) {
+        addTexture(value);
+    }
 }
 
 bool FileAnalyzer::looksLikePath(const std::string& value) const {
@@ -293,41 +426,65 @@ void FileAnalyzer::addReference(const std::string& path) {
     if (seenReferences_.count(normalized)) return;
     seenReferences_.insert(normalized);
 
-    AnalyzedDep dep;
-    dep.path = normalized;
-    dep.exists = fileExists(normalized);
-    dep.size = dep.exists ? getFileSize(normalized) : 0;
-    dep.sizeStr = formatSize(dep.size);
-    dep.type = "reference";
-    references.push_back(dep);
+    references.push_back(makeDep(normalized, "reference"));
 }
 
 void FileAnalyzer::addTexture(const std::string& path) {
+    if (mode_ != AnalysisMode::Full) return;
     std::string normalized = normalizePath(path);
     if (seenTextures_.count(normalized)) return;
     seenTextures_.insert(normalized);
 
-    AnalyzedDep dep;
-    dep.path = normalized;
-    dep.exists = fileExists(normalized);
-    dep.size = dep.exists ? getFileSize(normalized) : 0;
-    dep.sizeStr = formatSize(dep.size);
-    dep.type = "texture";
-    textures.push_back(dep);
+    textures.push_back(makeDep(normalized, "texture"));
 }
 
 void FileAnalyzer::addCache(const std::string& path) {
+    if (mode_ != AnalysisMode::Full) return;
     std::string normalized = normalizePath(path);
     if (seenCaches_.count(normalized)) return;
     seenCaches_.insert(normalized);
 
+    caches.push_back(makeDep(normalized, "cache"));
+}
+
+// Existence and size are filled in by checkDeps() once all paths are known.
+AnalyzedDep FileAnalyzer::makeDep(const std::string& normalized, const char* type) const {
     AnalyzedDep dep;
     dep.path = normalized;
-    dep.exists = fileExists(normalized);
-    dep.size = dep.exists ? getFileSize(normalized) : 0;
-    dep.sizeStr = formatSize(dep.size);
-    dep.type = "cache";
-    caches.push_back(dep);
+    dep.exists = false;
+    dep.unknown = false;
+    dep.size = 0;
+    dep.type = type;
+    return dep;
+}
+
+// Stat every dependency in one parallel batch on the shared executor instead
+// of one blocking stat per path; slow network shares cost one round of
+// latency and a dead server costs at most the executor deadline.
+void FileAnalyzer::checkDeps() {
+    std::vector<AnalyzedDep*> deps;
+    for (auto& r : references) deps.push_back(&r);
+    for (auto& t : textures) deps.push_back(&t);
+    for (auto& c : caches) deps.push_back(&c);
+    if (deps.empty()) return;
+
+    std::vector<std::string> paths;
+    paths.reserve(deps.size());
+    for (const auto* d : deps) paths.push_back(d->path);
+
+    std::vector<StatResult> results = MetadataExecutor::shared().statAll(paths);
+    int unknown = 0;
+    for (size_t i = 0; i < deps.size(); ++i) {
+        AnalyzedDep& d = *deps[i];
+        d.exists = results[i].state == StatResult::Exists;
+        d.unknown = results[i].state == StatResult::Unknown;
+        d.size = results[i].size;
+        d.sizeStr = formatSize(d.size);
+        if (d.unknown) ++unknown;
+    }
+    if (unknown > 0) {
+        warnings.push_back(std::to_string(unknown) + " dependencies could not be checked (storage timed out)");
+    }
 }
 
 std::string FileAnalyzer::normalizePath(const std::string& path) const {
@@ -339,8 +496,7 @@ std::string FileAnalyzer::normalizePath(const std::string& path) const {
         value.pop_back();
 
     // Remove Maya reference copy number suffix {N}
-    std::regex copyNum(R"(\{\d+\}$)");
-    value = std::regex_replace(value, copyNum, "");
+    value = stripCopyNumber(value);
 
     // Expand environment variables on Windows
 #ifdef _WIN32
@@ -392,7 +548,7 @@ int64_t FileAnalyzer::getFileSize(const std::string& path) {
         return (int64_t)st.st_size;
     }
 #endif
-    return 0;
+    return -1;
 }
 
 std::string FileAnalyzer::formatSize(int64_t size) {
@@ -429,11 +585,15 @@ AnalysisSummary FileAnalyzer::summary() const {
     s.caches = (int)caches.size();
 
     s.missingReferences = 0;
-    for (const auto& r : references) if (!r.exists) s.missingReferences++;
+    for (const auto& r : references) if (!r.exists && !r.unknown) s.missingReferences++;
     s.missingTextures = 0;
-    for (const auto& t : textures) if (!t.exists) s.missingTextures++;
+    for (const auto& t : textures) if (!t.exists && !t.unknown) s.missingTextures++;
     s.missingCaches = 0;
-    for (const auto& c : caches) if (!c.exists) s.missingCaches++;
+    for (const auto& c : caches) if (!c.exists && !c.unknown) s.missingCaches++;
+    s.unknown = 0;
+    for (const auto& r : references) if (r.unknown) s.unknown++;
+    for (const auto& t : textures) if (t.unknown) s.unknown++;
+    for (const auto& c : caches) if (c.unknown) s.unknown++;
 
     s.totalMissing = s.missingReferences + s.missingTextures + s.missingCaches;
     s.errors = errors;
@@ -441,6 +601,11 @@ AnalysisSummary FileAnalyzer::summary() const {
     return s;
 }
 
+static const char* depStatus(const AnalyzedDep& dep) {
+    if (dep.exists) return "OK";
+    return dep.unknown ? "UNKNOWN" : "MISSING";
+}
+
 std::string FileAnalyzer::getReport() const {
     std::ostringstream oss;
     std::string sep60(60, '=');
@@ -464,28 +629,37 @@ std::string FileAnalyzer::getReport() const {
         }
     }
 
+    if (!requiredPlugins.empty()) {
+        oss << "\n[Requires] " << requiredPlugins.size() << "\n";
+        for (const auto& r : requiredPlugins) {
+            oss << "  " << r.plugin;
+            if (!r.version.empty()) oss << " " << r.version;
+            oss << "\n";
+        }
+    }
+
     oss << "\n[References] " << references.size() << "\n";
     int missingRefs = 0;
-    for (const auto& r : references) if (!r.exists) missingRefs++;
+    for (const auto& r : references) if (!r.exists && !r.unknown) missingRefs++;
     if (missingRefs > 0) oss << "  Missing: " << missingRefs << "\n";
     for (const auto& r : references) {
-        oss << "  [" << (r.exists ? "OK" : "MISSING") << "] " << r.path << " (" << r.sizeStr << ")\n";
+        oss << "  [" << depStatus(r) << "] " << r.path << " (" << r.sizeStr << ")\n";
     }
 
     oss << "\n[Textures] " << textures.size() << "\n";
     int missingTex = 0;
-    for (const auto& t : textures) if (!t.exists) missingTex++;
+    for (const auto& t : textures) if (!t.exists && !t.unknown) missingTex++;
     if (missingTex > 0) oss << "  Missing: " << missingTex << "\n";
     for (const auto& t : textures) {
-        oss << "  [" << (t.exists ? "OK" : "MISSING") << "] " << t.path << " (" << t.sizeStr << ")\n";
+        oss << "  [" << depStatus(t) << "] " << t.path << " (" << t.sizeStr << ")\n";
     }
 
     oss << "\n[Caches] " << caches.size() << "\n";
     int missingCache = 0;
-    for (const auto& c : caches) if (!c.exists) missingCache++;
+    for (const auto& c : caches) if (!c.exists && !c.unknown) missingCache++;
     if (missingCache > 0) oss << "  Missing: " << missingCache << "\n";
     for (const auto& c : caches) {
-        oss << "  [" << (c.exists ? "OK" : "MISSING") << "] " << c.path << " (" << c.sizeStr << ")\n";
+        oss << "  [" << depStatus(c) << "] " << c.path << " (" << c.sizeStr << ")\n";
     }
 
     oss << "\n" << sep60 << "\n";
@@ -513,21 +687,21 @@ std::string FileAnalyzer::getReport() const {
 std::vector<AnalyzedDep> FileAnalyzer::getMissingFiles() const {
     std::vector<AnalyzedDep> missing;
     for (const auto& r : references) {
-        if (!r.exists) {
+        if (!r.exists && !r.unknown) {
             AnalyzedDep d = r;
             d.type = "reference";
             missing.push_back(d);
         }
     }
     for (const auto& t : textures) {
-        if (!t.exists) {
+        if (!t.exists && !t.unknown) {
             AnalyzedDep d = t;
             d.type = "texture";
             missing.push_back(d);
         }
     }
     for (const auto& c : caches) {
-        if (!c.exists) {
+        if (!c.exists && !c.unknown) {
             AnalyzedDep d = c;
             d.type = "cache";
             missing.push_back(d);
@@ -2,18 +2,40 @@
 #ifndef FILEANALYZER_H
 #define FILEANALYZER_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <set>
 
+class AnalysisCache;
+class MaStatementScanner;
+
 struct AnalyzedDep {
     std::string path;
     bool exists;
+    bool unknown;     // existence could not be checked before the deadline
     int64_t size;
     std::string sizeStr;
     std::string type; // "reference", "texture", "cache"
 };
 
+// Plugin named by a .ma `requires` statement ("maya" for the Maya version).
+struct RequiredPlugin {
+    std::string plugin;
+    std::string version;
+};
+
+// What analyze() extracts. The header modes read a .ma file only up to its
+// first createNode (all `file` and `requires` statements come before it),
+// so triage and reference walks cost a few KB of I/O per scene instead of
+// the full file. For .mb files they skip texture and cache paths.
+enum class AnalysisMode {
+    Full,                   // references, requires, textures, caches
+    ReferencesOnly,         // references
+    ReferencesAndRequires   // references and requires
+};
+
 struct AnalysisSummary {
     std::string file;
     int references;
@@ -23,6 +45,7 @@ struct AnalysisSummary {
     int missingTextures;
     int missingCaches;
     int totalMissing;
+    int unknown;      // dependencies whose stat timed out (not counted missing)
     std::vector<std::string> errors;
     std::vector<std::string> warnings;
 };
@@ -33,6 +56,22 @@ public:
 
     bool analyze();
 
+    void setMode(AnalysisMode mode) { mode_ = mode; }
+    AnalysisMode mode() const { return mode_; }
+
+    // Upper bound on the bytes of a .ma file held in memory at once. Files
+    // up to this size are mapped whole; larger ones are streamed through a
+    // buffer of this size, with statements split across reads carried over
+    // by the scanner, so the result is the same as a whole-file parse.
+    static const size_t kDefaultMemoryLimit = 256 * 1024 * 1024;
+    void setMemoryLimit(size_t bytes) { memoryLimit_ = bytes ? bytes : 1; }
+    size_t memoryLimit() const { return memoryLimit_; }
+
+    // Optional parse cache (not owned). When set, analyze() of an unchanged
+    // scene replays the cached dependency paths and only re-checks their
+    // existence and size.
+    void setCache(AnalysisCache* cache) { cache_ = cache; }
+
     AnalysisSummary summary() const;
     std::string getReport() const;
     std::vector<AnalyzedDep> getMissingFiles() const;
@@ -41,28 +80,34 @@ public:
     std::vector<AnalyzedDep> references;
     std::vector<AnalyzedDep> textures;
     std::vector<AnalyzedDep> caches;
+    std::vector<RequiredPlugin> requiredPlugins;  // .ma only, not in ReferencesOnly mode
     std::vector<std::string> errors;
     std::vector<std::string> warnings;
 
 private:
     bool analyzeMa();
+    bool analyzeMaStream(MaStatementScanner& scanner, size_t window);
     bool analyzeMb();
 
-    std::vector<std::string> extractAsciiStrings(const std::vector<char>& data, int minLength = 6);
-    std::vector<std::string> extractUtf16LeStrings(const std::vector<char>& data, int minLength = 6);
+    static bool hasPathExtension(std::string_view run);
     bool looksLikePath(const std::string& value) const;
+    void addMbPath(const std::string& value, bool fromReferenceChunk);
 
     void addReference(const std::string& path);
     void addTexture(const std::string& path);
     void addCache(const std::string& path);
+    AnalyzedDep makeDep(const std::string& normalized, const char* type) const;
+    void checkDeps();
 
     std::string normalizePath(const std::string& path) const;
-    static int64_t getFileSize(const std::string& path);
+    static int64_t getFileSize(const std::string& path);  // -1 if the file cannot be stat'ed
     static std::string formatSize(int64_t size);
-    static bool fileExists(const std::string& path);
 
     std::string filePath_;
     std::string fileDir_;
+    AnalysisCache* cache_ = nullptr;
+    AnalysisMode mode_ = AnalysisMode::Full;
+    size_t memoryLimit_ = kDefaultMemoryLimit;
 
     std::set<std::string> seenReferences_;
     std::set<std::string> seenTextures_;
@@ -74,6 +119,9 @@ public:
     static const std::set<std::string> CACHE_EXTS;
     static const std::set<std::string> PATH_EXTS;
 
+    // True if path names an existing regular file (UTF-8 path).
+    static bool fileExists(const std::string& path);
+
 private:
 };
 
@@ -0,0 +1,74 @@
+#include "FileFingerprint.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace FileFingerprint {
+
+uint64_t sampled(const std::string& path, uint64_t size)
+{
+    std::ifstream in(fs::u8path(path), std::ios::binary);
+    if (!in) return 0;
+
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const char* data, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            h ^= (unsigned char)data[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(reinterpret_cast<const char*>(&size), sizeof(size));
+
+    // Small files are hashed whole; larger ones at three offsets.
+    std::vector<char> buf(kBlock);
+    auto block = [&](uint64_t offset, size_t n) {
+        in.clear();
+        in.seekg((std::streamoff)offset);
+        in.read(buf.data(), (std::streamsize)n);
+        mix(buf.data(), (size_t)in.gcount());
+    };
+    if (size <= 3 * kBlock) {
+        for (uint64_t offset = 0; offset < size; offset += kBlock) {
+            block(offset, (size_t)std::min<uint64_t>(kBlock, size - offset));
+        }
+    } else {
+        block(0, kBlock);
+        block((size - kBlock) / 2, kBlock);
+        block(size - kBlock, kBlock);
+    }
+    return h ? h : 1;
+}
+
+std::vector<uint64_t> sampledAll(const std::vector<std::string>& paths,
+                                 const std::vector<uint64_t>& sizes,
+                                 unsigned threads)
+{
+    std::vector<uint64_t> results(paths.size(), 0);
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (;;) {
+            size_t i = next.fetch_add(1);
+            if (i >= paths.size()) break;
+            results[i] = sampled(paths[i], sizes[i]);
+        }
+    };
+
+    if (threads == 0) threads = 8;
+    unsigned n = (unsigned)std::min<size_t>(threads, paths.size());
+    if (n <= 1) {
+        worker();
+        return results;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(n);
+    for (unsigned t = 0; t < n; ++t) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+    return results;
+}
+
+} // namespace FileFingerprint
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef FILEFINGERPRINT_H
+#define FILEFINGERPRINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cheap content fingerprint: FNV-1a over the file size and three sampled
+// blocks (head, middle, tail). Reads at most 3 x kBlock bytes however large
+// the file is, which tells apart same-name files of equal size in practice
+// (a copy and an edited version rarely agree in all three places).
+namespace FileFingerprint {
+
+const size_t kBlock = 64 * 1024;
+
+// Fingerprint of a file whose size is already known; 0 if it cannot be
+// read. Never 0 otherwise.
+uint64_t sampled(const std::string& path, uint64_t size);
+
+// sampled() for many files on a small thread pool (the work is I/O, so
+// threads == 0 means 8, not one per core). Results are in input order.
+std::vector<uint64_t> sampledAll(const std::vector<std::string>& paths,
+                                 const std::vector<uint64_t>& sizes,
+                                 unsigned threads = 0);
+
+} // namespace FileFingerprint
+
+#endif // FILEFINGERPRINT_H
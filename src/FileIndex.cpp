@@ -0,0 +1,1017 @@
+#include "FileIndex.h"
+#include "DirectoryWalker.h"
+#include "GlobPattern.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// File layout (native byte order; x86-64 and ARM64 are both little-endian):
+//   Header
+//   DirRecord  x dirCount    sorted by relative path, so parents come first
+//   FileRecord x fileCount   single files, sorted by key, then directory, then name
+//   uint32     x fileCount   file ids sorted by reversed key (suffix order)
+//   SeqRecord  x seqCount    sequences, sorted by key, directory, name, width
+//   Run        x runCount    frame ranges of the sequences, ascending per sequence
+//   string pool              NUL-terminated UTF-8
+//
+// Bump kVersion when the layout or the key folding changes.
+struct FileIndex::DirRecord {
+    uint32_t pathOff;  // relative to the root, '/'-separated, "" for the root
+    uint32_t parent;   // kNoParent for the root
+    int64_t mtime;
+};
+
+struct FileIndex::FileRecord {
+    uint32_t keyOff;
+    uint32_t nameOff;
+    uint32_t dir;
+};
+
+// Key and name are "head#tail"; member names are head, the frame number
+// zero-padded to `width` digits, then tail.
+struct FileIndex::SeqRecord {
+    uint32_t keyOff;       // case-folded
+    uint32_t nameOff;      // original case
+    uint32_t dir;
+    uint32_t headLen;      // bytes before '#' in the key
+    uint32_t nameHeadLen;  // bytes before '#' in the name
+    uint32_t width;
+    uint32_t firstRun;
+    uint32_t runCount;
+};
+
+struct FileIndex::Run {
+    uint32_t first;  // inclusive
+    uint32_t last;
+};
+
+namespace {
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t dirCount;
+    uint32_t fileCount;
+    uint32_t seqCount;
+    uint32_t runCount;
+    uint32_t rootOff;
+    uint64_t stringBytes;
+};
+
+const char kMagic[8] = {'M', 'D', 'F', 'I', 'D', 'X', '\0', '\0'};
+const uint32_t kVersion = 3;
+const uint32_t kNoParent = 0xFFFFFFFFu;
+
+const size_t kMaxFrameDigits = 9;  // frame numbers fit in 32 bits
+
+// The last run of ASCII digits in a name, taken as a sequence frame number.
+struct FramePart {
+    size_t pos = 0;
+    size_t len = 0;
+    uint32_t frame = 0;
+};
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool splitFrame(std::string_view name, FramePart& out)
+{
+    size_t end = name.size();
+    while (end > 0 && !isDigit(name[end - 1])) --end;
+    size_t begin = end;
+    while (begin > 0 && isDigit(name[begin - 1])) --begin;
+    if (begin == end || end - begin > kMaxFrameDigits) return false;
+    out.pos = begin;
+    out.len = end - begin;
+    out.frame = 0;
+    for (size_t i = begin; i < end; ++i) out.frame = out.frame * 10 + (uint32_t)(name[i] - '0');
+    return true;
+}
+
+uint64_t maxFrame(uint32_t width)
+{
+    uint64_t m = 1;
+    for (uint32_t i = 0; i < width; ++i) m *= 10;
+    return m - 1;
+}
+
+std::string joinPath(const std::string& dir, const std::string& name)
+{
+    if (dir.empty()) return name;
+    if (dir.back() == '/') return dir + name;
+    return dir + "/" + name;
+}
+
+std::string normalizeRoot(const std::string& root)
+{
+    std::error_code ec;
+    fs::path p = fs::absolute(fs::u8path(root), ec);
+    if (ec) p = fs::u8path(root);
+    std::string s = p.lexically_normal().generic_u8string();
+    // Keep "/" and "C:/", drop any other trailing slash.
+    while (s.size() > 1 && s.back() == '/' && !(s.size() == 3 && s[1] == ':')) s.pop_back();
+    return s;
+}
+
+// `path` relative to the normalized root ("" for the root itself); false if
+// it is not under the root.
+bool relativeTo(const std::string& rootNorm, std::string path, std::string& rel)
+{
+    for (auto& c : path) {
+        if (c == '\\') c = '/';
+    }
+    while (path.size() > 1 && path.back() == '/') path.pop_back();
+    std::string prefix = rootNorm;
+    if (prefix.empty() || prefix.back() != '/') prefix += '/';
+    if (path + '/' == prefix) {
+        rel.clear();
+        return true;
+    }
+    if (path.compare(0, prefix.size(), prefix) != 0) return false;
+    rel = path.substr(prefix.size());
+    return true;
+}
+
+#ifdef _WIN32
+std::wstring utf8ToWide(const std::string& s)
+{
+    if (s.empty()) return {};
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
+    if (len <= 0) return {};
+    std::wstring w(len, 0);
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &w[0], len);
+    return w;
+}
+
+std::string wideToUtf8(const std::wstring& w)
+{
+    if (w.empty()) return {};
+    int len = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return {};
+    std::string s(len, 0);
+    WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), &s[0], len, nullptr, nullptr);
+    return s;
+}
+
+#endif
+
+struct StringPool {
+    std::string data;
+
+    bool add(const std::string& s, uint32_t& offset)
+    {
+        if (data.size() + s.size() + 1 > 0xFFFFFFFFu) return false;
+        offset = (uint32_t)data.size();
+        data.append(s);
+        data += '\0';
+        return true;
+    }
+};
+
+// Order of `key` against the byte strings starting (fromEnd == false) or
+// ending (fromEnd == true) with `affix`, comparing from that end only: < 0
+// if key sorts before all of them, 0 if it is one of them.
+int compareAffix(std::string_view key, std::string_view affix, bool fromEnd)
+{
+    size_t n = std::min(key.size(), affix.size());
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char a = (unsigned char)(fromEnd ? key[key.size() - 1 - i] : key[i]);
+        unsigned char b = (unsigned char)(fromEnd ? affix[affix.size() - 1 - i] : affix[i]);
+        if (a != b) return a < b ? -1 : 1;
+    }
+    return key.size() < affix.size() ? -1 : 0;
+}
+
+bool reversedLess(const std::string& x, const std::string& y)
+{
+    return std::lexicographical_compare(x.rbegin(), x.rend(), y.rbegin(), y.rend(),
+                                        [](char a, char b) { return (unsigned char)a < (unsigned char)b; });
+}
+
+template <typename T>
+void append(std::string& out, const T& value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+bool FileIndex::open(const std::string& indexPath)
+{
+    owned_.clear();
+    if (!mapped_.open(indexPath)) {
+        attach(nullptr, 0);
+        return false;
+    }
+    if (!attach(mapped_.data(), mapped_.size())) {
+        mapped_.close();
+        return false;
+    }
+    return true;
+}
+
+bool FileIndex::attach(const char* data, size_t size)
+{
+    base_ = strings_ = nullptr;
+    dirCount_ = fileCount_ = seqCount_ = runCount_ = totalFiles_ = 0;
+    root_.clear();
+    if (!data || size < sizeof(Header)) return false;
+
+    Header h;
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+
+    uint64_t tables = sizeof(Header) + (uint64_t)h.dirCount * sizeof(DirRecord) +
+                      (uint64_t)h.fileCount * (sizeof(FileRecord) + sizeof(uint32_t)) +
+                      (uint64_t)h.seqCount * sizeof(SeqRecord) + (uint64_t)h.runCount * sizeof(Run);
+    if (h.stringBytes == 0 || tables + h.stringBytes != size) return false;
+    const char* strings = data + tables;
+    if (strings[h.stringBytes - 1] != '\0') return false;  // every string terminates
+
+    base_ = data;
+    strings_ = strings;
+    dirCount_ = h.dirCount;
+    fileCount_ = h.fileCount;
+    seqCount_ = h.seqCount;
+    runCount_ = h.runCount;
+    totalFiles_ = fileCount_;
+
+    // Validate once so lookups need no bounds checks.
+    bool ok = h.rootOff < h.stringBytes;
+    for (size_t i = 0; ok && i < dirCount_; ++i) {
+        DirRecord d = dirRecord(i);
+        ok = d.pathOff < h.stringBytes && (d.parent == kNoParent ? i == 0 : d.parent < i);
+    }
+    for (size_t i = 0; ok && i < fileCount_; ++i) {
+        FileRecord f = fileRecord(i);
+        ok = f.keyOff < h.stringBytes && f.nameOff < h.stringBytes && f.dir < dirCount_;
+    }
+    for (size_t j = 0; ok && j < fileCount_; ++j) {
+        ok = bySuffix(j) < fileCount_;
+    }
+    for (size_t s = 0; ok && s < seqCount_; ++s) {
+        SeqRecord q = seqRecord(s);
+        ok = (uint64_t)q.keyOff + q.headLen < h.stringBytes &&
+             (uint64_t)q.nameOff + q.nameHeadLen < h.stringBytes &&
+             !std::memchr(strings + q.keyOff, '\0', q.headLen) && strings[q.keyOff + q.headLen] == '#' &&
+             !std::memchr(strings + q.nameOff, '\0', q.nameHeadLen) && strings[q.nameOff + q.nameHeadLen] == '#' &&
+             q.dir < dirCount_ && q.width >= 1 && q.width <= kMaxFrameDigits && q.runCount > 0 &&
+             (uint64_t)q.firstRun + q.runCount <= runCount_;
+        for (uint32_t r = 0; ok && r < q.runCount; ++r) {
+            Run x = run(q.firstRun + r);
+            ok = x.first <= x.last && x.last <= maxFrame(q.width);
+            totalFiles_ += (size_t)(x.last - x.first) + 1;
+        }
+    }
+    if (!ok) {
+        base_ = strings_ = nullptr;
+        dirCount_ = fileCount_ = seqCount_ = runCount_ = totalFiles_ = 0;
+        return false;
+    }
+    root_ = str(h.rootOff);
+    return true;
+}
+
+FileIndex::DirRecord FileIndex::dirRecord(size_t i) const
+{
+    DirRecord d;
+    std::memcpy(&d, base_ + sizeof(Header) + i * sizeof(DirRecord), sizeof(d));
+    return d;
+}
+
+FileIndex::FileRecord FileIndex::fileRecord(size_t i) const
+{
+    FileRecord f;
+    std::memcpy(&f, base_ + sizeof(Header) + dirCount_ * sizeof(DirRecord) + i * sizeof(FileRecord),
+                sizeof(f));
+    return f;
+}
+
+size_t FileIndex::bySuffix(size_t j) const
+{
+    uint32_t id;
+    std::memcpy(&id, base_ + sizeof(Header) + dirCount_ * sizeof(DirRecord) + fileCount_ * sizeof(FileRecord) +
+                         j * sizeof(uint32_t),
+                sizeof(id));
+    return id;
+}
+
+FileIndex::SeqRecord FileIndex::seqRecord(size_t s) const
+{
+    SeqRecord q;
+    std::memcpy(&q, base_ + sizeof(Header) + dirCount_ * sizeof(DirRecord) +
+                        fileCount_ * (sizeof(FileRecord) + sizeof(uint32_t)) + s * sizeof(SeqRecord),
+                sizeof(q));
+    return q;
+}
+
+FileIndex::Run FileIndex::run(size_t r) const
+{
+    Run x;
+    std::memcpy(&x, base_ + sizeof(Header) + dirCount_ * sizeof(DirRecord) +
+                        fileCount_ * (sizeof(FileRecord) + sizeof(uint32_t)) + seqCount_ * sizeof(SeqRecord) +
+                        r * sizeof(Run),
+                sizeof(x));
+    return x;
+}
+
+std::string_view FileIndex::key(size_t i) const
+{
+    return str(fileRecord(i).keyOff);
+}
+
+std::string FileIndex::dirPath(size_t d) const
+{
+    return joinPath(root_, str(dirRecord(d).pathOff));
+}
+
+std::pair<size_t, size_t> FileIndex::equalRange(std::string_view k) const
+{
+    size_t lo = 0, hi = fileCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (key(mid) < k) lo = mid + 1; else hi = mid;
+    }
+    size_t first = lo;
+    hi = fileCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (key(mid) <= k) lo = mid + 1; else hi = mid;
+    }
+    return {first, lo};
+}
+
+std::pair<size_t, size_t> FileIndex::prefixRange(std::string_view prefix) const
+{
+    auto cmp = [&](size_t i) { return compareAffix(key(i), prefix, false); };
+    size_t lo = 0, hi = fileCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(mid) < 0) lo = mid + 1; else hi = mid;
+    }
+    size_t first = lo;
+    hi = fileCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(mid) <= 0) lo = mid + 1; else hi = mid;
+    }
+    return {first, lo};
+}
+
+std::pair<size_t, size_t> FileIndex::suffixRange(std::string_view suffix) const
+{
+    auto cmp = [&](size_t j) { return compareAffix(key(bySuffix(j)), suffix, true); };
+    size_t lo = 0, hi = fileCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(mid) < 0) lo = mid + 1; else hi = mid;
+    }
+    size_t first = lo;
+    hi = fileCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(mid) <= 0) lo = mid + 1; else hi = mid;
+    }
+    return {first, lo};
+}
+
+std::string_view FileIndex::seqKey(size_t s) const
+{
+    return str(seqRecord(s).keyOff);
+}
+
+std::pair<size_t, size_t> FileIndex::seqRange(std::string_view k, bool prefix) const
+{
+    auto cmp = [&](size_t s) {
+        if (prefix) return compareAffix(seqKey(s), k, false);
+        int c = seqKey(s).compare(k);
+        return c < 0 ? -1 : (c > 0 ? 1 : 0);
+    };
+    size_t lo = 0, hi = seqCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(mid) < 0) lo = mid + 1; else hi = mid;
+    }
+    size_t first = lo;
+    hi = seqCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(mid) <= 0) lo = mid + 1; else hi = mid;
+    }
+    return {first, lo};
+}
+
+std::string FileIndex::memberName(const SeqRecord& seq, uint32_t frame, bool folded) const
+{
+    std::string_view pattern = str(folded ? seq.keyOff : seq.nameOff);
+    size_t headLen = folded ? seq.headLen : seq.nameHeadLen;
+    char digits[16];
+    std::snprintf(digits, sizeof(digits), "%0*u", (int)seq.width, (unsigned)frame);
+    std::string name;
+    name.reserve(pattern.size() + seq.width);
+    name.append(pattern.substr(0, headLen));
+    name.append(digits);
+    name.append(pattern.substr(headLen + 1));
+    return name;
+}
+
+std::string FileIndex::name(const Entry& entry) const
+{
+    if (entry.record & kSequenceEntry) {
+        return memberName(seqRecord(entry.record & ~kSequenceEntry), entry.frame, false);
+    }
+    return str(fileRecord(entry.record).nameOff);
+}
+
+std::string FileIndex::path(const Entry& entry) const
+{
+    return joinPath(dirPath(entry.dir), name(entry));
+}
+
+void FileIndex::find(std::string_view k, std::vector<Entry>& entries) const
+{
+    std::pair<size_t, size_t> range = equalRange(k);
+    for (size_t i = range.first; i < range.second; ++i) {
+        entries.push_back({fileRecord(i).dir, (uint32_t)i, 0});
+    }
+
+    FramePart fp;
+    if (seqCount_ == 0 || !splitFrame(k, fp)) return;
+    std::string sk(k.substr(0, fp.pos));
+    sk += '#';
+    sk += k.substr(fp.pos + fp.len);
+    std::pair<size_t, size_t> seqs = seqRange(sk, false);
+    for (size_t s = seqs.first; s < seqs.second; ++s) {
+        SeqRecord q = seqRecord(s);
+        if (q.width != fp.len) continue;
+        for (uint32_t r = 0; r < q.runCount; ++r) {
+            Run x = run(q.firstRun + r);
+            if (fp.frame >= x.first && fp.frame <= x.last) {
+                entries.push_back({q.dir, (uint32_t)s | kSequenceEntry, fp.frame});
+                break;
+            }
+        }
+    }
+}
+
+void FileIndex::find(std::string_view k, std::vector<std::string>& paths) const
+{
+    std::vector<Entry> entries;
+    find(k, entries);
+    for (const Entry& e : entries) paths.push_back(path(e));
+}
+
+size_t FileIndex::findSequence(std::string_view sequenceKey, std::vector<Entry>& entries) const
+{
+    std::pair<size_t, size_t> seqs = seqRange(sequenceKey, false);
+    for (size_t s = seqs.first; s < seqs.second; ++s) {
+        SeqRecord q = seqRecord(s);
+        entries.push_back({q.dir, (uint32_t)s | kSequenceEntry, run(q.firstRun).first});
+    }
+    return seqs.second - seqs.first;
+}
+
+size_t FileIndex::findSequence(std::string_view sequenceKey, std::vector<std::string>& paths) const
+{
+    std::vector<Entry> entries;
+    size_t found = findSequence(sequenceKey, entries);
+    for (const Entry& e : entries) paths.push_back(path(e));
+    return found;
+}
+
+size_t FileIndex::match(const GlobPattern& pattern, std::vector<Entry>& entries) const
+{
+    // Every match starts with the literal prefix and ends with the literal
+    // suffix: scan whichever of the two ranges is smaller.
+    std::pair<size_t, size_t> byPrefix = prefixRange(pattern.literalPrefix());
+    std::pair<size_t, size_t> bySuffixRange = suffixRange(pattern.literalSuffix());
+    bool usePrefix = byPrefix.second - byPrefix.first <= bySuffixRange.second - bySuffixRange.first;
+    std::pair<size_t, size_t> range = usePrefix ? byPrefix : bySuffixRange;
+
+    // Equal keys are adjacent in both orders, so each distinct name is
+    // matched once.
+    std::vector<size_t> hits;
+    std::string_view prevKey;
+    bool prevMatched = false;
+    for (size_t j = range.first; j < range.second; ++j) {
+        size_t i = usePrefix ? j : bySuffix(j);
+        std::string_view k = key(i);
+        if (j == range.first || k != prevKey) {
+            prevMatched = pattern.matches(k);
+            prevKey = k;
+        }
+        if (prevMatched) hits.push_back(i);
+    }
+    if (!usePrefix) std::sort(hits.begin(), hits.end());
+    for (size_t i : hits) entries.push_back({fileRecord(i).dir, (uint32_t)i, 0});
+    size_t tested = range.second - range.first;
+
+    // Sequence members. The literal prefix up to its first digit is also a
+    // prefix of the sequence key (the frame is the last digit run), and the
+    // literal suffix after its last digit ends the key's tail.
+    std::string_view prefix = pattern.literalPrefix();
+    prefix = prefix.substr(0, prefix.find_first_of("0123456789"));
+    std::string_view suffix = pattern.literalSuffix();
+    size_t lastDigit = suffix.find_last_of("0123456789");
+    if (lastDigit != std::string_view::npos) suffix = suffix.substr(lastDigit + 1);
+
+    std::pair<size_t, size_t> seqs = seqRange(prefix, true);
+    for (size_t s = seqs.first; s < seqs.second; ++s) {
+        SeqRecord q = seqRecord(s);
+        if (compareAffix(seqKey(s).substr(q.headLen + 1), suffix, true) != 0) continue;
+        for (uint32_t r = 0; r < q.runCount; ++r) {
+            Run x = run(q.firstRun + r);
+            for (uint64_t f = x.first; f <= x.last; ++f) {
+                ++tested;
+                if (pattern.matches(memberName(q, (uint32_t)f, true))) {
+                    entries.push_back({q.dir, (uint32_t)s | kSequenceEntry, (uint32_t)f});
+                }
+            }
+        }
+    }
+    return tested;
+}
+
+size_t FileIndex::match(const GlobPattern& pattern, std::vector<std::string>& paths) const
+{
+    std::vector<Entry> entries;
+    size_t tested = match(pattern, entries);
+    for (const Entry& e : entries) paths.push_back(path(e));
+    return tested;
+}
+
+bool FileIndex::update(const std::string& root, const std::string& indexPath,
+                       const ProgressFn& progress, const std::atomic<bool>* cancel)
+{
+    return rebuild(root, indexPath, progress, cancel, nullptr);
+}
+
+bool FileIndex::refresh(const std::string& root, const std::string& indexPath,
+                        const std::vector<std::string>& changedDirs, const std::atomic<bool>* cancel)
+{
+    return rebuild(root, indexPath, nullptr, cancel, &changedDirs);
+}
+
+bool FileIndex::rebuild(const std::string& root, const std::string& indexPath, const ProgressFn& progress,
+                        const std::atomic<bool>* cancel, const std::vector<std::string>* changedDirs)
+{
+    stats_ = UpdateStats();
+    error_.clear();
+    mapped_.close();
+    owned_.clear();
+    attach(nullptr, 0);
+    std::string rootNorm = normalizeRoot(root);
+
+    DirectoryWalker walker(threads_);
+    std::atomic<size_t> fileCounter{0};
+    std::function<bool()> tick;
+    if (progress) tick = [&]() { return progress(fileCounter.load()); };
+
+    // ---- Previous index: which directories are unchanged? ----
+    FileIndex old;
+    bool haveOld = old.open(indexPath) && old.root_ == rootNorm;
+
+    std::unordered_map<std::string, size_t> oldDirByPath;
+    std::vector<int64_t> oldMtimeNow;
+    if (haveOld) {
+        std::vector<std::string> dirPaths(old.dirCount_);
+        std::vector<uint32_t> ids(old.dirCount_);
+        for (size_t i = 0; i < old.dirCount_; ++i) {
+            const char* rel = old.str(old.dirRecord(i).pathOff);
+            oldDirByPath.emplace(rel, i);
+            dirPaths[i] = joinPath(rootNorm, rel);
+            ids[i] = (uint32_t)i;
+        }
+        oldMtimeNow.assign(old.dirCount_, DirectoryWalker::kNoMtime);
+        if (changedDirs) {
+            // The caller knows what changed: every other directory keeps its
+            // recorded mtime, so it is reused without a stat.
+            std::unordered_set<std::string> changed;
+            for (const auto& dir : *changedDirs) {
+                std::string rel;
+                if (relativeTo(rootNorm, dir, rel)) changed.insert(std::move(rel));
+            }
+            for (size_t i = 0; i < old.dirCount_; ++i) {
+                DirRecord r = old.dirRecord(i);
+                if (changed.count(old.str(r.pathOff)) == 0) oldMtimeNow[i] = r.mtime;
+            }
+        } else {
+            // One stat per directory, many in flight: on network shares each
+            // is a round trip, and there can be 100k directories.
+            if (!walker.run(ids, [&](uint32_t i) { oldMtimeNow[i] = DirectoryWalker::mtime(dirPaths[i]); },
+                            tick, cancel)) {
+                error_ = "cancelled";
+                return false;
+            }
+            stats_.dirsChecked = old.dirCount_;
+        }
+
+        bool changed = false;
+        for (size_t i = 0; i < old.dirCount_ && !changed; ++i) {
+            changed = oldMtimeNow[i] != old.dirRecord(i).mtime;
+        }
+        if (!changed) {
+            // Nothing was added, removed or renamed anywhere: keep the file.
+            stats_.files = old.totalFiles_;
+            stats_.sequences = old.seqCount_;
+            stats_.unchanged = true;
+            bool ok = open(indexPath);
+            if (progress) progress(totalFiles_);
+            return ok;
+        }
+    }
+
+    // Files, sequences and children of each old directory, for reuse.
+    std::vector<std::vector<uint32_t>> oldFiles, oldSeqs, oldChildren;
+    if (haveOld) {
+        oldFiles.resize(old.dirCount_);
+        oldSeqs.resize(old.dirCount_);
+        oldChildren.resize(old.dirCount_);
+        for (size_t i = 0; i < old.fileCount_; ++i) oldFiles[old.fileRecord(i).dir].push_back((uint32_t)i);
+        for (size_t i = 0; i < old.seqCount_; ++i) oldSeqs[old.seqRecord(i).dir].push_back((uint32_t)i);
+        for (size_t i = 1; i < old.dirCount_; ++i) oldChildren[old.dirRecord(i).parent].push_back((uint32_t)i);
+    }
+
+    // ---- Walk: reuse unchanged directories, list the others ----
+    // One directory per task on the work-stealing pool. Each task streams
+    // its files and subdirectories into the shared tables under one lock;
+    // ids are assigned in completion order and renumbered afterwards.
+    struct NewDir {
+        std::string rel;
+        uint32_t parent;
+        int64_t mtime;
+    };
+    struct NewFile {
+        std::string key;
+        std::string name;
+        uint32_t dir;
+    };
+    std::mutex tablesMutex;
+    std::vector<NewDir> dirs;
+    std::vector<NewFile> files;
+    dirs.push_back({std::string(), kNoParent, DirectoryWalker::kNoMtime});
+    std::atomic<size_t> listed{0};
+    std::atomic<bool> rootFailed{false};
+
+    auto task = [&](uint32_t d) {
+        std::string rel;
+        {
+            std::lock_guard<std::mutex> lock(tablesMutex);
+            rel = dirs[d].rel;
+        }
+
+        std::vector<NewFile> found;
+        std::vector<std::string> children;
+        int64_t mtime = DirectoryWalker::kNoMtime;
+        auto oldIt = oldDirByPath.find(rel);
+        size_t o = oldIt != oldDirByPath.end() ? oldIt->second : 0;
+        if (oldIt != oldDirByPath.end() && oldMtimeNow[o] != DirectoryWalker::kNoMtime &&
+            oldMtimeNow[o] == old.dirRecord(o).mtime) {
+            mtime = oldMtimeNow[o];
+            found.reserve(oldFiles[o].size());
+            for (uint32_t f : oldFiles[o]) {
+                FileRecord r = old.fileRecord(f);
+                found.push_back({old.str(r.keyOff), old.str(r.nameOff), d});
+            }
+            // Sequences are expanded and collapsed again with the rest.
+            for (uint32_t s : oldSeqs[o]) {
+                SeqRecord q = old.seqRecord(s);
+                for (uint32_t r = 0; r < q.runCount; ++r) {
+                    Run x = old.run(q.firstRun + r);
+                    for (uint64_t f = x.first; f <= x.last; ++f) {
+                        found.push_back({old.memberName(q, (uint32_t)f, true), old.memberName(q, (uint32_t)f, false), d});
+                    }
+                }
+            }
+            for (uint32_t c : oldChildren[o]) children.emplace_back(old.str(old.dirRecord(c).pathOff));
+        } else {
+            DirectoryWalker::Listing listing;
+            listed.fetch_add(1);
+            if (DirectoryWalker::list(joinPath(rootNorm, rel), listing)) {
+                mtime = listing.mtime;
+                found.reserve(listing.files.size());
+                for (auto& n : listing.files) {
+                    std::string k = foldCase(n);
+                    found.push_back({std::move(k), std::move(n), d});
+                }
+                for (const auto& sub : listing.subdirs) children.push_back(joinPath(rel, sub));
+            } else if (d == 0) {
+                rootFailed = true;
+            }
+        }
+        fileCounter.fetch_add(found.size());
+        if (listener_ && !found.empty()) {
+            std::vector<std::string> names;
+            names.reserve(found.size());
+            for (const auto& f : found) names.push_back(f.name);
+            listener_(joinPath(rootNorm, rel), names);
+        }
+
+        std::vector<uint32_t> childIds;
+        {
+            std::lock_guard<std::mutex> lock(tablesMutex);
+            dirs[d].mtime = mtime;
+            for (auto& f : found) files.push_back(std::move(f));
+            for (auto& c : children) {
+                childIds.push_back((uint32_t)dirs.size());
+                dirs.push_back({std::move(c), d, DirectoryWalker::kNoMtime});
+            }
+        }
+        for (uint32_t id : childIds) walker.push(id);
+    };
+
+    if (!walker.run({0}, task, tick, cancel)) {
+        error_ = "cancelled";
+        return false;
+    }
+    stats_.dirsListed = listed.load();
+    if (rootFailed) {
+        error_ = "cannot read " + rootNorm;
+        return false;
+    }
+    if (dirs.size() > kNoParent || files.size() > 0xFFFFFFFFu) {
+        error_ = "too many files under " + rootNorm;
+        return false;
+    }
+
+    // ---- Collapse numbered files into sequences ----
+    // Members share a directory, the text around the last digit run and its
+    // width; the original-case head and tail are kept so every member name
+    // can be rebuilt.
+    struct NewSeq {
+        std::string key;   // folded "head#tail"
+        std::string name;  // original "head#tail"
+        uint32_t dir;
+        uint32_t headLen;
+        uint32_t nameHeadLen;
+        uint32_t width;
+        std::vector<uint32_t> frames;
+    };
+    std::vector<NewSeq> seqs;
+    std::vector<char> collapsed(files.size(), 0);
+    {
+        std::unordered_map<std::string, std::vector<uint32_t>> groups;
+        for (size_t i = 0; i < files.size(); ++i) {
+            const std::string& n = files[i].name;
+            FramePart fp;
+            if (!splitFrame(n, fp)) continue;
+            std::string group = std::to_string(files[i].dir) + '/' + std::to_string(fp.len) + '/';
+            group.append(n, 0, fp.pos);
+            group += '#';
+            group.append(n, fp.pos + fp.len, std::string::npos);
+            groups[group].push_back((uint32_t)i);
+        }
+        for (auto& g : groups) {
+            if (g.second.size() < kMinSequence) continue;
+            const NewFile& first = files[g.second[0]];
+            FramePart fp;
+            splitFrame(first.name, fp);
+            std::string head = first.name.substr(0, fp.pos);
+            std::string tail = first.name.substr(fp.pos + fp.len);
+            std::string keyHead = foldCase(head);
+
+            NewSeq seq;
+            seq.key = keyHead + '#' + foldCase(tail);
+            seq.name = head + '#' + tail;
+            seq.dir = first.dir;
+            seq.headLen = (uint32_t)keyHead.size();
+            seq.nameHeadLen = (uint32_t)head.size();
+            seq.width = (uint32_t)fp.len;
+            for (uint32_t i : g.second) {
+                splitFrame(files[i].name, fp);
+                seq.frames.push_back(fp.frame);
+                collapsed[i] = 1;
+            }
+            std::sort(seq.frames.begin(), seq.frames.end());
+            seqs.push_back(std::move(seq));
+        }
+    }
+
+    // ---- Serialize ----
+    // Directories sorted by relative path (a parent is a prefix of its
+    // children, so it always comes first), files and sequences by key,
+    // directory, name: the file is identical whatever order the walk
+    // finished in.
+    std::vector<uint32_t> dirOrder(dirs.size());
+    for (size_t i = 0; i < dirOrder.size(); ++i) dirOrder[i] = (uint32_t)i;
+    std::sort(dirOrder.begin(), dirOrder.end(),
+              [&](uint32_t a, uint32_t b) { return dirs[a].rel < dirs[b].rel; });
+    std::vector<uint32_t> newDirId(dirs.size());
+    for (size_t i = 0; i < dirOrder.size(); ++i) newDirId[dirOrder[i]] = (uint32_t)i;
+    for (auto& f : files) f.dir = newDirId[f.dir];
+    for (auto& q : seqs) q.dir = newDirId[q.dir];
+
+    std::vector<uint32_t> order;
+    order.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!collapsed[i]) order.push_back((uint32_t)i);
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const NewFile& x = files[a];
+        const NewFile& y = files[b];
+        if (x.key != y.key) return x.key < y.key;
+        if (x.dir != y.dir) return x.dir < y.dir;
+        return x.name < y.name;
+    });
+
+    std::sort(seqs.begin(), seqs.end(), [](const NewSeq& x, const NewSeq& y) {
+        if (x.key != y.key) return x.key < y.key;
+        if (x.dir != y.dir) return x.dir < y.dir;
+        if (x.name != y.name) return x.name < y.name;
+        return x.width < y.width;
+    });
+
+    StringPool pool;
+    Header h;
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.dirCount = (uint32_t)dirs.size();
+    h.fileCount = (uint32_t)order.size();
+    h.seqCount = (uint32_t)seqs.size();
+    bool fits = pool.add(rootNorm, h.rootOff);
+
+    std::vector<uint32_t> suffixOrder(order.size());
+    for (size_t j = 0; j < order.size(); ++j) suffixOrder[j] = (uint32_t)j;
+    std::stable_sort(suffixOrder.begin(), suffixOrder.end(), [&](uint32_t a, uint32_t b) {
+        return reversedLess(files[order[a]].key, files[order[b]].key);
+    });
+
+    std::string tables;
+    tables.reserve(dirs.size() * sizeof(DirRecord) + files.size() * (sizeof(FileRecord) + sizeof(uint32_t)));
+    for (uint32_t i : dirOrder) {
+        const NewDir& d = dirs[i];
+        DirRecord r{0, d.parent == kNoParent ? kNoParent : newDirId[d.parent], d.mtime};
+        fits = fits && pool.add(d.rel, r.pathOff);
+        append(tables, r);
+    }
+    for (uint32_t i : order) {
+        const NewFile& f = files[i];
+        FileRecord r{0, 0, f.dir};
+        fits = fits && pool.add(f.key, r.keyOff);
+        if (f.name == f.key) {
+            r.nameOff = r.keyOff;
+        } else {
+            fits = fits && pool.add(f.name, r.nameOff);
+        }
+        append(tables, r);
+    }
+    for (uint32_t id : suffixOrder) append(tables, id);
+
+    std::string runs;
+    uint32_t runTotal = 0;
+    for (const auto& q : seqs) {
+        SeqRecord r{0, 0, q.dir, q.headLen, q.nameHeadLen, q.width, runTotal, 0};
+        fits = fits && pool.add(q.key, r.keyOff);
+        if (q.name == q.key) {
+            r.nameOff = r.keyOff;
+        } else {
+            fits = fits && pool.add(q.name, r.nameOff);
+        }
+        // Consecutive frames become one run; gaps start a new one.
+        for (size_t k = 0; k < q.frames.size();) {
+            size_t e = k;
+            while (e + 1 < q.frames.size() && q.frames[e + 1] == q.frames[e] + 1) ++e;
+            append(runs, Run{q.frames[k], q.frames[e]});
+            ++r.runCount;
+            k = e + 1;
+        }
+        runTotal += r.runCount;
+        append(tables, r);
+    }
+    tables += runs;
+    h.runCount = runTotal;
+    if (!fits) {
+        error_ = "index for " + rootNorm + " exceeds 4 GB";
+        return false;
+    }
+    h.stringBytes = pool.data.size();
+
+    std::string blob;
+    blob.reserve(sizeof(Header) + tables.size() + pool.data.size());
+    append(blob, h);
+    blob += tables;
+    blob += pool.data;
+    stats_.files = files.size();
+    stats_.sequences = seqs.size();
+
+    // ---- Write (temp file + rename), then map ----
+    old.mapped_.close();  // release the old mapping before replacing the file
+    fs::path target = fs::u8path(indexPath);
+    // A watcher refresh, a Batch Locate update and mayaIndexService (another
+    // process) can write the same index: each writes its own temp file, named
+    // after its process and thread, and the last rename wins.
+#ifdef _WIN32
+    const unsigned long pid = GetCurrentProcessId();
+#else
+    const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    fs::path temp = target;
+    temp += "." + std::to_string(pid) + "-" +
+            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFFFF) + ".tmp";
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+    bool written = false;
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(blob.data(), (std::streamsize)blob.size());
+        written = (bool)out;
+    }
+    if (written) {
+        fs::rename(temp, target, ec);
+        written = !ec;
+    }
+    if (!written) fs::remove(temp, ec);
+
+    if (written && open(indexPath)) {
+        if (progress) progress(totalFiles_);
+        return true;
+    }
+
+    // Read-only cache location: serve this session from memory.
+    error_ = "cannot write " + indexPath;
+    mapped_.close();
+    owned_ = std::move(blob);
+    attach(owned_.data(), owned_.size());
+    if (progress) progress(totalFiles_);
+    return true;
+}
+
+std::string FileIndex::sequenceKey(const std::string& name)
+{
+    FramePart fp;
+    if (!splitFrame(name, fp)) return "";
+    return name.substr(0, fp.pos) + '#' + name.substr(fp.pos + fp.len);
+}
+
+std::string FileIndex::foldCase(const std::string& name)
+{
+#ifdef _WIN32
+    std::wstring w = utf8ToWide(name);
+    if (w.empty()) return name;
+    std::wstring low(w.size(), 0);
+    int ret = LCMapStringW(LOCALE_INVARIANT, LCMAP_LOWERCASE, w.c_str(), (int)w.size(), &low[0],
+                           (int)low.size());
+    if (ret != 0) return wideToUtf8(low);
+#endif
+    std::string out = name;
+    for (auto& c : out) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return out;
+}
+
+std::string FileIndex::cacheDirectory()
+{
+    std::string base;
+#ifdef _WIN32
+    const char* env = std::getenv("LOCALAPPDATA");
+    if (!env || !*env) env = std::getenv("TEMP");
+    if (env && *env) base = env;
+#else
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (xdg && *xdg) {
+        base = xdg;
+    } else if (home && *home) {
+        base = std::string(home) + "/.cache";
+    }
+#endif
+    if (base.empty()) {
+        std::error_code ec;
+        base = fs::temp_directory_path(ec).generic_u8string();
+    }
+    return (fs::u8path(base) / "MayaRefChecker").generic_u8string();
+}
+
+std::string FileIndex::defaultIndexPath(const std::string& root)
+{
+    // FNV-1a of the normalized, case-folded root.
+    std::string key = foldCase(normalizeRoot(root));
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.fidx", (unsigned long long)h);
+    return (fs::u8path(cacheDirectory()) / "FileIndex" / name).generic_u8string();
+}
@@ -0,0 +1,190 @@
+#pragma once
+#ifndef FILEINDEX_H
+#define FILEINDEX_H
+
+#include "MappedFile.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class GlobPattern;
+
+// Persistent index of every file under one search root, used by Batch
+// Locate to find files by name.
+//
+// The index is one file per root in a flat, memory-mappable layout: a
+// directory table (relative path, parent, mtime), a file table sorted by
+// case-folded file name and a permutation of it sorted by reversed name (for
+// suffix lookups), all pointing into a string pool. Opening it maps the file
+// and validates it; lookups are a binary search over the mapping with no
+// per-file allocation.
+//
+// Numbered files (texture tiles, frame caches, versions) are collapsed while
+// the index is built: files in one directory whose names differ only in the
+// last run of digits, with the same digit count, become one sequence entry
+// ("tex.#.exr", the frame ranges and the gaps between them) once there are
+// kMinSequence of them. find() and match() still see every member file.
+//
+// update() brings the index up to date without walking the whole tree: the
+// mtime of every known directory is checked (in parallel, on a
+// DirectoryWalker), and only directories whose mtime changed are listed
+// again. A directory's mtime changes whenever an entry is added, removed or
+// renamed in it, so the rest of the old index is reused as is. When nothing
+// changed, the existing file is mapped and nothing is rewritten.
+class FileIndex {
+public:
+    struct UpdateStats {
+        size_t dirsChecked = 0;  // directory mtimes compared with the old index
+        size_t dirsListed = 0;   // directories listed from disk
+        size_t files = 0;        // every file, sequence members included
+        size_t sequences = 0;    // sequence entries the members were collapsed into
+        bool unchanged = false;  // old index reused without rewriting
+    };
+
+    // Called with the number of files indexed so far; return false to cancel.
+    using ProgressFn = std::function<bool(size_t files)>;
+
+    // Fewest numbered files collapsed into one sequence entry.
+    static const size_t kMinSequence = 3;
+
+    FileIndex() = default;
+    FileIndex(const FileIndex&) = delete;
+    FileIndex& operator=(const FileIndex&) = delete;
+
+    // Refresh the index of `root` stored at `indexPath` (created if missing,
+    // rebuilt if unreadable or for another root) and map the result. If the
+    // index cannot be written, the refreshed index is still usable from
+    // memory. Returns false if the root cannot be read or on cancel.
+    bool update(const std::string& root, const std::string& indexPath,
+                const ProgressFn& progress = nullptr,
+                const std::atomic<bool>* cancel = nullptr);
+
+    // update() for a caller that knows which directories had entries added,
+    // removed or renamed since the index at `indexPath` was written (full
+    // paths, e.g. from a FileWatcher): only those are listed again, and the
+    // other directories are reused without checking their mtime. New
+    // subdirectories of a listed directory are walked as usual.
+    bool refresh(const std::string& root, const std::string& indexPath,
+                 const std::vector<std::string>& changedDirs,
+                 const std::atomic<bool>* cancel = nullptr);
+
+    // Called from the walker threads with each directory (full path) and its
+    // file names, original case, as update() or refresh() indexes it, so a
+    // caller can act on files before the walk finishes.
+    using DirectoryFn = std::function<void(const std::string& dir, const std::vector<std::string>& names)>;
+
+    // Worker threads for update() and refresh() (0 = DirectoryWalker default).
+    void setThreads(unsigned threads) { threads_ = threads; }
+    void setDirectoryListener(DirectoryFn listener) { listener_ = std::move(listener); }
+
+    // Map an existing index without refreshing it.
+    bool open(const std::string& indexPath);
+
+    const std::string& root() const { return root_; }
+    // Number of files, every sequence member included.
+    size_t size() const { return totalFiles_; }
+    size_t sequenceCount() const { return seqCount_; }
+    const UpdateStats& stats() const { return stats_; }
+    const std::string& error() const { return error_; }
+
+    // Directories (the root is 0) as full paths, the prefix of the paths
+    // returned by the lookups below.
+    size_t dirCount() const { return dirCount_; }
+    std::string dirPath(size_t d) const;
+
+    // A file found by a lookup: its directory and a single-file record or one
+    // frame of a sequence record. Names and paths are only built on request.
+    struct Entry {
+        uint32_t dir;
+        uint32_t record;  // file record, or sequence record | kSequenceEntry
+        uint32_t frame;   // sequences only
+    };
+    static const uint32_t kSequenceEntry = 0x80000000u;
+
+    // Every file whose case-folded name is `key`.
+    void find(std::string_view key, std::vector<Entry>& entries) const;
+    void find(std::string_view key, std::vector<std::string>& paths) const;
+
+    // Every file whose case-folded name matches the pattern. Only the files
+    // sharing the pattern's literal prefix or suffix, whichever are fewer,
+    // are tested; returns the number tested.
+    size_t match(const GlobPattern& pattern, std::vector<Entry>& entries) const;
+    size_t match(const GlobPattern& pattern, std::vector<std::string>& paths) const;
+
+    // One file per sequence whose key is `sequenceKey` (case-folded, '#' in
+    // place of the frame number, e.g. "tex.#.exr"): its first frame.
+    // Returns the number of sequences found.
+    size_t findSequence(std::string_view sequenceKey, std::vector<Entry>& entries) const;
+    size_t findSequence(std::string_view sequenceKey, std::vector<std::string>& paths) const;
+
+    // File name (original case) and full path of an entry.
+    std::string name(const Entry& entry) const;
+    std::string path(const Entry& entry) const;
+
+    // Sequence key of a name: its last run of digits replaced by '#', or ""
+    // if the name has no digits (or too many to be a frame number).
+    static std::string sequenceKey(const std::string& name);
+
+    // Lowercase a UTF-8 file name the way keys are stored (invariant-locale
+    // Unicode lowercase on Windows, ASCII elsewhere).
+    static std::string foldCase(const std::string& name);
+
+    // Per-user cache directory, %LOCALAPPDATA%/MayaRefChecker (Windows) or
+    // $XDG_CACHE_HOME/MayaRefChecker; the temp directory as a last resort.
+    static std::string cacheDirectory();
+
+    // Per-user index location for a root, e.g.
+    // %LOCALAPPDATA%/MayaRefChecker/FileIndex/<hash>.fidx.
+    static std::string defaultIndexPath(const std::string& root);
+
+private:
+    struct DirRecord;
+    struct FileRecord;
+    struct SeqRecord;
+    struct Run;
+
+    bool rebuild(const std::string& root, const std::string& indexPath, const ProgressFn& progress,
+                 const std::atomic<bool>* cancel, const std::vector<std::string>* changedDirs);
+    bool attach(const char* data, size_t size);
+    DirRecord dirRecord(size_t i) const;
+    FileRecord fileRecord(size_t i) const;
+    SeqRecord seqRecord(size_t s) const;
+    Run run(size_t r) const;
+    size_t bySuffix(size_t j) const;
+    const char* str(uint32_t offset) const { return strings_ + offset; }
+
+    // Single files, sorted by key.
+    std::string_view key(size_t i) const;
+    std::pair<size_t, size_t> equalRange(std::string_view key) const;
+    std::pair<size_t, size_t> prefixRange(std::string_view prefix) const;
+    // Positions in suffix order (see bySuffix) whose key ends with `suffix`.
+    std::pair<size_t, size_t> suffixRange(std::string_view suffix) const;
+
+    // Sequences, sorted by sequence key.
+    std::string_view seqKey(size_t s) const;
+    std::pair<size_t, size_t> seqRange(std::string_view key, bool prefix) const;
+    std::string memberName(const SeqRecord& seq, uint32_t frame, bool folded) const;
+
+    MappedFile mapped_;
+    std::string owned_;  // serialized index when it could not be written
+    const char* base_ = nullptr;
+    const char* strings_ = nullptr;
+    size_t dirCount_ = 0;
+    size_t fileCount_ = 0;  // single files
+    size_t seqCount_ = 0;
+    size_t runCount_ = 0;
+    size_t totalFiles_ = 0;
+    std::string root_;
+    UpdateStats stats_;
+    std::string error_;
+    unsigned threads_ = 0;
+    DirectoryFn listener_;
+};
+
+#endif // FILEINDEX_H
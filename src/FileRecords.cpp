@@ -0,0 +1,201 @@
+#include "FileRecords.h"
+#include "FileIndex.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// File layout (little-endian):
+//   "MRFRECS\0" u32 version u32 count
+//   per record: u32 keyLength + key bytes, u64 size, u64 fingerprint, i64 seen
+const char kMagic[8] = {'M', 'R', 'F', 'R', 'E', 'C', 'S', '\0'};
+const uint32_t kVersion = 1;
+
+void putU(std::string& out, uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) out += (char)((v >> (8 * i)) & 0xFF);
+}
+
+int64_t now()
+{
+    using namespace std::chrono;
+    return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+std::string FileRecords::defaultPath()
+{
+    return (fs::u8path(FileIndex::cacheDirectory()) / "FileRecords.bin").generic_u8string();
+}
+
+std::string FileRecords::key(const std::string& path)
+{
+    std::string k = path;
+    for (auto& c : k) {
+        if (c == '\\') c = '/';
+    }
+    return FileIndex::foldCase(k);
+}
+
+bool FileRecords::load(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    dirty_ = false;
+
+    std::error_code ec;
+    if (!fs::exists(fs::u8path(path), ec)) return true;
+
+    MappedFile file;
+    if (!file.open(path)) return false;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(file.data());
+    const unsigned char* end = p + file.size();
+    bool ok = true;
+    auto get = [&](int bytes) -> uint64_t {
+        if (!ok || end - p < bytes) {
+            ok = false;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+        p += bytes;
+        return v;
+    };
+
+    if (file.size() < sizeof(kMagic) || std::memcmp(file.data(), kMagic, sizeof(kMagic)) != 0) return false;
+    p += sizeof(kMagic);
+    if (get(4) != kVersion) return true;  // older format: start empty
+
+    uint64_t count = get(4);
+    std::unordered_map<std::string, Entry> loaded;
+    loaded.reserve((size_t)std::min<uint64_t>(count, kMaxRecords));
+    for (uint64_t i = 0; ok && i < count; ++i) {
+        uint64_t n = get(4);
+        if (!ok || (uint64_t)(end - p) < n) {
+            ok = false;
+            break;
+        }
+        std::string k(reinterpret_cast<const char*>(p), (size_t)n);
+        p += n;
+        Entry e;
+        e.record.size = get(8);
+        e.record.fingerprint = get(8);
+        e.seen = (int64_t)get(8);
+        if (ok) loaded[std::move(k)] = e;
+    }
+    if (!ok) return false;
+
+    entries_.swap(loaded);
+    return true;
+}
+
+bool FileRecords::save(const std::string& path) const
+{
+    std::string buf;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_) return true;
+
+        std::vector<const std::pair<const std::string, Entry>*> keep;
+        keep.reserve(entries_.size());
+        for (const auto& kv : entries_) keep.push_back(&kv);
+        if (keep.size() > kMaxRecords) {
+            std::nth_element(keep.begin(), keep.begin() + kMaxRecords, keep.end(),
+                             [](const auto* a, const auto* b) { return a->second.seen > b->second.seen; });
+            keep.resize(kMaxRecords);
+        }
+
+        buf.append(kMagic, sizeof(kMagic));
+        putU(buf, kVersion, 4);
+        putU(buf, keep.size(), 4);
+        for (const auto* kv : keep) {
+            putU(buf, kv->first.size(), 4);
+            buf += kv->first;
+            putU(buf, kv->second.record.size, 8);
+            putU(buf, kv->second.record.fingerprint, 8);
+            putU(buf, (uint64_t)kv->second.seen, 8);
+        }
+        // A record() while the file is written marks the store dirty again.
+        dirty_ = false;
+    }
+    auto failed = [this]() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty_ = true;
+        return false;
+    };
+
+    // Every Maya session of the user saves the same file: each writes its
+    // own temp file, named after its process and thread, and the last
+    // rename wins.
+#ifdef _WIN32
+    const unsigned long pid = GetCurrentProcessId();
+#else
+    const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    fs::path target = fs::u8path(path);
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+    fs::path temp = target;
+    temp += "." + std::to_string(pid) + "-" +
+            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFFFF) + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) return failed();
+        out.write(buf.data(), (std::streamsize)buf.size());
+        if (!out) {
+            out.close();
+            fs::remove(temp, ec);
+            return failed();
+        }
+    }
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return failed();
+    }
+    return true;
+}
+
+void FileRecords::record(const std::string& path, uint64_t size, uint64_t fingerprint)
+{
+    std::string k = key(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& e = entries_[k];
+    if (fingerprint == 0 && e.record.size == size) fingerprint = e.record.fingerprint;
+    e.record.size = size;
+    e.record.fingerprint = fingerprint;
+    e.seen = now();
+    dirty_ = true;
+}
+
+bool FileRecords::lookup(const std::string& path, FileRecord& out) const
+{
+    std::string k = key(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(k);
+    if (it == entries_.end()) return false;
+    out = it->second.record;
+    return true;
+}
+
+size_t FileRecords::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef FILERECORDS_H
+#define FILERECORDS_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// What was last seen of a dependency file while it still existed.
+struct FileRecord {
+    uint64_t size = 0;
+    uint64_t fingerprint = 0;  // FileFingerprint::sampled, 0 if never taken
+};
+
+// Per-user store of dependency sizes and fingerprints, keyed by path, so a
+// file that later goes missing can be recognised among same-name Batch
+// Locate candidates (AutoMatcher::Query::expectedSize/expectedFingerprint).
+// Sizes are recorded for free on every scan; fingerprints when a path is
+// applied. One binary file (defaultPath()); all methods are thread-safe.
+class FileRecords {
+public:
+    // Records beyond this are dropped on save, least recently seen first.
+    static constexpr size_t kMaxRecords = 200000;
+
+    // %LOCALAPPDATA%/MayaRefChecker/FileRecords.bin (XDG cache elsewhere).
+    static std::string defaultPath();
+
+    // A missing file is an empty store; a corrupt or outdated one is
+    // discarded. False only if the file exists but could not be used.
+    bool load(const std::string& path);
+
+    // Atomic write (temp file + rename); no-op when nothing changed.
+    bool save(const std::string& path) const;
+
+    // Note a file seen at `path`. A fingerprint of 0 keeps the stored one
+    // while the size is unchanged.
+    void record(const std::string& path, uint64_t size, uint64_t fingerprint = 0);
+
+    bool lookup(const std::string& path, FileRecord& out) const;
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        FileRecord record;
+        int64_t seen = 0;  // unix seconds
+    };
+
+    static std::string key(const std::string& path);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    mutable bool dirty_ = false;  // changed since the last successful save()
+};
+
+#endif // FILERECORDS_H
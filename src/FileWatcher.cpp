@@ -0,0 +1,323 @@
+#include "FileWatcher.h"
+#include "DirectoryWalker.h"
+
+#include <cstring>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(_WIN32) || defined(__linux__)
+std::string joinPath(const std::string& dir, const std::string& name)
+{
+    if (dir.empty()) return name;
+    if (dir.back() == '/') return dir + name;
+    return dir + "/" + name;
+}
+#endif
+
+#ifdef _WIN32
+
+std::wstring utf8ToWide(const std::string& s)
+{
+    if (s.empty()) return {};
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
+    if (len <= 0) return {};
+    std::wstring w(len, 0);
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &w[0], len);
+    return w;
+}
+
+std::string wideToUtf8(const std::wstring& w)
+{
+    if (w.empty()) return {};
+    int len = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return {};
+    std::string s(len, 0);
+    WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), &s[0], len, nullptr, nullptr);
+    return s;
+}
+
+// One overlapped ReadDirectoryChangesW on the root with bWatchSubtree: the
+// kernel reports every level, so new directories need no setup.
+class WindowsWatcher : public FileWatcher {
+public:
+    ~WindowsWatcher() override { stop(); }
+
+    bool start(const std::string& root, const std::vector<std::string>& /*dirs*/,
+               ChangeFn onChange) override
+    {
+        stop();
+        root_ = root;
+        onChange_ = std::move(onChange);
+        dir_ = CreateFileW(utf8ToWide(root).c_str(), FILE_LIST_DIRECTORY,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (dir_ == INVALID_HANDLE_VALUE) {
+            error_ = "cannot open " + root;
+            return false;
+        }
+        stopEvent_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        thread_ = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void stop() override
+    {
+        if (thread_.joinable()) {
+            SetEvent(stopEvent_);
+            thread_.join();
+        }
+        if (dir_ != INVALID_HANDLE_VALUE) CloseHandle(dir_);
+        if (stopEvent_) CloseHandle(stopEvent_);
+        dir_ = INVALID_HANDLE_VALUE;
+        stopEvent_ = nullptr;
+    }
+
+private:
+    void run()
+    {
+        // 64 KB is the largest buffer network redirectors accept; an
+        // overflow is reported as a zero-byte completion.
+        std::vector<DWORD> buffer(16 * 1024);
+        OVERLAPPED ov = {};
+        ov.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME;
+
+        for (;;) {
+            ResetEvent(ov.hEvent);
+            if (!ReadDirectoryChangesW(dir_, buffer.data(), (DWORD)(buffer.size() * sizeof(DWORD)), TRUE, filter,
+                                       nullptr, &ov, nullptr)) {
+                onChange_({}, true);
+                break;
+            }
+            HANDLE handles[2] = {ov.hEvent, stopEvent_};
+            DWORD waited = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+            DWORD bytes = 0;
+            if (waited != WAIT_OBJECT_0) {
+                CancelIoEx(dir_, &ov);
+                GetOverlappedResult(dir_, &ov, &bytes, TRUE);
+                break;
+            }
+            if (!GetOverlappedResult(dir_, &ov, &bytes, FALSE)) {
+                // ERROR_NOTIFY_ENUM_DIR: too many changes at once. Anything
+                // else (the root was removed, the share went away) ends the
+                // watch.
+                bool keepGoing = GetLastError() == ERROR_NOTIFY_ENUM_DIR;
+                onChange_({}, true);
+                if (keepGoing) continue;
+                break;
+            }
+            if (bytes == 0) {
+                onChange_({}, true);
+                continue;
+            }
+
+            std::set<std::string> changed;
+            const char* p = reinterpret_cast<const char*>(buffer.data());
+            for (;;) {
+                const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(p);
+                if (info->Action != FILE_ACTION_MODIFIED) {
+                    std::wstring rel(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                    size_t slash = rel.rfind(L'\\');
+                    std::string dir = root_;
+                    if (slash != std::wstring::npos) {
+                        std::string sub = wideToUtf8(rel.substr(0, slash));
+                        for (auto& c : sub) {
+                            if (c == '\\') c = '/';
+                        }
+                        dir = joinPath(root_, sub);
+                    }
+                    changed.insert(dir);
+                }
+                if (info->NextEntryOffset == 0) break;
+                p += info->NextEntryOffset;
+            }
+            if (!changed.empty()) onChange_(std::vector<std::string>(changed.begin(), changed.end()), false);
+        }
+        CloseHandle(ov.hEvent);
+    }
+
+    std::string root_;
+    ChangeFn onChange_;
+    HANDLE dir_ = INVALID_HANDLE_VALUE;
+    HANDLE stopEvent_ = nullptr;
+    std::thread thread_;
+};
+
+#elif defined(__linux__)
+
+// Same folding as FileIndex::foldCase for the ASCII names in the skip list.
+std::string asciiLower(const std::string& s)
+{
+    std::string out = s;
+    for (auto& c : out) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return out;
+}
+
+// inotify is not recursive: every directory gets its own watch, and a
+// directory created or moved into the tree is watched (with its subtree)
+// when its event arrives. The watch limit is fs.inotify.max_user_watches.
+class InotifyWatcher : public FileWatcher {
+public:
+    ~InotifyWatcher() override { stop(); }
+
+    bool start(const std::string& root, const std::vector<std::string>& dirs, ChangeFn onChange) override
+    {
+        stop();
+        onChange_ = std::move(onChange);
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0 || pipe2(wake_, O_NONBLOCK | O_CLOEXEC) != 0) {
+            error_ = std::string("inotify: ") + std::strerror(errno);
+            closeAll();
+            return false;
+        }
+        if (!addWatch(root)) {
+            error_ = "cannot watch " + root + ": " + std::strerror(errno);
+            closeAll();
+            return false;
+        }
+        for (const auto& dir : dirs) {
+            // A directory that is already gone is fine; running out of
+            // watches is not.
+            if (!addWatch(dir) && errno == ENOSPC) {
+                error_ = "inotify watch limit reached (fs.inotify.max_user_watches)";
+                closeAll();
+                return false;
+            }
+        }
+        thread_ = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void stop() override
+    {
+        if (thread_.joinable()) {
+            char c = 0;
+            (void)!write(wake_[1], &c, 1);
+            thread_.join();
+        }
+        closeAll();
+    }
+
+private:
+    static const uint32_t kMask =
+        IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    bool addWatch(const std::string& dir)
+    {
+        int wd = inotify_add_watch(fd_, dir.c_str(), kMask);
+        if (wd < 0) return false;
+        // The same directory (moved within the tree) keeps its descriptor.
+        watches_[wd] = dir;
+        return true;
+    }
+
+    // Watch a new directory and everything below it; false if a watch could
+    // not be added for lack of watches.
+    bool addTree(const std::string& dir)
+    {
+        std::vector<std::string> pending{dir};
+        while (!pending.empty()) {
+            std::string d = std::move(pending.back());
+            pending.pop_back();
+            if (!addWatch(d)) {
+                if (errno == ENOSPC) return false;
+                continue;
+            }
+            DirectoryWalker::Listing listing;
+            if (!DirectoryWalker::list(d, listing)) continue;
+            for (const auto& sub : listing.subdirs) pending.push_back(joinPath(d, sub));
+        }
+        return true;
+    }
+
+    void run()
+    {
+        alignas(struct inotify_event) char buf[64 * 1024];
+        pollfd fds[2] = {{fd_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+        for (;;) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                onChange_({}, true);
+                return;
+            }
+            if (fds[1].revents) return;
+
+            std::set<std::string> changed;
+            bool overflow = false;
+            for (;;) {
+                ssize_t n = read(fd_, buf, sizeof(buf));
+                if (n <= 0) break;
+                for (char* p = buf; p < buf + n;) {
+                    const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(p);
+                    p += sizeof(struct inotify_event) + ev->len;
+                    if (ev->mask & IN_Q_OVERFLOW) {
+                        overflow = true;
+                        continue;
+                    }
+                    auto it = watches_.find(ev->wd);
+                    if (it == watches_.end()) continue;
+                    if (ev->mask & IN_IGNORED) {
+                        watches_.erase(it);
+                        continue;
+                    }
+                    std::string dir = it->second;
+                    changed.insert(dir);
+                    if ((ev->mask & IN_ISDIR) && (ev->mask & (IN_CREATE | IN_MOVED_TO)) && ev->len > 0) {
+                        std::string name = ev->name;
+                        if (!DirectoryWalker::skipDirectory(asciiLower(name)) && !addTree(joinPath(dir, name))) {
+                            overflow = true;
+                        }
+                    }
+                }
+            }
+            if (!changed.empty() || overflow) {
+                onChange_(std::vector<std::string>(changed.begin(), changed.end()), overflow);
+            }
+        }
+    }
+
+    void closeAll()
+    {
+        if (fd_ >= 0) close(fd_);
+        if (wake_[0] >= 0) close(wake_[0]);
+        if (wake_[1] >= 0) close(wake_[1]);
+        fd_ = wake_[0] = wake_[1] = -1;
+        watches_.clear();
+    }
+
+    ChangeFn onChange_;
+    int fd_ = -1;
+    int wake_[2] = {-1, -1};
+    std::unordered_map<int, std::string> watches_;  // descriptor -> directory; watcher thread only once started
+    std::thread thread_;
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<FileWatcher> FileWatcher::create()
+{
+#ifdef _WIN32
+    return std::make_unique<WindowsWatcher>();
+#elif defined(__linux__)
+    return std::make_unique<InotifyWatcher>();
+#else
+    return nullptr;
+#endif
+}
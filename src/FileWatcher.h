@@ -0,0 +1,47 @@
+#pragma once
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Recursive notification of entries added to, removed from or renamed in
+// the directories under one root. Linux uses inotify (one watch per
+// directory, added for new directories as they appear); Windows uses one
+// ReadDirectoryChangesW subtree watch. Changes to file contents are not
+// reported: FileIndex only stores names.
+//
+// Notifications arrive on the watcher's own thread. When events are lost
+// (kernel queue or buffer overflow, a new directory that cannot be
+// watched) the callback is told so, and the caller must check the whole
+// tree instead.
+class FileWatcher {
+public:
+    // Directories (full paths, '/'-separated) whose entries changed, or
+    // overflow == true if some changes were not reported.
+    using ChangeFn = std::function<void(const std::vector<std::string>& dirs, bool overflow)>;
+
+    virtual ~FileWatcher() = default;
+
+    // The platform watcher, or nullptr where there is none.
+    static std::unique_ptr<FileWatcher> create();
+
+    // Start watching `root`. `dirs` are its known directories (full paths,
+    // e.g. from FileIndex::dirPath); watchers that need one watch per
+    // directory use them instead of walking the tree. Returns false (see
+    // error()) if the root cannot be watched.
+    virtual bool start(const std::string& root, const std::vector<std::string>& dirs,
+                       ChangeFn onChange) = 0;
+
+    // Stop the watcher thread; no callback runs after it returns.
+    virtual void stop() = 0;
+
+    const std::string& error() const { return error_; }
+
+protected:
+    std::string error_;
+};
+
+#endif // FILEWATCHER_H
@@ -0,0 +1,68 @@
+#include "GlobPattern.h"
+
+GlobPattern::GlobPattern(std::string_view pattern)
+    : pattern_(pattern)
+{
+    Segment current;
+    for (char c : pattern) {
+        if (c == '*') {
+            // Runs of '*' are one '*': drop the empty segments between them.
+            if (!hasStar_ || !current.text.empty()) segments_.push_back(std::move(current));
+            current = Segment();
+            hasStar_ = true;
+            continue;
+        }
+        if (c == '?') {
+            current.hasQuestion = true;
+            hasQuestion_ = true;
+        }
+        current.text += c;
+    }
+    segments_.push_back(std::move(current));
+
+    for (const auto& seg : segments_) minLength_ += seg.text.size();
+
+    const std::string& first = segments_.front().text;
+    prefix_ = first.substr(0, first.find('?'));
+    const std::string& last = segments_.back().text;
+    size_t q = last.rfind('?');
+    suffix_ = q == std::string::npos ? last : last.substr(q + 1);
+}
+
+bool GlobPattern::matchAt(const Segment& seg, std::string_view name, size_t pos)
+{
+    if (!seg.hasQuestion) return name.compare(pos, seg.text.size(), seg.text) == 0;
+    for (size_t i = 0; i < seg.text.size(); ++i) {
+        if (seg.text[i] != '?' && seg.text[i] != name[pos + i]) return false;
+    }
+    return true;
+}
+
+size_t GlobPattern::find(const Segment& seg, std::string_view name, size_t from, size_t end)
+{
+    if (!seg.hasQuestion) return name.substr(0, end).find(seg.text, from);
+    for (size_t pos = from; pos + seg.text.size() <= end; ++pos) {
+        if (matchAt(seg, name, pos)) return pos;
+    }
+    return std::string_view::npos;
+}
+
+bool GlobPattern::matches(std::string_view name) const
+{
+    const Segment& first = segments_.front();
+    if (!hasStar_) return name.size() == first.text.size() && matchAt(first, name, 0);
+    if (name.size() < minLength_) return false;
+
+    const Segment& last = segments_.back();
+    size_t end = name.size() - last.text.size();
+    if (!matchAt(first, name, 0) || !matchAt(last, name, end)) return false;
+
+    size_t pos = first.text.size();
+    for (size_t i = 1; i + 1 < segments_.size(); ++i) {
+        const Segment& seg = segments_[i];
+        size_t found = find(seg, name, pos, end);
+        if (found == std::string_view::npos) return false;
+        pos = found + seg.text.size();
+    }
+    return true;
+}
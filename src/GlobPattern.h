@@ -0,0 +1,52 @@
+#pragma once
+#ifndef GLOBPATTERN_H
+#define GLOBPATTERN_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A file-name wildcard pattern ('*' = any run, '?' = any one byte; every
+// other byte, including '[', is literal), compiled once and matched without
+// backtracking.
+//
+// The pattern is split at '*' into segments. The first segment is anchored
+// at the start of the name, the last at the end, and the ones in between are
+// found left to right with the earliest match each; for '*'/'?' globs the
+// earliest placement never rules out a match, so one pass decides. Matching
+// is bytewise: both pattern and name are expected to be case-folded the same
+// way.
+//
+// literalPrefix()/literalSuffix() are the fixed leading and trailing bytes
+// every match must have; FileIndex uses them to narrow the candidates before
+// calling matches().
+class GlobPattern {
+public:
+    explicit GlobPattern(std::string_view pattern);
+
+    bool matches(std::string_view name) const;
+
+    const std::string& pattern() const { return pattern_; }
+    bool hasWildcard() const { return hasStar_ || hasQuestion_; }
+    std::string_view literalPrefix() const { return prefix_; }
+    std::string_view literalSuffix() const { return suffix_; }
+
+private:
+    struct Segment {
+        std::string text;
+        bool hasQuestion = false;
+    };
+
+    static bool matchAt(const Segment& seg, std::string_view name, size_t pos);
+    static size_t find(const Segment& seg, std::string_view name, size_t from, size_t end);
+
+    std::string pattern_;
+    std::vector<Segment> segments_;  // split at '*'; first/last may be empty
+    size_t minLength_ = 0;           // sum of the segment lengths
+    bool hasStar_ = false;
+    bool hasQuestion_ = false;
+    std::string prefix_;
+    std::string suffix_;
+};
+
+#endif // GLOBPATTERN_H
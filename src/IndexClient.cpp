@@ -0,0 +1,144 @@
+#include "IndexClient.h"
+
+using namespace IndexProtocol;
+
+IndexClient::IndexClient(std::unique_ptr<Connection> connection)
+    : connection_(std::move(connection))
+{
+}
+
+std::unique_ptr<IndexClient> IndexClient::connect(const std::string& endpoint, std::chrono::milliseconds timeout)
+{
+    std::unique_ptr<Connection> connection = Connection::connect(endpoint, timeout);
+    if (!connection) return nullptr;
+    std::unique_ptr<IndexClient> client(new IndexClient(std::move(connection)));
+
+    std::string reply;
+    if (!client->call(Writer(Hello).u32(kVersion).payload(), HelloReply, reply)) return nullptr;
+    Reader r(reply);
+    r.type();
+    if (r.u32() != kVersion) return nullptr;
+    return client;
+}
+
+bool IndexClient::receive(std::string& reply)
+{
+    if (connection_->receive(reply)) return true;
+    connected_ = false;
+    error_ = "index service connection lost or timed out";
+    return false;
+}
+
+bool IndexClient::call(const std::string& request, Type expected, std::string& reply)
+{
+    if (!connected_) return false;
+    if (!connection_->send(request)) {
+        connected_ = false;
+        error_ = "index service connection lost";
+        return false;
+    }
+    if (!receive(reply)) return false;
+
+    Reader r(reply);
+    uint8_t type = r.type();
+    if (type == expected) return true;
+    if (type == Error) {
+        error_ = r.str();
+        return false;
+    }
+    // Out of step with the service: the connection is of no further use.
+    connection_->shutdown();
+    connected_ = false;
+    error_ = "unexpected reply from index service";
+    return false;
+}
+
+bool IndexClient::readPaths(const std::string& reply, std::vector<std::string>& paths)
+{
+    Reader r(reply);
+    r.type();
+    uint32_t n = r.u32();
+    paths.clear();
+    for (uint32_t i = 0; r.ok() && i < n; ++i) paths.push_back(r.str());
+    if (r.ok()) return true;
+    error_ = "malformed reply from index service";
+    return false;
+}
+
+bool IndexClient::index(const std::string& root, const ProgressFn& progress, uint64_t& files)
+{
+    if (!connected_) return false;
+    if (!connection_->send(Writer(Index).str(root).payload())) {
+        connected_ = false;
+        error_ = "index service connection lost";
+        return false;
+    }
+    std::string reply;
+    size_t count = 0;
+    for (;;) {
+        // Wait in short steps so the caller can cancel while the service
+        // walks (or waits for another client's walk of the same root).
+        bool ready = connection_->readable(std::chrono::milliseconds(250));
+        if (!ready && !connection_->failed()) {
+            if (progress && !progress(count)) {
+                connection_->shutdown();
+                connected_ = false;
+                error_ = "cancelled";
+                return false;
+            }
+            continue;
+        }
+        if (!receive(reply)) return false;
+        Reader r(reply);
+        uint8_t type = r.type();
+        if (type == Progress) {
+            count = (size_t)r.u64();
+            if (progress && !progress(count)) {
+                // The service notices the dropped connection and stops.
+                connection_->shutdown();
+                connected_ = false;
+                error_ = "cancelled";
+                return false;
+            }
+        } else if (type == Indexed) {
+            files = r.u64();
+            return r.ok();
+        } else if (type == Error) {
+            error_ = r.str();
+            return false;
+        } else {
+            connection_->shutdown();
+            connected_ = false;
+            error_ = "unexpected reply from index service";
+            return false;
+        }
+    }
+}
+
+bool IndexClient::find(const std::string& root, const std::string& name, std::vector<std::string>& paths)
+{
+    std::string reply;
+    return call(Writer(Find).str(root).str(name).payload(), Paths, reply) && readPaths(reply, paths);
+}
+
+bool IndexClient::match(const std::string& root, const std::string& pattern, std::vector<std::string>& paths)
+{
+    std::string reply;
+    return call(Writer(Match).str(root).str(pattern).payload(), Paths, reply) && readPaths(reply, paths);
+}
+
+bool IndexClient::bestMatch(const std::vector<std::string>& roots, const std::vector<AutoMatcher::Query>& queries,
+                            std::vector<std::string>& results)
+{
+    Writer request(BestMatch);
+    request.u32((uint32_t)roots.size());
+    for (const auto& root : roots) request.str(root);
+    request.u32((uint32_t)queries.size());
+    for (const auto& q : queries) request.query(q);
+
+    std::string reply;
+    if (!call(request.payload(), Paths, reply) || !readPaths(reply, results)) return false;
+    if (results.size() == queries.size()) return true;
+    error_ = "malformed reply from index service";
+    return false;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef INDEXCLIENT_H
+#define INDEXCLIENT_H
+
+#include "AutoMatcher.h"
+#include "IndexProtocol.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Client of the shared file-index service (IndexServer). Each call is one
+// request on a connection that stays open. A call fails when the service
+// answers with an error (see error()), the connection is lost or the
+// service does not answer within the timeout; after a lost or timed-out
+// connection connected() is false and the caller falls back to its own
+// in-process FileIndex. Not thread-safe: use one client per thread.
+class IndexClient {
+public:
+    // Called with the number of files indexed so far; return false to
+    // cancel (the connection is dropped, which cancels the walk).
+    using ProgressFn = std::function<bool(size_t files)>;
+
+    // A client for the service at `endpoint`, or nullptr if none is running,
+    // it does not answer within `timeout` or speaks another protocol version.
+    static std::unique_ptr<IndexClient> connect(const std::string& endpoint = IndexProtocol::defaultEndpoint(),
+                                                std::chrono::milliseconds timeout = std::chrono::seconds(15));
+
+    // Have the service index `root` (walking it the first time, cheap
+    // afterwards) and keep it current; `files` is its file count. The walk
+    // (or another client's walk of the same root) may take longer than the
+    // timeout: while no frame arrives `progress` is called again with the
+    // last count every 250 ms, and returning false cancels.
+    bool index(const std::string& root, const ProgressFn& progress, uint64_t& files);
+
+    // FileIndex::find / match on an indexed root; keys are case-folded.
+    bool find(const std::string& root, const std::string& name, std::vector<std::string>& paths);
+    bool match(const std::string& root, const std::string& pattern, std::vector<std::string>& paths);
+
+    // AutoMatcher::matchAll over the indexed roots; results[i] is "" when
+    // queries[i] has no candidate.
+    bool bestMatch(const std::vector<std::string>& roots, const std::vector<AutoMatcher::Query>& queries,
+                   std::vector<std::string>& results);
+
+    bool connected() const { return connected_; }
+    const std::string& error() const { return error_; }
+
+private:
+    explicit IndexClient(std::unique_ptr<IndexProtocol::Connection> connection);
+
+    // Send a request and read its reply, which must be of type `expected`;
+    // false on transport failure or an Error reply.
+    bool call(const std::string& request, IndexProtocol::Type expected, std::string& reply);
+    bool receive(std::string& reply);
+    bool readPaths(const std::string& reply, std::vector<std::string>& paths);
+
+    std::unique_ptr<IndexProtocol::Connection> connection_;
+    bool connected_ = true;
+    std::string error_;
+};
+
+#endif // INDEXCLIENT_H
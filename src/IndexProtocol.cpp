@@ -0,0 +1,500 @@
+#include "IndexProtocol.h"
+#include "FileIndex.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace IndexProtocol {
+
+namespace {
+
+#ifdef _WIN32
+std::wstring utf8ToWide(const std::string& s)
+{
+    if (s.empty()) return {};
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
+    if (len <= 0) return {};
+    std::wstring w(len, 0);
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &w[0], len);
+    return w;
+}
+#else
+bool socketAddress(const std::string& endpoint, sockaddr_un& addr)
+{
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (endpoint.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, endpoint.c_str(), endpoint.size());
+    return true;
+}
+#endif
+
+} // namespace
+
+std::string defaultEndpoint()
+{
+#ifdef _WIN32
+    const char* user = std::getenv("USERNAME");
+    return std::string("\\\\.\\pipe\\MayaRefCheckerIndex-") + (user && *user ? user : "default");
+#else
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime && *runtime) return (fs::u8path(runtime) / "maya-ref-checker-index.sock").generic_u8string();
+    return (fs::u8path(FileIndex::cacheDirectory()) / "index.sock").generic_u8string();
+#endif
+}
+
+// ---- Writer / Reader ----
+
+Writer& Writer::u32(uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) buf_ += (char)((v >> (8 * i)) & 0xFF);
+    return *this;
+}
+
+Writer& Writer::u64(uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) buf_ += (char)((v >> (8 * i)) & 0xFF);
+    return *this;
+}
+
+Writer& Writer::str(const std::string& s)
+{
+    u32((uint32_t)s.size());
+    buf_ += s;
+    return *this;
+}
+
+Writer& Writer::query(const AutoMatcher::Query& q)
+{
+    str(q.originalPath);
+    u32((uint32_t)q.sequenceKeys.size());
+    for (const auto& k : q.sequenceKeys) str(k);
+    u32((uint32_t)q.keys.size());
+    for (const auto& k : q.keys) {
+        str(k.text);
+        buf_ += (char)(k.wildcard ? 1 : 0);
+    }
+    u64(q.expectedSize);
+    u64(q.expectedFingerprint);
+    return *this;
+}
+
+uint64_t Reader::get(int bytes)
+{
+    if (!ok_ || end_ - p_ < bytes) {
+        ok_ = false;
+        return 0;
+    }
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= (uint64_t)(unsigned char)p_[i] << (8 * i);
+    p_ += bytes;
+    return v;
+}
+
+uint8_t Reader::type() { return (uint8_t)get(1); }
+uint32_t Reader::u32() { return (uint32_t)get(4); }
+uint64_t Reader::u64() { return get(8); }
+
+std::string Reader::str()
+{
+    uint64_t n = get(4);
+    if (!ok_ || (uint64_t)(end_ - p_) < n) {
+        ok_ = false;
+        return std::string();
+    }
+    std::string s(p_, (size_t)n);
+    p_ += n;
+    return s;
+}
+
+AutoMatcher::Query Reader::query()
+{
+    AutoMatcher::Query q;
+    q.originalPath = str();
+    uint32_t n = u32();
+    for (uint32_t i = 0; ok_ && i < n; ++i) q.sequenceKeys.push_back(str());
+    n = u32();
+    for (uint32_t i = 0; ok_ && i < n; ++i) {
+        AutoMatcher::Key k;
+        k.text = str();
+        k.wildcard = get(1) != 0;
+        q.keys.push_back(std::move(k));
+    }
+    q.expectedSize = u64();
+    q.expectedFingerprint = u64();
+    return q;
+}
+
+// ---- Connection ----
+
+bool Connection::send(const std::string& payload)
+{
+    if (failed_ || payload.size() > kMaxFrame) return false;
+    char header[4];
+    for (int i = 0; i < 4; ++i) header[i] = (char)((payload.size() >> (8 * i)) & 0xFF);
+    if (!writeAll(header, 4) || !writeAll(payload.data(), payload.size())) {
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool Connection::receive(std::string& payload)
+{
+    if (failed_) return false;
+    unsigned char header[4];
+    if (!readAll(reinterpret_cast<char*>(header), 4)) {
+        failed_ = true;
+        return false;
+    }
+    uint32_t n = header[0] | (header[1] << 8) | (header[2] << 16) | ((uint32_t)header[3] << 24);
+    if (n == 0 || n > kMaxFrame) {
+        failed_ = true;
+        return false;
+    }
+    payload.resize(n);
+    if (!readAll(&payload[0], n)) {
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+Connection::~Connection()
+{
+    if (handle_) CloseHandle(handle_);
+    if (event_) CloseHandle(event_);
+}
+
+std::unique_ptr<Connection> Connection::connect(const std::string& endpoint, std::chrono::milliseconds timeout)
+{
+    std::wstring name = utf8ToWide(endpoint);
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        // Overlapped, so a read or write can be abandoned after the timeout.
+        HANDLE h = CreateFileW(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                               FILE_FLAG_OVERLAPPED, nullptr);
+        if (h != INVALID_HANDLE_VALUE) {
+            std::unique_ptr<Connection> conn(new Connection());
+            conn->handle_ = h;
+            conn->event_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+            conn->timeoutMs_ = timeout.count() > 0 ? (unsigned long)timeout.count() : INFINITE;
+            if (!conn->event_) return nullptr;
+            return conn;
+        }
+        // Every instance busy: the server creates the next one right after
+        // accepting, so a short wait is enough.
+        if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeW(name.c_str(), 2000)) break;
+    }
+    return nullptr;
+}
+
+namespace {
+
+// One ReadFile/WriteFile; on an overlapped handle it waits at most
+// `timeoutMs` and cancels the operation if it has not completed.
+bool transfer(HANDLE handle, HANDLE event, unsigned long timeoutMs, bool write, char* data, DWORD n, DWORD& done)
+{
+    done = 0;
+    if (!event) {
+        BOOL ok = write ? WriteFile(handle, data, n, &done, nullptr) : ReadFile(handle, data, n, &done, nullptr);
+        return ok && done > 0;
+    }
+    OVERLAPPED ov = {};
+    ov.hEvent = event;
+    ResetEvent(event);
+    BOOL ok = write ? WriteFile(handle, data, n, nullptr, &ov) : ReadFile(handle, data, n, nullptr, &ov);
+    if (!ok && GetLastError() != ERROR_IO_PENDING) return false;
+    if (WaitForSingleObject(event, timeoutMs) != WAIT_OBJECT_0) {
+        CancelIoEx(handle, &ov);
+        GetOverlappedResult(handle, &ov, &done, TRUE);
+        return false;
+    }
+    return GetOverlappedResult(handle, &ov, &done, FALSE) && done > 0;
+}
+
+} // namespace
+
+bool Connection::readAll(char* data, size_t n)
+{
+    while (n > 0) {
+        DWORD got = 0;
+        if (!transfer(handle_, event_, timeoutMs_, false, data, (DWORD)std::min<size_t>(n, 1 << 20), got)) return false;
+        data += got;
+        n -= got;
+    }
+    return true;
+}
+
+bool Connection::writeAll(const char* data, size_t n)
+{
+    while (n > 0) {
+        DWORD put = 0;
+        if (!transfer(handle_, event_, timeoutMs_, true, const_cast<char*>(data), (DWORD)std::min<size_t>(n, 1 << 20),
+                      put)) {
+            return false;
+        }
+        data += put;
+        n -= put;
+    }
+    return true;
+}
+
+bool Connection::readable(std::chrono::milliseconds wait)
+{
+    if (failed_) return false;
+    const auto until = std::chrono::steady_clock::now() + wait;
+    for (;;) {
+        DWORD available = 0;
+        if (!PeekNamedPipe(handle_, nullptr, 0, nullptr, &available, nullptr)) {
+            failed_ = true;
+            return false;
+        }
+        if (available > 0) return true;
+        if (std::chrono::steady_clock::now() >= until) return false;
+        Sleep(20);
+    }
+}
+
+void Connection::shutdown()
+{
+    failed_ = true;
+    if (!handle_) return;
+    CancelIoEx(handle_, nullptr);
+    DisconnectNamedPipe(handle_);  // server side: fails the client's pending read too
+}
+
+// ---- Listener (named pipe) ----
+
+namespace {
+
+HANDLE createInstance(const std::wstring& name, bool first)
+{
+    DWORD openMode = PIPE_ACCESS_DUPLEX | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+    return CreateNamedPipeW(name.c_str(), openMode,
+                            PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                            PIPE_UNLIMITED_INSTANCES, 64 * 1024, 64 * 1024, 0, nullptr);
+}
+
+} // namespace
+
+Listener::~Listener()
+{
+    close();
+    if (pending_) CloseHandle((HANDLE)pending_);
+}
+
+bool Listener::listen(const std::string& endpoint)
+{
+    endpoint_ = endpoint;
+    closed_ = false;
+    HANDLE h = createInstance(utf8ToWide(endpoint), true);
+    if (h == INVALID_HANDLE_VALUE) {
+        error_ = GetLastError() == ERROR_ACCESS_DENIED ? "another index service is running on " + endpoint
+                                                       : "cannot create pipe " + endpoint;
+        return false;
+    }
+    pending_ = h;
+    return true;
+}
+
+std::unique_ptr<Connection> Listener::accept()
+{
+    if (closed_ || !pending_) return nullptr;
+    HANDLE h = (HANDLE)pending_;
+    bool ok = ConnectNamedPipe(h, nullptr) || GetLastError() == ERROR_PIPE_CONNECTED;
+    if (closed_) return nullptr;
+    HANDLE next = createInstance(utf8ToWide(endpoint_), false);
+    pending_ = next == INVALID_HANDLE_VALUE ? nullptr : next;
+    if (!ok) {
+        CloseHandle(h);
+        return nullptr;
+    }
+    std::unique_ptr<Connection> conn(new Connection());
+    conn->handle_ = h;
+    return conn;
+}
+
+void Listener::close()
+{
+    if (closed_) return;
+    closed_ = true;
+    if (pending_) {
+        // ConnectNamedPipe only returns when a client arrives: be that client.
+        HANDLE self = CreateFileW(utf8ToWide(endpoint_).c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                                  OPEN_EXISTING, 0, nullptr);
+        if (self != INVALID_HANDLE_VALUE) CloseHandle(self);
+    }
+}
+
+#else
+
+Connection::~Connection()
+{
+    if (fd_ >= 0) ::close(fd_);
+}
+
+std::unique_ptr<Connection> Connection::connect(const std::string& endpoint, std::chrono::milliseconds timeout)
+{
+    sockaddr_un addr;
+    if (!socketAddress(endpoint, addr)) return nullptr;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return nullptr;
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    if (timeout.count() > 0) {
+        // recv()/send() then fail with EAGAIN, which readAll/writeAll treat
+        // like any other error.
+        timeval tv;
+        tv.tv_sec = (time_t)(timeout.count() / 1000);
+        tv.tv_usec = (suseconds_t)(timeout.count() % 1000) * 1000;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+    std::unique_ptr<Connection> conn(new Connection());
+    conn->fd_ = fd;
+    return conn;
+}
+
+bool Connection::readAll(char* data, size_t n)
+{
+    while (n > 0) {
+        ssize_t got = ::recv(fd_, data, n, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        data += got;
+        n -= (size_t)got;
+    }
+    return true;
+}
+
+bool Connection::writeAll(const char* data, size_t n)
+{
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;  // a vanished peer is an error, not SIGPIPE
+#else
+    const int flags = 0;
+#endif
+    while (n > 0) {
+        ssize_t put = ::send(fd_, data, n, flags);
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        data += put;
+        n -= (size_t)put;
+    }
+    return true;
+}
+
+bool Connection::readable(std::chrono::milliseconds wait)
+{
+    if (failed_) return false;
+    pollfd p = {fd_, POLLIN, 0};
+    int ready;
+    do {
+        ready = ::poll(&p, 1, (int)wait.count());
+    } while (ready < 0 && errno == EINTR);
+    if (ready < 0) failed_ = true;
+    // POLLHUP/POLLERR count as readable: the receive() that follows fails.
+    return ready > 0;
+}
+
+void Connection::shutdown()
+{
+    failed_ = true;
+    if (fd_ >= 0) ::shutdown(fd_, SHUT_RDWR);
+}
+
+// ---- Listener (Unix domain socket) ----
+
+Listener::~Listener()
+{
+    close();
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool Listener::listen(const std::string& endpoint)
+{
+    endpoint_ = endpoint;
+    closed_ = false;
+    sockaddr_un addr;
+    if (!socketAddress(endpoint, addr)) {
+        error_ = "socket path too long: " + endpoint;
+        return false;
+    }
+    if (Connection::connect(endpoint)) {
+        error_ = "another index service is running on " + endpoint;
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(fs::u8path(endpoint).parent_path(), ec);
+    ::unlink(endpoint.c_str());  // left behind by a service that did not stop cleanly
+
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    ::fcntl(fd_, F_SETFD, FD_CLOEXEC);
+    // Owner-only from the start, so other users never get to connect.
+    mode_t old = ::umask(0177);
+    int bound = ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::umask(old);
+    if (bound != 0 || ::listen(fd_, 16) != 0) {
+        error_ = "cannot listen on " + endpoint + ": " + std::strerror(errno);
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Connection> Listener::accept()
+{
+    for (;;) {
+        if (closed_ || fd_ < 0) return nullptr;
+        int fd = ::accept(fd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return nullptr;
+        }
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        std::unique_ptr<Connection> conn(new Connection());
+        conn->fd_ = fd;
+        return conn;
+    }
+}
+
+void Listener::close()
+{
+    if (closed_) return;
+    closed_ = true;
+    if (fd_ >= 0) {
+        ::shutdown(fd_, SHUT_RDWR);  // wakes a blocked accept()
+        ::unlink(endpoint_.c_str());
+    }
+}
+
+#endif
+
+} // namespace IndexProtocol
@@ -0,0 +1,153 @@
+#pragma once
+#ifndef INDEXPROTOCOL_H
+#define INDEXPROTOCOL_H
+
+#include "AutoMatcher.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Transport and wire format of the shared file-index service
+// (mayaIndexService / IndexServer, IndexClient).
+//
+// A connection is a per-user Unix domain socket (named pipe on Windows) and
+// carries any number of request/response exchanges. Every message is a
+// frame: u32 payload length, then the payload, which starts with a u8
+// message type. Integers are little-endian; a string is a u32 byte length
+// plus UTF-8 bytes.
+namespace IndexProtocol {
+
+const uint32_t kVersion = 1;
+const uint32_t kMaxFrame = 512u * 1024 * 1024;
+
+enum Type : uint8_t {
+    // Requests
+    Hello = 1,      // u32 version                        -> HelloReply
+    Index = 2,      // str root                           -> Progress..., Indexed
+    Find = 3,       // str root, str folded name          -> Paths
+    Match = 4,      // str root, str folded pattern       -> Paths
+    BestMatch = 5,  // u32 n, n x str root, u32 m, m x query -> Paths (m, "" = none)
+
+    // Responses
+    HelloReply = 64,  // u32 version
+    Progress = 65,    // u64 files indexed so far
+    Indexed = 66,     // u64 files
+    Paths = 67,       // u32 n, n x str
+    Error = 127,      // str message
+};
+
+// Where the service listens: $XDG_RUNTIME_DIR/maya-ref-checker-index.sock
+// (else FileIndex::cacheDirectory()/index.sock), or
+// \\.\pipe\MayaRefCheckerIndex-<user> on Windows.
+std::string defaultEndpoint();
+
+// Payload builder.
+class Writer {
+public:
+    explicit Writer(Type type) { buf_ += (char)type; }
+    Writer& u32(uint32_t v);
+    Writer& u64(uint64_t v);
+    Writer& str(const std::string& s);
+    Writer& query(const AutoMatcher::Query& q);
+    const std::string& payload() const { return buf_; }
+
+private:
+    std::string buf_;
+};
+
+// Bounds-checked payload reader; any overrun clears ok().
+class Reader {
+public:
+    explicit Reader(const std::string& payload) : p_(payload.data()), end_(payload.data() + payload.size()) {}
+    uint8_t type();
+    uint32_t u32();
+    uint64_t u64();
+    std::string str();
+    AutoMatcher::Query query();
+    bool ok() const { return ok_; }
+
+private:
+    uint64_t get(int bytes);
+    const char* p_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+// One connected stream. send()/receive() move whole frames; after any
+// failure every later call fails too.
+class Connection {
+public:
+    ~Connection();
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    // Connect to a running service; nullptr if there is none. Every send()
+    // and receive() on the connection fails once it has waited `timeout`
+    // for the peer (zero: wait indefinitely).
+    static std::unique_ptr<Connection> connect(const std::string& endpoint,
+                                               std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    bool send(const std::string& payload);
+    bool receive(std::string& payload);
+
+    // Whether data for receive() arrives within `wait`; false on timeout
+    // and on a failed connection (see failed()).
+    bool readable(std::chrono::milliseconds wait);
+    bool failed() const { return failed_; }
+
+    // Make a receive() blocked on another thread (and every later call)
+    // fail; the handle is released by the destructor.
+    void shutdown();
+
+private:
+    friend class Listener;
+    Connection() = default;
+    bool readAll(char* data, size_t n);
+    bool writeAll(const char* data, size_t n);
+
+    bool failed_ = false;
+
+#ifdef _WIN32
+    void* handle_ = nullptr;
+    void* event_ = nullptr;  // overlapped I/O (client connections only)
+    unsigned long timeoutMs_ = 0;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// Server side of the endpoint.
+class Listener {
+public:
+    ~Listener();
+
+    // Fails (see error()) if another service already owns the endpoint. A
+    // stale socket left by a crashed service is replaced.
+    bool listen(const std::string& endpoint);
+
+    // Next client; nullptr once close() was called or on error.
+    std::unique_ptr<Connection> accept();
+
+    // Unblock accept() and stop listening.
+    void close();
+
+    const std::string& error() const { return error_; }
+
+private:
+    std::string endpoint_;
+    std::string error_;
+    bool closed_ = false;
+#ifdef _WIN32
+    void* pending_ = nullptr;  // pipe instance waiting for the next client
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace IndexProtocol
+
+#endif // INDEXPROTOCOL_H
@@ -0,0 +1,235 @@
+#include "IndexServer.h"
+#include "GlobPattern.h"
+
+using namespace IndexProtocol;
+
+IndexServer::~IndexServer()
+{
+    stop();
+}
+
+bool IndexServer::start(const std::string& endpoint)
+{
+    stopping_ = false;
+    if (!listener_.listen(endpoint)) {
+        error_ = listener_.error();
+        return false;
+    }
+    acceptThread_ = std::thread([this]() { acceptLoop(); });
+    return true;
+}
+
+void IndexServer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    listener_.close();
+    if (acceptThread_.joinable()) acceptThread_.join();
+
+    // A client in the middle of an Index request is cancelled by its
+    // progress frames failing to send.
+    std::vector<std::unique_ptr<Client>> clients;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        clients.swap(clients_);
+    }
+    for (auto& c : clients) c->connection->shutdown();
+    for (auto& c : clients) {
+        if (c->thread.joinable()) c->thread.join();
+    }
+
+    std::map<std::string, std::shared_ptr<Root>> roots;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        roots.swap(roots_);
+    }
+    for (auto& kv : roots) {
+        if (kv.second->live) kv.second->live->stop();
+    }
+    std::lock_guard<std::mutex> lock(matcherMutex_);
+    matchers_.clear();
+}
+
+size_t IndexServer::rootCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return roots_.size();
+}
+
+void IndexServer::acceptLoop()
+{
+    for (;;) {
+        std::unique_ptr<Connection> connection = listener_.accept();
+        if (!connection) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;
+        // Reap clients that have disconnected.
+        for (size_t i = 0; i < clients_.size();) {
+            if (clients_[i]->done) {
+                clients_[i]->thread.join();
+                clients_.erase(clients_.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+        auto client = std::make_unique<Client>();
+        client->connection = std::move(connection);
+        Client* raw = client.get();
+        clients_.push_back(std::move(client));
+        raw->thread = std::thread([this, raw]() { serve(raw); });
+    }
+}
+
+void IndexServer::serve(Client* client)
+{
+    Connection& connection = *client->connection;
+    std::string request;
+    while (connection.receive(request)) {
+        if (!connection.send(handle(request, connection))) break;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    client->done = true;
+}
+
+std::string IndexServer::handle(const std::string& request, Connection& connection)
+{
+    Reader r(request);
+    uint8_t type = r.type();
+    switch (type) {
+    case Hello:
+        r.u32();
+        return Writer(HelloReply).u32(kVersion).payload();
+
+    case Index: {
+        std::string root = r.str();
+        if (!r.ok()) break;
+        return indexRoot(root, connection);
+    }
+
+    case Find:
+    case Match: {
+        std::string root = r.str();
+        std::string key = r.str();
+        if (!r.ok()) break;
+        std::shared_ptr<FileIndex> index = currentIndex(root);
+        if (!index) return Writer(Error).str("not indexed: " + root).payload();
+        std::vector<std::string> paths;
+        if (type == Find) {
+            index->find(key, paths);
+        } else {
+            index->match(GlobPattern(key), paths);
+        }
+        Writer reply(Paths);
+        reply.u32((uint32_t)paths.size());
+        for (const auto& p : paths) reply.str(p);
+        return reply.payload();
+    }
+
+    case BestMatch: {
+        std::vector<std::string> roots;
+        uint32_t rootCount = r.u32();
+        for (uint32_t i = 0; r.ok() && i < rootCount; ++i) roots.push_back(r.str());
+        uint32_t count = r.u32();
+        std::vector<AutoMatcher::Query> queries;
+        for (uint32_t i = 0; r.ok() && i < count; ++i) queries.push_back(r.query());
+        if (!r.ok()) break;
+
+        std::string error;
+        std::shared_ptr<AutoMatcher> matcher = matcherFor(roots, error);
+        if (!matcher) return Writer(Error).str(error).payload();
+        std::vector<std::string> results = matcher->matchAll(queries);
+        Writer reply(Paths);
+        reply.u32((uint32_t)results.size());
+        for (const auto& p : results) reply.str(p);
+        return reply.payload();
+    }
+
+    default:
+        return Writer(Error).str("unknown request " + std::to_string(type)).payload();
+    }
+    return Writer(Error).str("malformed request").payload();
+}
+
+std::string IndexServer::indexRoot(const std::string& root, Connection& connection)
+{
+    std::shared_ptr<Root> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<Root>& slot = roots_[rootKey(root)];
+        if (!slot) slot = std::make_shared<Root>();
+        entry = slot;
+    }
+
+    std::lock_guard<std::mutex> build(entry->buildMutex);
+    if (!entry->live) {
+        // First request, or no watcher on this platform: update() walks the
+        // root once and afterwards only compares directory mtimes.
+        std::string indexPath = FileIndex::defaultIndexPath(root);
+        auto index = std::make_shared<FileIndex>();
+        auto progress = [&connection](size_t files) {
+            return connection.send(Writer(Progress).u64(files).payload());
+        };
+        if (!index->update(root, indexPath, progress)) {
+            return Writer(Error).str("cannot index " + root + ": " + index->error()).payload();
+        }
+        auto live = std::make_unique<LiveFileIndex>(index, indexPath);
+        bool watching = live->start();
+        std::lock_guard<std::mutex> publish(entry->publishMutex);
+        entry->index = index;
+        if (watching) entry->live = std::move(live);
+    }
+    std::shared_ptr<FileIndex> index = entry->live ? entry->live->current() : entry->index;
+    return Writer(Indexed).u64(index->size()).payload();
+}
+
+std::shared_ptr<FileIndex> IndexServer::currentIndex(const std::string& root) const
+{
+    std::shared_ptr<Root> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = roots_.find(rootKey(root));
+        if (it == roots_.end()) return nullptr;
+        entry = it->second;
+    }
+    // Not buildMutex: Find/Match/BestMatch must not wait for a walk of the
+    // root; while the first one runs the root is simply not indexed yet.
+    std::lock_guard<std::mutex> publish(entry->publishMutex);
+    return entry->live ? entry->live->current() : entry->index;
+}
+
+std::shared_ptr<AutoMatcher> IndexServer::matcherFor(const std::vector<std::string>& roots, std::string& error)
+{
+    std::vector<std::shared_ptr<FileIndex>> indexes;
+    std::string key;
+    for (const auto& root : roots) {
+        std::shared_ptr<FileIndex> index = currentIndex(root);
+        if (!index) {
+            error = "not indexed: " + root;
+            return nullptr;
+        }
+        indexes.push_back(std::move(index));
+        key += rootKey(root) + "\n";
+    }
+
+    // A root that changed has a new FileIndex object: rebuild the trie.
+    std::lock_guard<std::mutex> lock(matcherMutex_);
+    MatcherEntry& entry = matchers_[key];
+    if (!entry.matcher || entry.indexes != indexes) {
+        entry.indexes = indexes;
+        entry.matcher = std::make_shared<AutoMatcher>(indexes);
+    }
+    return entry.matcher;
+}
+
+std::string IndexServer::rootKey(const std::string& root)
+{
+    std::string key = root;
+    for (auto& c : key) {
+        if (c == '\\') c = '/';
+    }
+    while (key.size() > 1 && key.back() == '/') key.pop_back();
+    return FileIndex::foldCase(key);
+}
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef INDEXSERVER_H
+#define INDEXSERVER_H
+
+#include "AutoMatcher.h"
+#include "FileIndex.h"
+#include "IndexProtocol.h"
+#include "LiveFileIndex.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The shared file-index service behind mayaIndexService. It owns one
+// persistent FileIndex per search root, kept current by a LiveFileIndex, and
+// answers IndexProtocol requests from any number of Maya sessions (one
+// thread per connection), so a workstation walks and holds each library
+// once however many sessions use it. Best-match requests run AutoMatcher
+// here; its directory trie is built once per set of roots and rebuilt when
+// one of them changes.
+class IndexServer {
+public:
+    IndexServer() = default;
+    ~IndexServer();
+
+    IndexServer(const IndexServer&) = delete;
+    IndexServer& operator=(const IndexServer&) = delete;
+
+    // Listen on `endpoint` and serve on background threads. False (see
+    // error()) if the endpoint is taken.
+    bool start(const std::string& endpoint = IndexProtocol::defaultEndpoint());
+
+    // Disconnect every client, stop watching and join all threads.
+    void stop();
+
+    const std::string& error() const { return error_; }
+    size_t rootCount() const;
+
+private:
+    struct Root {
+        std::mutex buildMutex;              // one walk per root at a time
+        // Guards index and live, which are set once the first walk is done;
+        // readers never wait for a walk.
+        std::mutex publishMutex;
+        std::shared_ptr<FileIndex> index;   // when not watched
+        std::unique_ptr<LiveFileIndex> live;
+    };
+
+    struct Client {
+        std::unique_ptr<IndexProtocol::Connection> connection;
+        std::thread thread;
+        bool done = false;
+    };
+
+    struct MatcherEntry {
+        std::vector<std::shared_ptr<FileIndex>> indexes;  // it was built from
+        std::shared_ptr<AutoMatcher> matcher;
+    };
+
+    void acceptLoop();
+    void serve(Client* client);
+    std::string handle(const std::string& request, IndexProtocol::Connection& connection);
+    std::string indexRoot(const std::string& root, IndexProtocol::Connection& connection);
+    std::shared_ptr<FileIndex> currentIndex(const std::string& root) const;
+    std::shared_ptr<AutoMatcher> matcherFor(const std::vector<std::string>& roots, std::string& error);
+
+    static std::string rootKey(const std::string& root);
+
+    IndexProtocol::Listener listener_;
+    std::thread acceptThread_;
+    std::string error_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Root>> roots_;  // by rootKey()
+    std::vector<std::unique_ptr<Client>> clients_;
+    bool stopping_ = false;
+
+    std::mutex matcherMutex_;
+    std::map<std::string, MatcherEntry> matchers_;  // by the roots' keys joined with '\n'
+};
+
+#endif // INDEXSERVER_H
@@ -0,0 +1,127 @@
+#include "LiveFileIndex.h"
+
+#include <chrono>
+
+LiveFileIndex::LiveFileIndex(std::shared_ptr<FileIndex> index, std::string indexPath)
+    : root_(index->root())
+    , indexPath_(std::move(indexPath))
+    , current_(std::move(index))
+{
+}
+
+LiveFileIndex::~LiveFileIndex()
+{
+    stop();
+}
+
+bool LiveFileIndex::start()
+{
+    stop();
+    stopping_ = false;
+    watcher_ = FileWatcher::create();
+    if (!watcher_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = "no file watcher on this platform";
+        return false;
+    }
+
+    std::vector<std::string> dirs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirs.reserve(current_->dirCount());
+        for (size_t d = 0; d < current_->dirCount(); ++d) dirs.push_back(current_->dirPath(d));
+    }
+    bool ok = watcher_->start(root_, dirs, [this](const std::vector<std::string>& changed, bool overflow) {
+        onChange(changed, overflow);
+    });
+    if (!ok) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = watcher_->error();
+        watcher_.reset();
+        return false;
+    }
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+void LiveFileIndex::stop()
+{
+    stopping_ = true;
+    if (watcher_) watcher_->stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_.notify_all();
+    }
+    if (thread_.joinable()) thread_.join();
+    watcher_.reset();
+}
+
+std::shared_ptr<FileIndex> LiveFileIndex::current() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+uint64_t LiveFileIndex::generation() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+std::string LiveFileIndex::error() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void LiveFileIndex::onChange(const std::vector<std::string>& dirs, bool overflow)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.insert(dirs.begin(), dirs.end());
+    overflow_ = overflow_ || overflow;
+    ++events_;
+    wake_.notify_all();
+}
+
+void LiveFileIndex::run()
+{
+    // The first pass is a full update(): it catches whatever changed between
+    // the index being built and the watches being in place.
+    bool full = true;
+    std::vector<std::string> dirs;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (!full) {
+            wake_.wait(lock, [&]() { return stopping_.load() || overflow_ || !pending_.empty(); });
+            // Let a burst (a folder copy, a render writing frames) settle,
+            // but apply at least every ten settle periods.
+            for (int i = 0; i < 10 && !stopping_; ++i) {
+                uint64_t seen = events_;
+                bool more = wake_.wait_for(lock, std::chrono::milliseconds(kSettleMs),
+                                           [&]() { return stopping_.load() || events_ != seen; });
+                if (!more) break;
+            }
+        }
+        if (stopping_) return;
+
+        full = full || overflow_;
+        dirs.assign(pending_.begin(), pending_.end());
+        pending_.clear();
+        overflow_ = false;
+        lock.unlock();
+
+        auto next = std::make_shared<FileIndex>();
+        bool ok = full ? next->update(root_, indexPath_, nullptr, &stopping_)
+                       : next->refresh(root_, indexPath_, dirs, &stopping_);
+
+        lock.lock();
+        full = false;
+        if (ok && !next->stats().unchanged) {
+            current_ = std::move(next);
+            ++generation_;
+            error_.clear();
+        } else if (!ok && !stopping_) {
+            error_ = next->error();
+        }
+    }
+}
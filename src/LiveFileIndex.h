@@ -0,0 +1,69 @@
+#pragma once
+#ifndef LIVEFILEINDEX_H
+#define LIVEFILEINDEX_H
+
+#include "FileIndex.h"
+#include "FileWatcher.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+// Keeps one root's FileIndex current during a long repair session. A
+// FileWatcher reports the directories whose entries changed; a background
+// thread waits until they settle (kSettleMs without new events) and applies
+// them with FileIndex::refresh(), which lists only those directories. Lost
+// events fall back to a full update() (one mtime check per directory, still
+// no rewalk).
+//
+// Every applied batch produces a new FileIndex: readers keep the one they
+// hold and pick up the new one from current() when they are ready.
+class LiveFileIndex {
+public:
+    static constexpr int kSettleMs = 500;
+
+    LiveFileIndex(std::shared_ptr<FileIndex> index, std::string indexPath);
+    ~LiveFileIndex();
+
+    LiveFileIndex(const LiveFileIndex&) = delete;
+    LiveFileIndex& operator=(const LiveFileIndex&) = delete;
+
+    // Start watching the index's root. Returns false (see error()) if this
+    // platform has no FileWatcher or the root cannot be watched; the index
+    // then only changes with an explicit update().
+    bool start();
+    void stop();
+
+    // The most recent index, and a counter bumped each time it changes.
+    std::shared_ptr<FileIndex> current() const;
+    uint64_t generation() const;
+
+    // Why start() failed, or the last refresh error.
+    std::string error() const;
+
+private:
+    void onChange(const std::vector<std::string>& dirs, bool overflow);
+    void run();
+
+    std::string root_;
+    std::string indexPath_;
+    std::unique_ptr<FileWatcher> watcher_;
+    std::thread thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::shared_ptr<FileIndex> current_;
+    uint64_t generation_ = 0;
+    std::set<std::string> pending_;  // changed directories not applied yet
+    bool overflow_ = false;
+    uint64_t events_ = 0;            // callbacks received, to detect settling
+    std::string error_;
+    std::atomic<bool> stopping_{false};
+};
+
+#endif // LIVEFILEINDEX_H
@@ -0,0 +1,330 @@
+#include "MaStatementScanner.h"
+
+#include <cstring>
+
+namespace {
+
+// Longest token that is still buffered. Anything longer cannot be a usable
+// path (it is typically an embedded script), so it is dropped rather than
+// kept in memory.
+const size_t kMaxTokenBytes = 32 * 1024;
+
+// Longest command word worth looking at ("createNode" is the longest we need).
+const size_t kMaxCommandBytes = 16;
+
+// A `requires` statement has a handful of arguments; more is not a header.
+const size_t kMaxRequiresArgs = 32;
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+bool equalsNoCase(const std::string& a, const char* b)
+{
+    size_t n = std::strlen(b);
+    if (a.size() != n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        char ca = a[i];
+        if (ca >= 'A' && ca <= 'Z') ca = static_cast<char>(ca - 'A' + 'a');
+        if (ca != b[i]) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void MaStatementScanner::reset()
+{
+    state_ = State::StatementStart;
+    command_ = Command::None;
+    argIndex_ = 0;
+    token_.clear();
+    tokenValid_ = true;
+    lastArg_.clear();
+    lastArgQuoted_ = false;
+    lastArgValid_ = false;
+    requiresArgs_.clear();
+}
+
+void MaStatementScanner::finish()
+{
+    // A statement without its terminating ';' is incomplete and is dropped.
+    reset();
+}
+
+void MaStatementScanner::appendTokenChar(char c)
+{
+    if (token_.size() < kMaxTokenBytes) {
+        token_ += c;
+    } else {
+        tokenValid_ = false;
+    }
+}
+
+void MaStatementScanner::beginCommand()
+{
+    command_ = Command::None;
+    argIndex_ = 0;
+    token_.clear();
+    tokenValid_ = true;
+    lastArg_.clear();
+    lastArgQuoted_ = false;
+    lastArgValid_ = false;
+    requiresArgs_.clear();
+}
+
+void MaStatementScanner::completeCommand()
+{
+    if (stopAtFirstNode && equalsNoCase(token_, "createnode")) {
+        token_.clear();
+        state_ = State::Stopped;
+        return;
+    }
+
+    if (equalsNoCase(token_, "file")) {
+        command_ = Command::File;
+    } else if (equalsNoCase(token_, "setattr")) {
+        command_ = Command::SetAttr;
+    } else if (equalsNoCase(token_, "requires")) {
+        command_ = Command::Requires;
+    } else {
+        command_ = Command::None;
+    }
+    token_.clear();
+    state_ = (command_ == Command::None) ? State::Skip : State::BetweenArgs;
+}
+
+void MaStatementScanner::completeArg(bool quoted)
+{
+    ++argIndex_;
+
+    if (command_ == Command::File) {
+        lastArg_.swap(token_);
+        lastArgQuoted_ = quoted;
+        lastArgValid_ = tokenValid_;
+        token_.clear();
+        state_ = State::BetweenArgs;
+        return;
+    }
+
+    if (command_ == Command::Requires) {
+        bool keepGoing = tokenValid_ && requiresArgs_.size() < kMaxRequiresArgs;
+        if (keepGoing) requiresArgs_.push_back(token_);
+        token_.clear();
+        state_ = keepGoing ? State::BetweenArgs : State::Skip;
+        if (!keepGoing) command_ = Command::None;
+        return;
+    }
+
+    // setAttr "<attr>" -type "string" "<value>"
+    bool keepGoing = false;
+    switch (argIndex_) {
+    case 1:
+        keepGoing = quoted && !token_.empty();
+        break;
+    case 2:
+        keepGoing = !quoted && equalsNoCase(token_, "-type");
+        break;
+    case 3:
+        keepGoing = quoted && equalsNoCase(token_, "string");
+        break;
+    case 4:
+        if (quoted && tokenValid_ && !token_.empty() && onStringAttr) {
+            onStringAttr(token_);
+        }
+        break;
+    default:
+        break;
+    }
+    token_.clear();
+    state_ = keepGoing ? State::BetweenArgs : State::Skip;
+}
+
+void MaStatementScanner::endStatement()
+{
+    if (command_ == Command::File && lastArgQuoted_ && lastArgValid_ &&
+        !lastArg_.empty() && onFileStatement) {
+        onFileStatement(lastArg_);
+    }
+    if (command_ == Command::Requires && !requiresArgs_.empty() && onRequires) {
+        onRequires(requiresArgs_);
+    }
+    requiresArgs_.clear();
+    command_ = Command::None;
+    argIndex_ = 0;
+    token_.clear();
+    lastArg_.clear();
+    lastArgQuoted_ = false;
+    lastArgValid_ = false;
+    state_ = State::StatementStart;
+}
+
+void MaStatementScanner::feed(const char* data, size_t size)
+{
+    const char* p = data;
+    const char* const end = data + size;
+
+    // Position of the next ';' at or after some earlier p (end when there is
+    // none). Cached so statements with many strings are not rescanned.
+    const char* nextSemi = nullptr;
+
+    while (p < end) {
+        switch (state_) {
+        case State::StatementStart: {
+            char c = *p;
+            if (isSpace(c) || c == ';') {
+                ++p;
+            } else if (c == '/') {
+                state_ = State::Slash;
+                ++p;
+            } else {
+                beginCommand();
+                state_ = State::Command;
+            }
+            break;
+        }
+
+        case State::Slash:
+            if (*p == '/') {
+                state_ = State::Comment;
+                ++p;
+            } else {
+                beginCommand();
+                token_ += '/';
+                state_ = State::Command;
+            }
+            break;
+
+        case State::Comment: {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!nl) {
+                p = end;
+            } else {
+                p = nl + 1;
+                state_ = State::StatementStart;
+            }
+            break;
+        }
+
+        case State::Command: {
+            char c = *p;
+            if (isSpace(c) || c == ';' || c == '"') {
+                // ';' and '"' are left for the next state to consume.
+                completeCommand();
+                if (isSpace(c)) ++p;
+            } else if (token_.size() >= kMaxCommandBytes) {
+                command_ = Command::None;
+                token_.clear();
+                state_ = State::Skip;
+            } else {
+                token_ += c;
+                ++p;
+            }
+            break;
+        }
+
+        case State::BetweenArgs: {
+            char c = *p;
+            if (isSpace(c)) {
+                ++p;
+            } else if (c == ';') {
+                ++p;
+                endStatement();
+            } else {
+                token_.clear();
+                tokenValid_ = true;
+                if (c == '"') {
+                    state_ = State::QuotedArg;
+                    ++p;
+                } else {
+                    state_ = State::BareArg;
+                }
+            }
+            break;
+        }
+
+        case State::BareArg: {
+            char c = *p;
+            if (isSpace(c) || c == ';' || c == '"') {
+                completeArg(false);
+                if (isSpace(c)) ++p;
+            } else {
+                appendTokenChar(c);
+                ++p;
+            }
+            break;
+        }
+
+        case State::QuotedArg:
+            while (p < end) {
+                char c = *p++;
+                if (c == '"') {
+                    completeArg(true);
+                    break;
+                }
+                if (c == '\\') {
+                    state_ = State::QuotedArgEscape;
+                    break;
+                }
+                if (c == '\n' || c == '\r') tokenValid_ = false;
+                appendTokenChar(c);
+            }
+            break;
+
+        case State::QuotedArgEscape: {
+            char c = *p++;
+            switch (c) {
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            default: break;
+            }
+            if (c == '\n' || c == '\r') tokenValid_ = false;
+            appendTokenChar(c);
+            state_ = State::QuotedArg;
+            break;
+        }
+
+        case State::Skip: {
+            if (!nextSemi || nextSemi < p) {
+                nextSemi = static_cast<const char*>(std::memchr(p, ';', end - p));
+                if (!nextSemi) nextSemi = end;
+            }
+            const char* quote = static_cast<const char*>(std::memchr(p, '"', nextSemi - p));
+            if (quote) {
+                p = quote + 1;
+                state_ = State::SkipQuoted;
+            } else if (nextSemi == end) {
+                p = end;
+            } else {
+                p = nextSemi + 1;
+                endStatement();
+            }
+            break;
+        }
+
+        case State::SkipQuoted:
+            while (p < end) {
+                char c = *p++;
+                if (c == '"') {
+                    state_ = State::Skip;
+                    break;
+                }
+                if (c == '\\') {
+                    state_ = State::SkipQuotedEscape;
+                    break;
+                }
+            }
+            break;
+
+        case State::SkipQuotedEscape:
+            ++p;
+            state_ = State::SkipQuoted;
+            break;
+
+        case State::Stopped:
+            return;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef MASTATEMENTSCANNER_H
+#define MASTATEMENTSCANNER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Incremental, single-pass tokenizer for Maya ASCII (.ma) statements.
+//
+// The file can be fed in one piece (e.g. a memory mapping) or in several;
+// statements and quoted strings may straddle piece boundaries. Only the
+// statements FileAnalyzer cares about keep their tokens:
+//
+//   file ... "<path>";                             -> onFileStatement(path)
+//   setAttr "<attr>" -type "string" "<value>" ...   -> onStringAttr(value)
+//   requires ... ;                                  -> onRequires(args)
+//
+// Every other statement is skipped up to its terminating ';' without copying
+// anything, so memory use is independent of file and statement size.
+// Quoted strings are returned with MEL escapes (\\, \") decoded.
+class MaStatementScanner {
+public:
+    // Last argument of a `file` statement, when it is a quoted string
+    // directly followed by ';'.
+    std::function<void(const std::string& lastArg)> onFileStatement;
+
+    // Value of `setAttr "<attr>" -type "string" "<value>"`.
+    std::function<void(const std::string& value)> onStringAttr;
+
+    // Arguments of a `requires` statement in order, flags included, e.g.
+    // {"-nodeType", "aiStandardSurface", "mtoa", "5.3.1"}.
+    std::function<void(const std::vector<std::string>& args)> onRequires;
+
+    // Stop at the first `createNode` statement. In a .ma file every `file`
+    // and `requires` statement comes before it, so this ends the scan after
+    // the header. feed() then ignores further input until reset().
+    bool stopAtFirstNode = false;
+    bool stopped() const { return state_ == State::Stopped; }
+
+    void feed(const char* data, size_t size);
+    void finish();
+    void reset();
+
+private:
+    enum class State : unsigned char {
+        StatementStart,
+        Slash,
+        Comment,
+        Command,
+        BetweenArgs,
+        BareArg,
+        QuotedArg,
+        QuotedArgEscape,
+        Skip,
+        SkipQuoted,
+        SkipQuotedEscape,
+        Stopped
+    };
+
+    enum class Command : unsigned char { None, File, SetAttr, Requires };
+
+    void beginCommand();
+    void completeCommand();
+    void completeArg(bool quoted);
+    void endStatement();
+    void appendTokenChar(char c);
+
+    State state_ = State::StatementStart;
+    Command command_ = Command::None;
+    int argIndex_ = 0;
+
+    std::string token_;
+    bool tokenValid_ = true;
+
+    std::string lastArg_;
+    bool lastArgQuoted_ = false;
+    bool lastArgValid_ = false;
+
+    std::vector<std::string> requiresArgs_;
+};
+
+#endif // MASTATEMENTSCANNER_H
@@ -0,0 +1,308 @@
+#include "MayaSceneQuery.h"
+
+#include <maya/MDagPath.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnGeometryFilter.h>
+#include <maya/MGlobal.h>
+#include <maya/MIntArray.h>
+#include <maya/MItDag.h>
+#include <maya/MItDependencyGraph.h>
+#include <maya/MItDependencyNodes.h>
+#include <maya/MObjectArray.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+#include <maya/MSelectionList.h>
+#include <maya/MString.h>
+
+#include <set>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Convert MString to UTF-8 std::string safely on Windows
+static std::string toUtf8(const MString& ms) {
+#ifdef _WIN32
+    const wchar_t* wstr = ms.asWChar();
+    if (!wstr || !*wstr) return std::string();
+    int len = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return std::string(ms.asChar());  // fallback
+    std::string result(len, '\0');
+    int ret = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, &result[0], len, nullptr, nullptr);
+    if (ret <= 0) return std::string(ms.asChar());
+    if (!result.empty() && result.back() == '\0') result.pop_back();
+    return result;
+#else
+    return std::string(ms.asChar());
+#endif
+}
+
+// Convert UTF-8 std::string to MString safely on Windows
+static MString utf8ToMString(const std::string& utf8) {
+#ifdef _WIN32
+    if (utf8.empty()) return MString();
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, nullptr, 0);
+    if (wlen <= 0) return MString(utf8.c_str());
+    std::wstring wstr(wlen, L'\0');
+    int ret = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wstr[0], wlen);
+    if (ret <= 0) return MString(utf8.c_str());
+    if (!wstr.empty() && wstr.back() == L'\0') wstr.pop_back();
+    return MString(wstr.c_str());
+#else
+    return MString(utf8.c_str());
+#endif
+}
+
+// Function set of the node types the scanners filter on, so a filter also
+// matches derived types; kInvalid for the rest (compared by type name).
+static MFn::Type fnTypeFor(const std::string& type)
+{
+    static const struct { const char* name; MFn::Type fn; } kTypes[] = {
+        {"transform", MFn::kTransform},
+        {"joint", MFn::kJoint},
+        {"mesh", MFn::kMesh},
+        {"camera", MFn::kCamera},
+        {"skinCluster", MFn::kSkinClusterFilter},
+        {"blendShape", MFn::kBlendShape},
+        {"file", MFn::kFileTexture},
+        {"audio", MFn::kAudio},
+    };
+    for (const auto& t : kTypes) {
+        if (type == t.name) return t.fn;
+    }
+    return MFn::kInvalid;
+}
+
+static bool isType(const MObject& obj, const std::string& type)
+{
+    if (type.empty()) return true;
+    MFn::Type fn = fnTypeFor(type);
+    if (fn != MFn::kInvalid) return obj.hasFn(fn);
+    return toUtf8(MFnDependencyNode(obj).typeName()) == type;
+}
+
+// Full path for DAG nodes, node name otherwise.
+static std::string nodeName(const MObject& obj)
+{
+    if (obj.hasFn(MFn::kDagNode)) {
+        MDagPath path;
+        if (MDagPath::getAPathTo(obj, path) == MS::kSuccess) return toUtf8(path.fullPathName());
+    }
+    return toUtf8(MFnDependencyNode(obj).name());
+}
+
+static bool findObject(const std::string& name, MObject& obj)
+{
+    MSelectionList sel;
+    if (name.empty() || sel.add(utf8ToMString(name)) != MS::kSuccess) return false;
+    return sel.getDependNode(0, obj) == MS::kSuccess;
+}
+
+static bool findDagPath(const std::string& name, MDagPath& path)
+{
+    MSelectionList sel;
+    if (name.empty() || sel.add(utf8ToMString(name)) != MS::kSuccess) return false;
+    return sel.getDagPath(0, path) == MS::kSuccess;
+}
+
+std::vector<std::string> MayaSceneQuery::nodesOfType(const std::string& type) const
+{
+    std::vector<std::string> out;
+    MFn::Type fn = fnTypeFor(type);
+    for (MItDependencyNodes it(fn); !it.isDone(); it.next()) {
+        MObject obj = it.thisNode();
+        if (fn == MFn::kInvalid && !isType(obj, type)) continue;
+        out.push_back(nodeName(obj));
+    }
+    return out;
+}
+
+SceneQuery::DagForest MayaSceneQuery::dagForest(const std::string& type) const
+{
+    DagForest forest;
+    // Matching nodes on the current path: (depth, index in forest).
+    std::vector<std::pair<unsigned, int32_t>> ancestors;
+    MItDag it(MItDag::kDepthFirst, MFn::kInvalid);
+    for (; !it.isDone(); it.next()) {
+        unsigned depth = it.depth();
+        while (!ancestors.empty() && ancestors.back().first >= depth) ancestors.pop_back();
+        // Depth 0 is the world node, not a scene node.
+        if (depth == 0 || !isType(it.currentItem(), type)) continue;
+
+        MDagPath path;
+        if (it.getPath(path) != MS::kSuccess) continue;
+        int32_t index = static_cast<int32_t>(forest.paths.size());
+        forest.paths.push_back(toUtf8(path.fullPathName()));
+        forest.ancestor.push_back(ancestors.empty() ? -1 : ancestors.back().second);
+        forest.parentIsType.push_back(!ancestors.empty() && ancestors.back().first + 1 == depth ? 1 : 0);
+        ancestors.emplace_back(depth, index);
+    }
+    return forest;
+}
+
+std::string MayaSceneQuery::nodeType(const std::string& node) const
+{
+    MObject obj;
+    if (!findObject(node, obj)) return std::string();
+    return toUtf8(MFnDependencyNode(obj).typeName());
+}
+
+std::string MayaSceneQuery::parent(const std::string& dagNode, const std::string& type) const
+{
+    MDagPath path;
+    if (!findDagPath(dagNode, path) || path.length() <= 1) return std::string();
+    path.pop();
+    if (!isType(path.node(), type)) return std::string();
+    return toUtf8(path.fullPathName());
+}
+
+std::vector<std::string> MayaSceneQuery::children(const std::string& dagNode, const std::string& type) const
+{
+    std::vector<std::string> out;
+    MDagPath path;
+    if (!findDagPath(dagNode, path)) return out;
+    for (unsigned i = 0; i < path.childCount(); ++i) {
+        MObject child = path.child(i);
+        if (!isType(child, type)) continue;
+        MDagPath childPath = path;
+        childPath.push(child);
+        out.push_back(toUtf8(childPath.fullPathName()));
+    }
+    return out;
+}
+
+std::vector<std::string> MayaSceneQuery::descendants(const std::string& dagNode, const std::string& type) const
+{
+    std::vector<std::string> out;
+    MDagPath root;
+    if (!findDagPath(dagNode, root)) return out;
+    MItDag it;
+    it.reset(root, MItDag::kDepthFirst, MFn::kInvalid);
+    for (it.next(); !it.isDone(); it.next()) {
+        MDagPath path;
+        if (it.getPath(path) != MS::kSuccess || !isType(path.node(), type)) continue;
+        out.push_back(toUtf8(path.fullPathName()));
+    }
+    return out;
+}
+
+std::vector<std::string> MayaSceneQuery::connections(const std::string& node, const std::string& type,
+                                                     bool source, bool destination) const
+{
+    std::vector<std::string> out;
+    MObject obj;
+    if (!findObject(node, obj)) return out;
+
+    MPlugArray plugs;
+    MFnDependencyNode(obj).getConnections(plugs);
+    std::set<std::string> seen;
+    for (unsigned i = 0; i < plugs.length(); ++i) {
+        MPlugArray others;
+        plugs[i].connectedTo(others, source, destination);
+        for (unsigned j = 0; j < others.length(); ++j) {
+            MObject other = others[j].node();
+            if (!isType(other, type)) continue;
+            std::string name = nodeName(other);
+            if (seen.insert(name).second) out.push_back(name);
+        }
+    }
+    return out;
+}
+
+bool MayaSceneQuery::history(const std::string& node, std::vector<std::string>& out) const
+{
+    out.clear();
+    MObject obj;
+    if (!findObject(node, obj)) return false;
+
+    // A transform's history is its shapes' history.
+    MObjectArray starts;
+    starts.append(obj);
+    MDagPath path;
+    if (obj.hasFn(MFn::kTransform) && findDagPath(node, path)) {
+        for (unsigned i = 0; i < path.childCount(); ++i) {
+            MObject child = path.child(i);
+            if (!child.hasFn(MFn::kTransform)) starts.append(child);
+        }
+    }
+
+    std::set<std::string> seen;
+    for (unsigned s = 0; s < starts.length(); ++s) {
+        MStatus status;
+        MItDependencyGraph it(starts[s], MFn::kInvalid, MItDependencyGraph::kUpstream,
+                              MItDependencyGraph::kBreadthFirst, MItDependencyGraph::kNodeLevel, &status);
+        if (status != MS::kSuccess) {
+            out.clear();
+            return false;
+        }
+        for (; !it.isDone(); it.next()) {
+            MObject cur = it.currentItem();
+            if (cur == starts[s]) continue;
+            if (cur.hasFn(MFn::kDagNode)) {
+                it.prune();
+                continue;
+            }
+            std::string name = nodeName(cur);
+            if (seen.insert(name).second) out.push_back(name);
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> MayaSceneQuery::deformedGeometry(const std::string& deformer) const
+{
+    std::vector<std::string> out;
+    MObject obj;
+    if (!findObject(deformer, obj)) return out;
+    MStatus status;
+    MFnGeometryFilter fn(obj, &status);
+    if (status != MS::kSuccess) return out;
+    MObjectArray geometry;
+    fn.getOutputGeometry(geometry);
+    for (unsigned i = 0; i < geometry.length(); ++i) out.push_back(nodeName(geometry[i]));
+    return out;
+}
+
+std::vector<std::string> MayaSceneQuery::elementNames(const std::string& node, const std::string& multiAttr) const
+{
+    std::vector<std::string> out;
+    MObject obj;
+    if (!findObject(node, obj)) return out;
+    MFnDependencyNode fn(obj);
+    MStatus status;
+    MPlug plug = fn.findPlug(utf8ToMString(multiAttr), false, &status);
+    if (status != MS::kSuccess || !plug.isArray()) return out;
+
+    MIntArray indices;
+    plug.getExistingArrayAttributeIndices(indices);
+    for (unsigned i = 0; i < indices.length(); ++i) {
+        MString alias = fn.plugsAlias(plug.elementByLogicalIndex(indices[i]));
+        if (alias.length() > 0) {
+            out.push_back(toUtf8(alias));
+        } else {
+            out.push_back(multiAttr + "[" + std::to_string(indices[i]) + "]");
+        }
+    }
+    return out;
+}
+
+bool MayaSceneQuery::getString(const std::string& node, const std::string& attr, std::string& value) const
+{
+    MObject obj;
+    if (!findObject(node, obj)) return false;
+    MStatus status;
+    MPlug plug = MFnDependencyNode(obj).findPlug(utf8ToMString(attr), false, &status);
+    if (status != MS::kSuccess) return false;
+    MString result = plug.asString(&status);
+    if (status != MS::kSuccess) return false;
+    value = toUtf8(result);
+    return true;
+}
+
+bool MayaSceneQuery::isStartupCamera(const std::string& cameraShape) const
+{
+    int isStartup = 0;
+    MGlobal::executeCommand(utf8ToMString("camera -q -startupCamera \"" + cameraShape + "\""), isStartup);
+    return isStartup != 0;
+}
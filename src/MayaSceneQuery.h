@@ -0,0 +1,28 @@
+#pragma once
+#ifndef MAYASCENEQUERY_H
+#define MAYASCENEQUERY_H
+
+#include "SceneQuery.h"
+
+// SceneQuery over the open Maya scene through the API: MItDependencyNodes
+// for type listings, MDagPath/MItDag for hierarchy, MPlug for connections
+// and attributes, MItDependencyGraph for history. No MEL is run except for
+// isStartupCamera(), which has no API equivalent. Main thread only.
+class MayaSceneQuery : public SceneQuery {
+public:
+    std::vector<std::string> nodesOfType(const std::string& type) const override;
+    DagForest dagForest(const std::string& type) const override;
+    std::string nodeType(const std::string& node) const override;
+    std::string parent(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> children(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> descendants(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> connections(const std::string& node, const std::string& type,
+                                         bool source, bool destination) const override;
+    bool history(const std::string& node, std::vector<std::string>& out) const override;
+    std::vector<std::string> deformedGeometry(const std::string& deformer) const override;
+    std::vector<std::string> elementNames(const std::string& node, const std::string& multiAttr) const override;
+    bool getString(const std::string& node, const std::string& attr, std::string& value) const override;
+    bool isStartupCamera(const std::string& cameraShape) const override;
+};
+
+#endif // MAYASCENEQUERY_H
@@ -0,0 +1,183 @@
+#include "MbIffReader.h"
+
+namespace {
+
+using MbIff::makeTag;
+
+// Chunk header layout, detected once from the top-level group.
+//   FOR4: tag(4) size(4)                      align 4
+//   FOR8: tag(4) pad(4) size(8)  or  tag(4) size(8)   align 8
+// Group type tags are followed by 4 bytes of padding in some 64-bit files.
+struct Layout {
+    bool wide = false;
+    size_t sizeOffset = 4;
+    size_t headerSize = 8;
+    size_t typeSize = 4;
+    uint64_t align = 4;
+};
+
+const int kMaxDepth = 64;
+
+uint32_t readU32(const unsigned char* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint64_t readU64(const unsigned char* p)
+{
+    return (static_cast<uint64_t>(readU32(p)) << 32) | readU32(p + 4);
+}
+
+bool isGroupTag(uint32_t tag)
+{
+    switch (tag) {
+    case makeTag('F', 'O', 'R', 'M'): case makeTag('F', 'O', 'R', '4'): case makeTag('F', 'O', 'R', '8'):
+    case makeTag('L', 'I', 'S', 'T'): case makeTag('L', 'I', 'S', '4'): case makeTag('L', 'I', 'S', '8'):
+    case makeTag('C', 'A', 'T', ' '): case makeTag('C', 'A', 'T', '4'): case makeTag('C', 'A', 'T', '8'):
+    case makeTag('P', 'R', 'O', 'P'): case makeTag('P', 'R', 'O', '4'): case makeTag('P', 'R', 'O', '8'):
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isTagChar(unsigned char c)
+{
+    return c >= 32 && c <= 126;
+}
+
+bool detectLayout(const unsigned char* p, size_t size, Layout& layout)
+{
+    if (size < 12) return false;
+    uint32_t tag = readU32(p);
+
+    if (tag == makeTag('F', 'O', 'R', '4')) {
+        layout = Layout();
+        return true;
+    }
+    if (tag != makeTag('F', 'O', 'R', '8')) return false;
+
+    layout.wide = true;
+    layout.align = 8;
+
+    // Prefer tag + pad + 64-bit size; fall back to tag + 64-bit size.
+    // Only one of the two yields a top-level group that fits the file.
+    if (size >= 16 && readU32(p + 4) == 0 && readU64(p + 8) <= size - 16) {
+        layout.sizeOffset = 8;
+        layout.headerSize = 16;
+    } else if (readU64(p + 4) <= size - 12) {
+        layout.sizeOffset = 4;
+        layout.headerSize = 12;
+    } else {
+        return false;
+    }
+
+    // Group type followed by padding: the next bytes are zeros rather than
+    // the first child's tag.
+    size_t typePos = layout.headerSize;
+    layout.typeSize = 4;
+    if (typePos + 8 <= size) {
+        const unsigned char* after = p + typePos + 4;
+        if (!isTagChar(after[0]) && readU32(after) == 0) layout.typeSize = 8;
+    }
+    return true;
+}
+
+struct Walker {
+    const unsigned char* base;
+    Layout layout;
+    const std::function<void(const IffChunk&)>& visit;
+    std::string& error;
+
+    uint64_t alignUp(uint64_t pos) const
+    {
+        return (pos + layout.align - 1) & ~(layout.align - 1);
+    }
+
+    bool walk(uint64_t begin, uint64_t end, uint32_t formType, int depth)
+    {
+        if (depth > kMaxDepth) {
+            error = "chunk nesting too deep";
+            return false;
+        }
+
+        uint64_t pos = begin;
+        while (pos + layout.headerSize <= end) {
+            const unsigned char* header = base + pos;
+            uint32_t tag = readU32(header);
+            uint64_t size = layout.wide ? readU64(header + layout.sizeOffset)
+                                        : readU32(header + layout.sizeOffset);
+            uint64_t dataBegin = pos + layout.headerSize;
+
+            if (size > end - dataBegin) {
+                error = "chunk '" + MbIff::tagToString(tag) + "' at offset " +
+                        std::to_string(pos) + " overruns its parent";
+                return false;
+            }
+            uint64_t dataEnd = dataBegin + size;
+
+            if (isGroupTag(tag)) {
+                if (size < layout.typeSize) {
+                    error = "group '" + MbIff::tagToString(tag) + "' at offset " +
+                            std::to_string(pos) + " has no type";
+                    return false;
+                }
+                uint32_t type = readU32(base + dataBegin);
+                if (!walk(dataBegin + layout.typeSize, dataEnd, type, depth + 1)) return false;
+            } else {
+                IffChunk chunk;
+                chunk.tag = tag;
+                chunk.formType = formType;
+                chunk.data = reinterpret_cast<const char*>(base + dataBegin);
+                chunk.size = size;
+                visit(chunk);
+            }
+
+            pos = alignUp(dataEnd);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+namespace MbIff {
+
+std::string tagToString(uint32_t tag)
+{
+    std::string s(4, ' ');
+    for (int i = 0; i < 4; ++i) {
+        unsigned char c = static_cast<unsigned char>(tag >> (24 - 8 * i));
+        s[i] = isTagChar(c) ? static_cast<char>(c) : '?';
+    }
+    return s;
+}
+
+bool isIff(const char* data, size_t size)
+{
+    if (!data || size < 4) return false;
+    uint32_t tag = readU32(reinterpret_cast<const unsigned char*>(data));
+    return tag == makeTag('F', 'O', 'R', '4') || tag == makeTag('F', 'O', 'R', '8');
+}
+
+bool walkChunks(const char* data, size_t size,
+                const std::function<void(const IffChunk&)>& visit,
+                std::string& error)
+{
+    const unsigned char* base = reinterpret_cast<const unsigned char*>(data);
+    Layout layout;
+    if (!isIff(data, size)) {
+        error = "missing FOR4/FOR8 header";
+        return false;
+    }
+    if (!detectLayout(base, size, layout)) {
+        error = "top-level group does not fit the file (truncated?)";
+        return false;
+    }
+
+    Walker walker{base, layout, visit, error};
+    return walker.walk(0, size, 0, 0);
+}
+
+} // namespace MbIff
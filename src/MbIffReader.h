@@ -0,0 +1,44 @@
+#pragma once
+#ifndef MBIFFREADER_H
+#define MBIFFREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// A leaf chunk of a Maya IFF file. data points into the caller's buffer
+// (typically a MappedFile), so payload pages are only touched if the
+// visitor actually reads them.
+struct IffChunk {
+    uint32_t tag;       // four-character code, e.g. MbIff::makeTag('F','R','E','F')
+    uint32_t formType;  // type of the enclosing FORM/LIST/CAT group (0 at top level)
+    const char* data;
+    uint64_t size;
+};
+
+namespace MbIff {
+
+    constexpr uint32_t makeTag(char a, char b, char c, char d) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(a)) << 24) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(c)) << 8) |
+                static_cast<uint32_t>(static_cast<unsigned char>(d));
+    }
+
+    std::string tagToString(uint32_t tag);
+
+    // True if the buffer starts with a Maya FOR4 (32-bit) or FOR8 (64-bit) group.
+    bool isIff(const char* data, size_t size);
+
+    // Walk the chunk tree depth-first and call visit() for every leaf chunk.
+    // Groups are descended into; everything else is skipped by its length
+    // header. Returns false (with a message in error) if a chunk header is
+    // inconsistent with the buffer size.
+    bool walkChunks(const char* data, size_t size,
+                    const std::function<void(const IffChunk&)>& visit,
+                    std::string& error);
+
+} // namespace MbIff
+
+#endif // MBIFFREADER_H
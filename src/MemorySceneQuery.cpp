@@ -0,0 +1,255 @@
+#include "MemorySceneQuery.h"
+
+#include <deque>
+#include <unordered_set>
+
+size_t MemorySceneQuery::add(const std::string& name, const std::string& type, bool dag, size_t parent)
+{
+    Node node;
+    node.name = name;
+    node.type = type;
+    node.dag = dag;
+    node.parent = parent;
+    size_t n = nodes_.size();
+    nodes_.push_back(std::move(node));
+    index_[name] = n;
+    if (parent != kNone) nodes_[parent].children.push_back(n);
+    return n;
+}
+
+std::string MemorySceneQuery::addDagNode(const std::string& name, const std::string& type,
+                                         const std::string& parent)
+{
+    size_t p = parent.empty() ? kNone : find(parent);
+    std::string path = (p == kNone ? std::string() : nodes_[p].name) + "|" + name;
+    add(path, type, true, p);
+    return path;
+}
+
+void MemorySceneQuery::addNode(const std::string& name, const std::string& type)
+{
+    add(name, type, false, kNone);
+}
+
+void MemorySceneQuery::connect(const std::string& source, const std::string& destination)
+{
+    size_t s = find(source);
+    size_t d = find(destination);
+    if (s == kNone || d == kNone) return;
+    nodes_[s].outputs.push_back(d);
+    nodes_[d].inputs.push_back(s);
+}
+
+void MemorySceneQuery::addDeformedGeometry(const std::string& deformer, const std::string& shape)
+{
+    size_t d = find(deformer);
+    size_t s = find(shape);
+    if (d == kNone || s == kNone) return;
+    nodes_[d].deformed.push_back(s);
+    connect(deformer, shape);
+}
+
+void MemorySceneQuery::setString(const std::string& node, const std::string& attr, const std::string& value)
+{
+    size_t n = find(node);
+    if (n != kNone) nodes_[n].strings[attr] = value;
+}
+
+void MemorySceneQuery::setElementNames(const std::string& node, const std::string& multiAttr,
+                                       const std::vector<std::string>& names)
+{
+    size_t n = find(node);
+    if (n != kNone) nodes_[n].elementNames[multiAttr] = names;
+}
+
+void MemorySceneQuery::setStartupCamera(const std::string& cameraShape, bool startup)
+{
+    size_t n = find(cameraShape);
+    if (n != kNone) nodes_[n].startupCamera = startup;
+}
+
+void MemorySceneQuery::setBaseType(const std::string& type, const std::string& base)
+{
+    baseTypes_[type] = base;
+}
+
+size_t MemorySceneQuery::find(const std::string& node) const
+{
+    auto it = index_.find(node);
+    return it == index_.end() ? kNone : it->second;
+}
+
+bool MemorySceneQuery::isA(size_t n, const std::string& type) const
+{
+    if (type.empty()) return true;
+    std::string t = nodes_[n].type;
+    for (size_t depth = 0; depth < 64; ++depth) {
+        if (t == type) return true;
+        auto it = baseTypes_.find(t);
+        if (it == baseTypes_.end()) return false;
+        t = it->second;
+    }
+    return false;
+}
+
+std::vector<std::string> MemorySceneQuery::nodesOfType(const std::string& type) const
+{
+    ++queries_;
+    std::vector<std::string> out;
+    for (size_t n = 0; n < nodes_.size(); ++n) {
+        if (isA(n, type)) out.push_back(nodes_[n].name);
+    }
+    return out;
+}
+
+SceneQuery::DagForest MemorySceneQuery::dagForest(const std::string& type) const
+{
+    ++queries_;
+    DagForest forest;
+    // (node, nearest ancestor of the type in `forest`, whether that is the parent)
+    struct Item { size_t node; int32_t ancestor; bool parentIsType; };
+    std::vector<Item> stack;
+    for (size_t n = nodes_.size(); n-- > 0;) {
+        if (nodes_[n].dag && nodes_[n].parent == kNone) stack.push_back({n, -1, false});
+    }
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+        int32_t ancestor = item.ancestor;
+        bool matches = isA(item.node, type);
+        if (matches) {
+            ancestor = static_cast<int32_t>(forest.paths.size());
+            forest.paths.push_back(nodes_[item.node].name);
+            forest.ancestor.push_back(item.ancestor);
+            forest.parentIsType.push_back(item.parentIsType ? 1 : 0);
+        }
+        const std::vector<size_t>& children = nodes_[item.node].children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.push_back({*it, ancestor, matches});
+        }
+    }
+    return forest;
+}
+
+std::string MemorySceneQuery::nodeType(const std::string& node) const
+{
+    ++queries_;
+    size_t n = find(node);
+    return n == kNone ? std::string() : nodes_[n].type;
+}
+
+std::string MemorySceneQuery::parent(const std::string& dagNode, const std::string& type) const
+{
+    ++queries_;
+    size_t n = find(dagNode);
+    if (n == kNone || nodes_[n].parent == kNone || !isA(nodes_[n].parent, type)) return std::string();
+    return nodes_[nodes_[n].parent].name;
+}
+
+std::vector<std::string> MemorySceneQuery::children(const std::string& dagNode, const std::string& type) const
+{
+    ++queries_;
+    std::vector<std::string> out;
+    size_t n = find(dagNode);
+    if (n == kNone) return out;
+    for (size_t c : nodes_[n].children) {
+        if (isA(c, type)) out.push_back(nodes_[c].name);
+    }
+    return out;
+}
+
+std::vector<std::string> MemorySceneQuery::descendants(const std::string& dagNode, const std::string& type) const
+{
+    ++queries_;
+    std::vector<std::string> out;
+    size_t n = find(dagNode);
+    if (n == kNone) return out;
+    std::vector<size_t> stack(nodes_[n].children.rbegin(), nodes_[n].children.rend());
+    while (!stack.empty()) {
+        size_t c = stack.back();
+        stack.pop_back();
+        if (isA(c, type)) out.push_back(nodes_[c].name);
+        stack.insert(stack.end(), nodes_[c].children.rbegin(), nodes_[c].children.rend());
+    }
+    return out;
+}
+
+std::vector<std::string> MemorySceneQuery::connections(const std::string& node, const std::string& type,
+                                                       bool source, bool destination) const
+{
+    ++queries_;
+    std::vector<std::string> out;
+    size_t n = find(node);
+    if (n == kNone) return out;
+    std::unordered_set<size_t> seen;
+    auto collect = [&](const std::vector<size_t>& nodes) {
+        for (size_t c : nodes) {
+            if (isA(c, type) && seen.insert(c).second) out.push_back(nodes_[c].name);
+        }
+    };
+    if (source) collect(nodes_[n].inputs);
+    if (destination) collect(nodes_[n].outputs);
+    return out;
+}
+
+bool MemorySceneQuery::history(const std::string& node, std::vector<std::string>& out) const
+{
+    ++queries_;
+    out.clear();
+    size_t n = find(node);
+    if (n == kNone) return false;
+
+    // A transform's history is its shapes' history.
+    std::deque<size_t> queue{n};
+    for (size_t c : nodes_[n].children) {
+        if (!isA(c, "transform")) queue.push_back(c);
+    }
+    std::unordered_set<size_t> seen(queue.begin(), queue.end());
+    while (!queue.empty()) {
+        size_t cur = queue.front();
+        queue.pop_front();
+        for (size_t in : nodes_[cur].inputs) {
+            if (nodes_[in].dag || !seen.insert(in).second) continue;
+            out.push_back(nodes_[in].name);
+            queue.push_back(in);
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> MemorySceneQuery::deformedGeometry(const std::string& deformer) const
+{
+    ++queries_;
+    std::vector<std::string> out;
+    size_t n = find(deformer);
+    if (n == kNone) return out;
+    for (size_t s : nodes_[n].deformed) out.push_back(nodes_[s].name);
+    return out;
+}
+
+std::vector<std::string> MemorySceneQuery::elementNames(const std::string& node, const std::string& multiAttr) const
+{
+    ++queries_;
+    size_t n = find(node);
+    if (n == kNone) return std::vector<std::string>();
+    auto it = nodes_[n].elementNames.find(multiAttr);
+    return it == nodes_[n].elementNames.end() ? std::vector<std::string>() : it->second;
+}
+
+bool MemorySceneQuery::getString(const std::string& node, const std::string& attr, std::string& value) const
+{
+    ++queries_;
+    size_t n = find(node);
+    if (n == kNone) return false;
+    auto it = nodes_[n].strings.find(attr);
+    if (it == nodes_[n].strings.end()) return false;
+    value = it->second;
+    return true;
+}
+
+bool MemorySceneQuery::isStartupCamera(const std::string& cameraShape) const
+{
+    ++queries_;
+    size_t n = find(cameraShape);
+    return n != kNone && nodes_[n].startupCamera;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#ifndef MEMORYSCENEQUERY_H
+#define MEMORYSCENEQUERY_H
+
+#include "SceneQuery.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// In-memory scene graph implementing SceneQuery, so the scanners and
+// exporter queries can be run and benchmarked without Maya.
+//
+// Build the scene with the add/connect/set calls, then query it. Node-level
+// connections stand in for plug connections: connect(a, b) means some plug
+// of `a` drives some plug of `b`. Type inheritance is only what
+// setBaseType() declares. Every query call is counted (queryCount()), the
+// number of MEL round trips the same calls would have cost.
+class MemorySceneQuery : public SceneQuery {
+public:
+    // Add a DAG node named `name` under `parent` (a full path, "" for the
+    // world) and return its full path.
+    std::string addDagNode(const std::string& name, const std::string& type,
+                           const std::string& parent = "");
+    // Add a non-DAG node.
+    void addNode(const std::string& name, const std::string& type);
+
+    void connect(const std::string& source, const std::string& destination);
+    // Record `shape` as an output geometry of `deformer` and connect them.
+    void addDeformedGeometry(const std::string& deformer, const std::string& shape);
+    void setString(const std::string& node, const std::string& attr, const std::string& value);
+    void setElementNames(const std::string& node, const std::string& multiAttr,
+                         const std::vector<std::string>& names);
+    void setStartupCamera(const std::string& cameraShape, bool startup = true);
+    // `type` also matches filters for `base` (e.g. "joint" -> "transform").
+    void setBaseType(const std::string& type, const std::string& base);
+
+    size_t nodeCount() const { return nodes_.size(); }
+    size_t queryCount() const { return queries_; }
+    void resetQueryCount() { queries_ = 0; }
+
+    std::vector<std::string> nodesOfType(const std::string& type) const override;
+    DagForest dagForest(const std::string& type) const override;
+    std::string nodeType(const std::string& node) const override;
+    std::string parent(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> children(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> descendants(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> connections(const std::string& node, const std::string& type,
+                                         bool source, bool destination) const override;
+    bool history(const std::string& node, std::vector<std::string>& out) const override;
+    std::vector<std::string> deformedGeometry(const std::string& deformer) const override;
+    std::vector<std::string> elementNames(const std::string& node, const std::string& multiAttr) const override;
+    bool getString(const std::string& node, const std::string& attr, std::string& value) const override;
+    bool isStartupCamera(const std::string& cameraShape) const override;
+
+private:
+    static const size_t kNone = static_cast<size_t>(-1);
+
+    struct Node {
+        std::string name;  // full path for DAG nodes
+        std::string type;
+        bool dag = false;
+        bool startupCamera = false;
+        size_t parent = kNone;
+        std::vector<size_t> children;
+        std::vector<size_t> inputs;
+        std::vector<size_t> outputs;
+        std::vector<size_t> deformed;
+        std::map<std::string, std::string> strings;
+        std::map<std::string, std::vector<std::string>> elementNames;
+    };
+
+    size_t add(const std::string& name, const std::string& type, bool dag, size_t parent);
+    size_t find(const std::string& node) const;
+    bool isA(size_t n, const std::string& type) const;
+
+    std::vector<Node> nodes_;
+    std::unordered_map<std::string, size_t> index_;
+    std::unordered_map<std::string, std::string> baseTypes_;
+    mutable size_t queries_ = 0;
+};
+
+#endif // MEMORYSCENEQUERY_H
@@ -0,0 +1,243 @@
+#include "MetadataExecutor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef _WIN32
+// Convert UTF-8 std::string to std::wstring
+static std::wstring utf8ToWide(const std::string& utf8) {
+    if (utf8.empty()) return {};
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, nullptr, 0);
+    if (wlen <= 0) return {};
+    std::wstring wstr(wlen, L'\0');
+    int ret = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wstr[0], wlen);
+    if (ret <= 0) return {};
+    if (!wstr.empty() && wstr.back() == L'\0') wstr.pop_back();
+    return wstr;
+}
+#endif
+
+namespace {
+
+std::mutex gSharedMutex;
+MetadataExecutor::Options gSharedOptions;
+MetadataExecutor* gShared = nullptr;
+
+} // namespace
+
+struct MetadataExecutor::Batch {
+    std::vector<StatResult> results;
+    std::vector<uint8_t> settled;  // answered, or given up on as Unknown
+    size_t remaining = 0;
+};
+
+MetadataExecutor::MetadataExecutor(const Options& options)
+    : options_(options)
+{
+    if (options_.threads == 0) options_.threads = 1;
+    if (options_.perMountLimit == 0) options_.perMountLimit = 1;
+    workers_.reserve(options_.threads);
+    for (unsigned i = 0; i < options_.threads; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+MetadataExecutor::~MetadataExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& kv : mounts_) kv.second.queue.clear();
+    }
+    workCv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void MetadataExecutor::configure(const Options& options)
+{
+    std::lock_guard<std::mutex> lock(gSharedMutex);
+    if (!gShared) gSharedOptions = options;
+}
+
+MetadataExecutor& MetadataExecutor::shared()
+{
+    // Never destroyed: a worker stuck in stat() on a dead server must not
+    // block process exit.
+    std::lock_guard<std::mutex> lock(gSharedMutex);
+    if (!gShared) gShared = new MetadataExecutor(gSharedOptions);
+    return *gShared;
+}
+
+std::string MetadataExecutor::mountKey(const std::string& path)
+{
+    std::string p = path;
+    for (auto& c : p) {
+        if (c == '\\') c = '/';
+    }
+
+    // //server/share
+    if (p.size() > 2 && p[0] == '/' && p[1] == '/') {
+        size_t server = p.find('/', 2);
+        if (server == std::string::npos) return p;
+        size_t share = p.find('/', server + 1);
+        std::string key = p.substr(0, share);
+#ifdef _WIN32
+        for (auto& c : key) c = (char)std::tolower((unsigned char)c);
+#endif
+        return key;
+    }
+
+    // C: (mapped network drives are their own bucket)
+    if (p.size() >= 2 && std::isalpha((unsigned char)p[0]) && p[1] == ':') {
+        return std::string(1, (char)std::toupper((unsigned char)p[0])) + ":";
+    }
+
+    // /mnt/proj, /Volumes/show: two levels covers the usual mount points
+    if (!p.empty() && p[0] == '/') {
+        size_t first = p.find('/', 1);
+        if (first == std::string::npos) return "/";
+        size_t second = p.find('/', first + 1);
+        return second == std::string::npos ? p.substr(0, first) : p.substr(0, second);
+    }
+    return std::string();
+}
+
+StatResult MetadataExecutor::statFile(const std::string& path)
+{
+    StatResult r;
+#ifdef _WIN32
+    struct _stat64 st;
+    bool ok = (_wstat64(utf8ToWide(path).c_str(), &st) == 0 && (st.st_mode & S_IFREG));
+#else
+    struct stat st;
+    bool ok = (stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFREG));
+#endif
+    r.state = ok ? StatResult::Exists : StatResult::Missing;
+    r.size = ok ? (int64_t)st.st_size : 0;
+    return r;
+}
+
+std::vector<StatResult> MetadataExecutor::statAll(const std::vector<std::string>& paths)
+{
+    using Clock = std::chrono::steady_clock;
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(paths.size());
+    batch->settled.assign(paths.size(), 0);
+    const Clock::time_point giveUp = Clock::now() + options_.batchDeadline;
+
+    // Query each distinct path once, then fan the answers back out.
+    std::unordered_map<std::string, size_t> firstSlot;
+    std::vector<size_t> alias(paths.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            auto inserted = firstSlot.emplace(paths[i], i);
+            alias[i] = inserted.first->second;
+            if (!inserted.second) continue;
+            mounts_[mountKey(paths[i])].queue.push_back({batch, i, paths[i]});
+            ++batch->remaining;
+        }
+    }
+    workCv_.notify_all();
+
+    std::vector<StatResult> results;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Settle (as Unknown) this batch's queries that are queued on, or
+        // running on, a mount; running stats finish on their own and their
+        // results are dropped.
+        auto abandon = [&](Mount& mount) {
+            auto& q = mount.queue;
+            auto stale = std::remove_if(q.begin(), q.end(), [&](const Task& t) { return t.batch == batch; });
+            for (auto it = stale; it != q.end(); ++it) {
+                batch->settled[it->slot] = 1;
+                --batch->remaining;
+            }
+            q.erase(stale, q.end());
+            for (const auto& r : mount.running) {
+                if (r.batch == batch.get() && !batch->settled[r.slot]) {
+                    batch->settled[r.slot] = 1;
+                    --batch->remaining;
+                }
+            }
+        };
+
+        while (batch->remaining > 0) {
+            const Clock::time_point now = Clock::now();
+            if (now >= giveUp) {
+                for (auto& kv : mounts_) abandon(kv.second);
+                break;
+            }
+
+            // A stat past its deadline marks its mount unresponsive. Wake
+            // up again when the oldest running stat would overrun (stats
+            // issued later cannot overrun sooner than now + deadline).
+            Clock::time_point wake = std::min(giveUp, now + options_.deadline);
+            for (auto& kv : mounts_) {
+                bool stalled = false;
+                for (const auto& r : kv.second.running) {
+                    Clock::time_point expiry = r.issued + options_.deadline;
+                    if (expiry <= now) stalled = true;
+                    else wake = std::min(wake, expiry);
+                }
+                if (stalled) abandon(kv.second);
+            }
+            if (batch->remaining == 0) break;
+            doneCv_.wait_until(lock, wake, [&]() { return batch->remaining == 0; });
+        }
+        results = batch->results;
+    }
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (alias[i] != i) results[i] = results[alias[i]];
+    }
+    return results;
+}
+
+void MetadataExecutor::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        // Any mount with queued work and a free slot.
+        Mount* mount = nullptr;
+        for (auto& kv : mounts_) {
+            if (!kv.second.queue.empty() && kv.second.running.size() < options_.perMountLimit) {
+                mount = &kv.second;
+                break;
+            }
+        }
+        if (!mount) {
+            if (stopping_) return;
+            workCv_.wait(lock);
+            continue;
+        }
+
+        Task task = std::move(mount->queue.front());
+        mount->queue.pop_front();
+        if (task.batch->settled[task.slot]) continue;
+
+        // Mount nodes are never erased, so the pointer stays valid.
+        mount->running.push_back({std::chrono::steady_clock::now(), task.batch.get(), task.slot});
+        lock.unlock();
+        StatResult r = statFile(task.path);
+        lock.lock();
+        auto& running = mount->running;
+        running.erase(std::find_if(running.begin(), running.end(), [&](const Running& x) {
+            return x.batch == task.batch.get() && x.slot == task.slot;
+        }));
+
+        if (!task.batch->settled[task.slot]) {
+            task.batch->settled[task.slot] = 1;
+            task.batch->results[task.slot] = r;
+            if (--task.batch->remaining == 0) doneCv_.notify_all();
+        }
+        // A mount slot was freed; tasks held back for that mount can run now.
+        workCv_.notify_one();
+    }
+}
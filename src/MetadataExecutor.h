@@ -0,0 +1,94 @@
+#pragma once
+#ifndef METADATAEXECUTOR_H
+#define METADATAEXECUTOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Result of one existence/size query.
+struct StatResult {
+    enum State { Missing, Exists, Unknown };
+    State state = Unknown;  // Unknown = stat did not return within its deadline
+    int64_t size = 0;       // valid when state == Exists
+};
+
+// Shared pool that answers file existence/size queries in parallel.
+//
+// On SMB/NFS storage a single stat can take tens of milliseconds and an
+// unreachable server blocks it indefinitely. Queries are spread over a fixed
+// set of worker threads, at most perMountLimit at a time per mount (UNC
+// share, drive letter or top-level directory). Each stat gets `deadline`
+// from the moment it is issued, so a slow but answering share only makes
+// the batch take longer; once a stat on a mount overruns its deadline the
+// mount counts as unresponsive and the batch's queries still queued for it
+// come back as Unknown along with the stuck one. statAll() also gives up on
+// everything after `batchDeadline`. A stat that never returns only ties up
+// one worker, and only perMountLimit of them per dead server.
+class MetadataExecutor {
+public:
+    struct Options {
+        unsigned threads = 32;
+        unsigned perMountLimit = 8;
+        std::chrono::milliseconds deadline{5000};         // per stat, from when it is issued
+        std::chrono::milliseconds batchDeadline{120000};  // whole statAll() call
+    };
+
+    explicit MetadataExecutor(const Options& options);
+    ~MetadataExecutor();
+
+    MetadataExecutor(const MetadataExecutor&) = delete;
+    MetadataExecutor& operator=(const MetadataExecutor&) = delete;
+
+    // Process-wide instance used by FileAnalyzer and SceneScanner. configure()
+    // only has an effect before the first call to shared().
+    static void configure(const Options& options);
+    static MetadataExecutor& shared();
+
+    // Stat every path (UTF-8); results are in input order. Blocks for at
+    // most batchDeadline. Duplicate paths are queried once.
+    std::vector<StatResult> statAll(const std::vector<std::string>& paths);
+
+    // Synchronous stat of one regular file, used by the workers.
+    static StatResult statFile(const std::string& path);
+
+    // Concurrency bucket for a path: "//server/share", "C:", "/mnt/proj".
+    static std::string mountKey(const std::string& path);
+
+private:
+    struct Batch;
+    struct Task {
+        std::shared_ptr<Batch> batch;
+        size_t slot;
+        std::string path;
+    };
+    struct Running {
+        std::chrono::steady_clock::time_point issued;
+        Batch* batch;
+        size_t slot;
+    };
+    struct Mount {
+        std::deque<Task> queue;
+        std::vector<Running> running;  // at most perMountLimit
+    };
+
+    void workerLoop();
+
+    Options options_;
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable doneCv_;
+    // Mounts are few (a handful of shares), so workers scan them linearly.
+    std::unordered_map<std::string, Mount> mounts_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+#endif // METADATAEXECUTOR_H
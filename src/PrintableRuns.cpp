@@ -0,0 +1,187 @@
+#include "PrintableRuns.h"
+
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PRINTABLERUNS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PRINTABLERUNS_SSE2 1
+#endif
+
+namespace {
+
+const size_t kBlock = 64;  // bytes per mask: 64 ASCII bits, 32 UTF-16 bits
+
+inline bool isPrintable(unsigned char c)
+{
+    return c >= 0x20 && c <= 0x7E;
+}
+
+inline int lowestBit(uint64_t v)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, v);
+    return (int)idx;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// Bit i of ascii: byte i printable. Bit k of utf16: bytes 2k, 2k+1 form a
+// printable code unit. Only the first n bytes count (n < kBlock at the tail).
+void classifyScalar(const unsigned char* p, size_t n, uint64_t& ascii, uint64_t& utf16)
+{
+    ascii = 0;
+    utf16 = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (isPrintable(p[i])) ascii |= (uint64_t)1 << i;
+    }
+    for (size_t k = 0; 2 * k + 1 < n; ++k) {
+        if (isPrintable(p[2 * k]) && p[2 * k + 1] == 0) utf16 |= (uint64_t)1 << k;
+    }
+}
+
+#if PRINTABLERUNS_AVX2
+void classifyBlock(const unsigned char* p, uint64_t& ascii, uint64_t& utf16)
+{
+    // Signed compares: bytes >= 0x80 are negative and fail "> 0x1F".
+    const __m256i lo8 = _mm256_set1_epi8(0x1F), hi8 = _mm256_set1_epi8(0x7F);
+    const __m256i lo16 = _mm256_set1_epi16(0x1F), hi16 = _mm256_set1_epi16(0x7F);
+    __m256i a = _mm256_loadu_si256((const __m256i*)p);
+    __m256i b = _mm256_loadu_si256((const __m256i*)(p + 32));
+
+    __m256i pa = _mm256_and_si256(_mm256_cmpgt_epi8(a, lo8), _mm256_cmpgt_epi8(hi8, a));
+    __m256i pb = _mm256_and_si256(_mm256_cmpgt_epi8(b, lo8), _mm256_cmpgt_epi8(hi8, b));
+    ascii = (uint64_t)(uint32_t)_mm256_movemask_epi8(pa) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(pb) << 32);
+
+    __m256i ua = _mm256_and_si256(_mm256_cmpgt_epi16(a, lo16), _mm256_cmpgt_epi16(hi16, a));
+    __m256i ub = _mm256_and_si256(_mm256_cmpgt_epi16(b, lo16), _mm256_cmpgt_epi16(hi16, b));
+    // packs works per 128-bit lane; permute restores code-unit order.
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(ua, ub), 0xD8);
+    utf16 = (uint32_t)_mm256_movemask_epi8(packed);
+}
+#elif PRINTABLERUNS_SSE2
+void classifyBlock(const unsigned char* p, uint64_t& ascii, uint64_t& utf16)
+{
+    const __m128i lo8 = _mm_set1_epi8(0x1F), hi8 = _mm_set1_epi8(0x7F);
+    const __m128i lo16 = _mm_set1_epi16(0x1F), hi16 = _mm_set1_epi16(0x7F);
+    __m128i v[4];
+    ascii = 0;
+    for (int i = 0; i < 4; ++i) {
+        v[i] = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+        __m128i pr = _mm_and_si128(_mm_cmpgt_epi8(v[i], lo8), _mm_cmpgt_epi8(hi8, v[i]));
+        ascii |= (uint64_t)(uint32_t)_mm_movemask_epi8(pr) << (16 * i);
+    }
+    utf16 = 0;
+    for (int i = 0; i < 4; i += 2) {
+        __m128i u0 = _mm_and_si128(_mm_cmpgt_epi16(v[i], lo16), _mm_cmpgt_epi16(hi16, v[i]));
+        __m128i u1 = _mm_and_si128(_mm_cmpgt_epi16(v[i + 1], lo16), _mm_cmpgt_epi16(hi16, v[i + 1]));
+        utf16 |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_packs_epi16(u0, u1)) << (8 * i);
+    }
+}
+#else
+void classifyBlock(const unsigned char* p, uint64_t& ascii, uint64_t& utf16)
+{
+    classifyScalar(p, kBlock, ascii, utf16);
+}
+#endif
+
+// Tracks one kind of run across blocks. Positions are in units (bytes for
+// ASCII, code units for UTF-16).
+struct RunTracker {
+    size_t start = 0;
+    bool open = false;
+
+    // mask holds `bits` units starting at unit `base`. onRun(start, end) is
+    // called for every run that ends inside this block.
+    template <typename OnRun>
+    void feed(uint64_t mask, int bits, size_t base, OnRun&& onRun)
+    {
+        const uint64_t all = bits == 64 ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1);
+        if (open ? mask == all : mask == 0) return;  // run continues / no text
+
+        // Transition bits: where a unit differs from the one before it.
+        uint64_t prev = (mask << 1) | (open ? 1 : 0);
+        uint64_t edges = (mask ^ prev) & all;
+        while (edges) {
+            int i = lowestBit(edges);
+            edges &= edges - 1;
+            if (open) {
+                onRun(start, base + (size_t)i);
+                open = false;
+            } else {
+                start = base + (size_t)i;
+                open = true;
+            }
+        }
+    }
+
+    template <typename OnRun>
+    void finish(size_t end, OnRun&& onRun)
+    {
+        if (open) onRun(start, end);
+        open = false;
+    }
+};
+
+} // namespace
+
+namespace PrintableRuns {
+
+const char* implementation()
+{
+#if PRINTABLERUNS_AVX2
+    return "avx2";
+#elif PRINTABLERUNS_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+void scan(const char* data, size_t size, size_t minLength, const Callback& fn)
+{
+    if (!data || size == 0) return;
+    if (minLength == 0) minLength = 1;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    std::string scratch;
+    RunTracker ascii, utf16;
+
+    auto emitAscii = [&](size_t s, size_t e) {
+        if (e - s >= minLength) fn(std::string_view(data + s, e - s), Encoding::Ascii);
+    };
+    auto emitUtf16 = [&](size_t s, size_t e) {
+        if (e - s < minLength) return;
+        scratch.resize(e - s);
+        for (size_t k = s; k < e; ++k) scratch[k - s] = data[2 * k];
+        fn(std::string_view(scratch), Encoding::Utf16Le);
+    };
+
+    size_t pos = 0;
+    for (; pos + kBlock <= size; pos += kBlock) {
+        uint64_t a, u;
+        classifyBlock(bytes + pos, a, u);
+        ascii.feed(a, 64, pos, emitAscii);
+        utf16.feed(u, 32, pos / 2, emitUtf16);
+    }
+    if (pos < size) {
+        size_t n = size - pos;
+        uint64_t a, u;
+        classifyScalar(bytes + pos, n, a, u);
+        ascii.feed(a, (int)n, pos, emitAscii);
+        utf16.feed(u, (int)(n / 2), pos / 2, emitUtf16);
+    }
+    ascii.finish(size, emitAscii);
+    utf16.finish(size / 2, emitUtf16);
+}
+
+} // namespace PrintableRuns
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef PRINTABLERUNS_H
+#define PRINTABLERUNS_H
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+// Single-pass extraction of printable text runs from binary data, used by
+// the .mb fallback scan when the IFF structure cannot be walked.
+//
+// One pass over the buffer finds both
+//   - ASCII runs: bytes 0x20..0x7E, and
+//   - UTF-16LE runs: code units 0x0020..0x007E at even offsets,
+// at least minLength characters long. The buffer is classified 64 bytes at a
+// time with SSE2 (or AVX2 when the build enables it; scalar elsewhere) and
+// runs are found from the resulting bit masks, so no per-byte appends or
+// per-run allocations happen.
+namespace PrintableRuns {
+
+enum class Encoding { Ascii, Utf16Le };
+
+// fn receives each run as narrow characters. ASCII views point into data;
+// UTF-16LE views point into a scratch buffer that is reused for the next
+// run, so copy the text if it must outlive the call. Runs are reported in
+// order of their end position within each encoding.
+using Callback = std::function<void(std::string_view run, Encoding encoding)>;
+
+void scan(const char* data, size_t size, size_t minLength, const Callback& fn);
+
+// Name of the instruction set scan() was compiled for ("avx2", "sse2",
+// "scalar").
+const char* implementation();
+
+} // namespace PrintableRuns
+
+#endif // PRINTABLERUNS_H
@@ -1,4 +1,6 @@
 #include "RefCheckerUI.h"
+#include "FileFingerprint.h"
+#include "MetadataExecutor.h"
 #include "SceneScanner.h"
 #include "PluginLog.h"
 
@@ -29,6 +31,7 @@
 #include <functional>
 #include <cstring>
 #include <atomic>
+#include <cstdlib>
 #include <regex>
 
 #ifdef _WIN32
@@ -136,8 +139,6 @@ static std::string pyStr(const std::string& s) {
 }
 
 // Forward declaration
-static bool globMatch(const char* pattern, const char* str);
-
 namespace {
 
 static QString utf8ToQString(const std::string& s)
@@ -300,104 +301,70 @@ static bool loadReferenceByNode(const std::string& refNode,
     return isReferenceLoaded(refNode);
 }
 
-// Simple file cache builder — indexes ALL files, no filtering.
-// Key = filename.toLower() via QString (Unicode-safe).
-// Uses only Win32 API + wstring in worker thread — no QDir (crashes in Maya worker threads).
-static std::pair<std::map<std::string, std::vector<std::string>>, int>
-buildFileCacheInternal(const std::string& searchDir,
-                       const std::function<bool(int)>& progressCb,
-                       std::atomic<bool>* cancelFlag)
+// Watch a search root so its index follows files added, moved or removed
+// during the session (see LiveFileIndex). MAYA_REF_CHECKER_LIVE_INDEX=0
+// turns this off.
+static std::unique_ptr<LiveFileIndex> startLiveIndex(const std::shared_ptr<FileIndex>& index)
 {
-    std::map<std::string, std::vector<std::string>> cache;
-    int scannedFiles = 0;
-    bool cancelled = false;
-
-    static const std::set<std::string> skippedDirs = {
-        "__pycache__", "node_modules", ".git", ".svn"
-    };
-
-    // Convert UTF-8 std::string <-> std::wstring via Win32 API (no Qt needed)
-    auto utf8ToWide = [](const std::string& s) -> std::wstring {
-        if (s.empty()) return {};
-        int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
-        if (len <= 0) return {};
-        std::wstring w(len, 0);
-        MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &w[0], len);
-        return w;
-    };
-    auto wideToUtf8 = [](const std::wstring& w) -> std::string {
-        if (w.empty()) return {};
-        int len = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), nullptr, 0, nullptr, nullptr);
-        if (len <= 0) return {};
-        std::string s(len, 0);
-        WideCharToMultiByte(CP_UTF8, 0, w.c_str(), (int)w.size(), &s[0], len, nullptr, nullptr);
-        return s;
-    };
-    auto wideToLowerUtf8 = [&](const std::wstring& w) -> std::string {
-        // LOCALE_INVARIANT ensures identical results on any machine regardless of system locale
-        std::wstring low(w.size(), 0);
-        int ret = LCMapStringW(LOCALE_INVARIANT, LCMAP_LOWERCASE,
-                               w.c_str(), (int)w.size(), &low[0], (int)low.size());
-        if (ret == 0) {
-            // fallback: ASCII-only lowercase
-            low = w;
-            for (auto& c : low) { if (c >= L'A' && c <= L'Z') c += 32; }
-        }
-        return wideToUtf8(low);
-    };
-
-    std::function<void(const std::wstring&)> walkDir;
-    walkDir = [&](const std::wstring& dirW) {
-        if (cancelled) return;
-        if (cancelFlag && cancelFlag->load()) {
-            cancelled = true;
-            return;
-        }
-
-        std::wstring pattern = dirW + L"\\*";
-
-        WIN32_FIND_DATAW fd;
-        HANDLE hFind = FindFirstFileW(pattern.c_str(), &fd);
-        if (hFind == INVALID_HANDLE_VALUE) return;
-
-        do {
-            if (cancelled) break;
-            if (cancelFlag && cancelFlag->load()) {
-                cancelled = true;
-                break;
-            }
-
-            std::wstring nameW(fd.cFileName);
-            if (nameW == L"." || nameW == L"..") continue;
+    const char* env = std::getenv("MAYA_REF_CHECKER_LIVE_INDEX");
+    if (env && std::strcmp(env, "0") == 0) return nullptr;
 
-            // Build full path: dir + "/" + name (use forward slash for consistency)
-            std::wstring fullW = dirW + L"/" + nameW;
+    auto live = std::make_unique<LiveFileIndex>(index, FileIndex::defaultIndexPath(index->root()));
+    if (!live->start()) {
+        PluginLog::warn("RefChecker", "Not watching " + index->root() + ": " + live->error());
+        return nullptr;
+    }
+    return live;
+}
 
-            if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-                if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
-                std::string nameLow = wideToLowerUtf8(nameW);
-                if (nameW[0] == L'.' || skippedDirs.count(nameLow)) continue;
-                walkDir(fullW);
-            } else {
-                ++scannedFiles;
+// Connection to the shared index service, or nullptr if none is running.
+// MAYA_REF_CHECKER_INDEX_SERVICE names another endpoint, or 0 to never use
+// the service.
+static std::unique_ptr<IndexClient> connectIndexService()
+{
+    const char* env = std::getenv("MAYA_REF_CHECKER_INDEX_SERVICE");
+    if (env && std::strcmp(env, "0") == 0) return nullptr;
+    return IndexClient::connect(env && *env ? std::string(env) : IndexProtocol::defaultEndpoint());
+}
 
-                std::string key = wideToLowerUtf8(nameW);
-                std::string fullPath = wideToUtf8(fullW);
-                cache[key].push_back(fullPath);
+// File index for one search root — indexes ALL files, no filtering.
+// Key = filename lowercased with the invariant locale (FileIndex::foldCase).
+// The index is persisted under FileIndex::defaultIndexPath() and refreshed
+// incrementally: only directories whose mtime changed are listed again, so a
+// repeat locate over the same library does not walk it.
+// FileIndex uses only Win32/POSIX calls — no QDir (crashes in Maya worker threads).
+// `listener` sees each directory as it is listed (walker threads).
+static std::shared_ptr<FileIndex>
+buildFileCacheInternal(const std::string& searchDir,
+                       const std::function<bool(int)>& progressCb,
+                       std::atomic<bool>* cancelFlag,
+                       const FileIndex::DirectoryFn& listener = nullptr)
+{
+    FileIndex::ProgressFn progress;
+    if (progressCb) {
+        progress = [&progressCb](size_t count) { return progressCb(static_cast<int>(count)); };
+    }
 
-                if (progressCb && (scannedFiles % 200 == 0)) {
-                    if (!progressCb(scannedFiles)) {
-                        cancelled = true;
-                        break;
-                    }
-                }
-            }
-        } while (FindNextFileW(hFind, &fd));
-        FindClose(hFind);
-    };
+    auto index = std::make_shared<FileIndex>();
+    index->setDirectoryListener(listener);
+    std::string indexPath = FileIndex::defaultIndexPath(searchDir);
+    bool ok = index->update(searchDir, indexPath, progress, cancelFlag);
+    index->setDirectoryListener(nullptr);
+    if (!ok) {
+        PluginLog::warn("RefChecker", "File index failed for " + searchDir + ": " + index->error());
+        return nullptr;
+    }
+    if (!index->error().empty()) {
+        PluginLog::warn("RefChecker", "File index not saved: " + index->error());
+    }
 
-    walkDir(utf8ToWide(searchDir));
-    return std::make_pair(cache, scannedFiles);
+    const FileIndex::UpdateStats& stats = index->stats();
+    std::ostringstream oss;
+    oss << "File index " << indexPath << ": " << stats.files << " files ("
+        << stats.sequences << " sequences), " << stats.dirsChecked << " dirs checked, " << stats.dirsListed << " listed"
+        << (stats.unchanged ? " (unchanged)" : "");
+    PluginLog::info("RefChecker", oss.str());
+    return index;
 }
 
 } // namespace
@@ -428,6 +395,11 @@ const BatchLocateWorker::Result& BatchLocateWorker::result() const
     return result_;
 }
 
+void BatchLocateWorker::setStreamMatcher(std::shared_ptr<StreamMatcher> stream)
+{
+    stream_ = std::move(stream);
+}
+
 void BatchLocateWorker::run()
 {
     emit statusText("Scanning files...");
@@ -437,9 +409,35 @@ void BatchLocateWorker::run()
         return !cancelled_.load();
     };
 
-    auto scanResult = buildFileCacheInternal(searchDir_, progressCb, &cancelled_);
-    result_.cache = std::move(scanResult.first);
-    result_.scannedCount = scanResult.second;
+    // With the shared index service running, it walks and holds the root
+    // for every Maya session; the in-process index is the fallback.
+    if (std::unique_ptr<IndexClient> service = connectIndexService()) {
+        uint64_t files = 0;
+        if (service->index(searchDir_, [&](size_t count) { return progressCb(static_cast<int>(count)); }, files)) {
+            result_.viaService = true;
+            result_.scannedCount = static_cast<int>(files);
+            emit finished();
+            return;
+        }
+        if (cancelled_.load()) {
+            result_.cancelled = true;
+            emit finished();
+            return;
+        }
+        PluginLog::warn("RefChecker", "Index service failed for " + searchDir_ + ": " + service->error() +
+                                          "; indexing in-process");
+    }
+
+    FileIndex::DirectoryFn listener;
+    if (stream_) {
+        StreamMatcher* stream = stream_.get();
+        listener = [stream](const std::string& dir, const std::vector<std::string>& names) {
+            stream->offer(dir, names);
+        };
+    }
+
+    result_.index = buildFileCacheInternal(searchDir_, progressCb, &cancelled_, listener);
+    result_.scannedCount = result_.index ? static_cast<int>(result_.index->size()) : 0;
     result_.cancelled = cancelled_.load();
 
     emit finished();
@@ -482,8 +480,13 @@ RefCheckerUI::RefCheckerUI(QWidget* parent)
     , scanThread_(nullptr)
     , scanWorker_(nullptr)
     , scanInProgress_(false)
+    , locateProgress_(nullptr)
+    , locateTimer_(nullptr)
 {
     fileCache_.totalCount = 0;
+    if (!fileRecords_.load(FileRecords::defaultPath())) {
+        PluginLog::warn("RefChecker", "File records unreadable, starting empty: " + FileRecords::defaultPath());
+    }
     setupUI();
 }
 
@@ -725,9 +728,10 @@ void RefCheckerUI::onScan()
     }
 
     dependencies_.clear();
-    fileCache_.cache.clear();
-    fileCache_.cacheKeys.clear();
-    fileCache_.cacheIndex.clear();
+    fileCache_.live.clear();
+    fileCache_.indexes.clear();
+    fileCache_.serviceRoots.clear();
+    fileCache_.matcher.reset();
     fileCache_.totalCount = 0;
     searchDirs_.clear();
 
@@ -741,20 +745,13 @@ void RefCheckerUI::onScan()
         dependencies_.insert(dependencies_.end(), refs.begin(), refs.end());
     }
     {
-        std::vector<DependencyInfo> texs = SceneScanner::scanTextures();
-        dependencies_.insert(dependencies_.end(), texs.begin(), texs.end());
-    }
-    {
-        std::vector<DependencyInfo> caches = SceneScanner::scanCaches();
-        dependencies_.insert(dependencies_.end(), caches.begin(), caches.end());
-    }
-    {
-        std::vector<DependencyInfo> audios = SceneScanner::scanAudio();
-        dependencies_.insert(dependencies_.end(), audios.begin(), audios.end());
+        std::vector<DependencyInfo> nodeDeps = SceneScanner::scanNodeDependencies();
+        dependencies_.insert(dependencies_.end(), nodeDeps.begin(), nodeDeps.end());
     }
 
     QApplication::restoreOverrideCursor();
 
+    recordFileSizes();
     refreshList();
     updateStats();
     checkAndWarnRisks();
@@ -765,8 +762,8 @@ void RefCheckerUI::onScan()
         int missing = 0;
         int ok = 0;
         for (const auto& dep : dependencies_) {
-            if (!dep.exists) ++missing;
-            else ++ok;
+            if (dep.exists) ++ok;
+            else if (!dep.unknown) ++missing;
         }
         PluginLog::ScanSummary ss;
         ss.module = "RefChecker";
@@ -787,7 +784,7 @@ void RefCheckerUI::onScan()
 void RefCheckerUI::onSelectAllMissing()
 {
     for (auto& dep : dependencies_) {
-        if (!dep.exists || (dep.type == "reference" && !dep.isLoaded)) {
+        if ((!dep.exists && !dep.unknown) || (dep.type == "reference" && !dep.isLoaded)) {
             dep.selected = true;
         }
     }
@@ -979,7 +976,7 @@ void RefCheckerUI::onLocateSingleDeferred(int depIndex)
     DependencyInfo& dep = dependencies_[depIndex];
 
     // Step 1: Try auto-match from existing cache (no dialog)
-    if (!fileCache_.cache.empty()) {
+    if (!fileCache_.indexes.empty()) {
         PluginLog::info("RefChecker", "onLocateSingleDeferred: attempting autoMatch from existing cache...");
         std::string best = autoMatchDependency(dep);
         if (!best.empty()) {
@@ -1027,8 +1024,7 @@ void RefCheckerUI::onLocateSingleDeferred(int depIndex)
                 searchDirField_->setText(displayText);
 
                 PluginLog::info("RefChecker", "Scanning dir: " + dirStr);
-                auto scanResult = buildFileCache(dirStr);
-                mergeCache(scanResult.first);
+                mergeCache(buildFileCache(dirStr));
             }
 
             // Retry auto-match with new cache
@@ -1094,6 +1090,11 @@ void RefCheckerUI::onLocateSingleDeferred(int depIndex)
 void RefCheckerUI::onBatchLocate()
 {
     PluginLog::info("RefChecker", "onBatchLocate: ENTER (button clicked)");
+    if (scanInProgress_) {
+        QMessageBox::information(this, "Batch Locate",
+            "Batch Locate is running. Please wait for it to finish.");
+        return;
+    }
     // Defer the file dialog to the next event loop iteration.
     // Calling QFileDialog static methods directly from a button slot inside
     // a Maya QDialog subclass can deadlock on some Windows + Maya versions
@@ -1143,30 +1144,98 @@ void RefCheckerUI::onBatchLocateDeferred()
 
     PluginLog::info("RefChecker", "Scanning: " + dirStr);
 
-    // Progress dialog (non-modal busy indicator)
-    QProgressDialog progressDlg("Scanning files...", "Cancel", 0, 0, this);
-    progressDlg.setWindowTitle("Batch Locate");
-    progressDlg.setWindowModality(Qt::WindowModal);
-    progressDlg.setMinimumDuration(0);
-    progressDlg.show();
-    QApplication::processEvents();
+    // Queries for everything still unmatched, offered each directory while
+    // the walk runs so likely matches show up before it finishes.
+    locateDeps_.clear();
+    provisional_.clear();
+    std::vector<AutoMatcher::Query> queries;
+    for (int i = 0; i < static_cast<int>(dependencies_.size()); ++i) {
+        const DependencyInfo& dep = dependencies_[i];
+        if (dep.exists || dep.unknown || !dep.matchedPath.empty()) continue;
+        locateDeps_.push_back(i);
+        queries.push_back(buildMatchQuery(dep));
+    }
+    locateStream_ = std::make_shared<StreamMatcher>(queries);
 
-    // ---- Phase 1: Scan files (main thread, synchronous) ----
-    bool cancelled = false;
-    auto progressCb = [&](int count) -> bool {
-        progressDlg.setLabelText(QString("Scanning files... %1 found").arg(count));
-        QApplication::processEvents();
-        if (progressDlg.wasCanceled()) {
-            cancelled = true;
-            return false;
-        }
-        return true;
-    };
+    locateProgress_ = new QProgressDialog("Scanning files...", "Cancel", 0, 0, this);
+    locateProgress_->setWindowTitle("Batch Locate");
+    locateProgress_->setWindowModality(Qt::WindowModal);
+    locateProgress_->setMinimumDuration(0);
 
-    auto scanResult = buildFileCacheInternal(dirStr, progressCb, nullptr);
+    // ---- Phase 1: Scan files (worker thread; Maya stays responsive) ----
+    scanWorker_ = new BatchLocateWorker(dirStr, FileScanFilter());
+    scanWorker_->setStreamMatcher(locateStream_);
+    scanThread_ = new QThread();
+    scanWorker_->moveToThread(scanThread_);
 
-    if (cancelled) {
-        PluginLog::info("RefChecker", "Batch Locate cancelled by user.");
+    connect(locateProgress_, &QProgressDialog::canceled, this, [this]() {
+        if (scanWorker_) scanWorker_->requestCancel();
+    });
+    connect(scanThread_, &QThread::started, scanWorker_, &BatchLocateWorker::run);
+    connect(scanWorker_, &BatchLocateWorker::progress, this, [this](int count) {
+        if (!locateProgress_ || !locateStream_) return;
+        locateProgress_->setLabelText(QString("Scanning files... %1 found, %2 matched so far")
+            .arg(count).arg(static_cast<int>(locateStream_->hitCount())));
+    });
+    connect(scanWorker_, &BatchLocateWorker::finished, this, &RefCheckerUI::onBatchLocateFinished);
+
+    locateTimer_ = new QTimer(this);
+    locateTimer_->setInterval(250);
+    connect(locateTimer_, &QTimer::timeout, this, &RefCheckerUI::applyStreamHits);
+
+    scanInProgress_ = true;
+    locateProgress_->show();
+    locateTimer_->start();
+    scanThread_->start();
+}
+
+void RefCheckerUI::applyStreamHits()
+{
+    if (!locateStream_) return;
+    std::vector<StreamMatcher::Hit> hits = locateStream_->takeHits();
+    if (hits.empty()) return;
+
+    int applied = 0;
+    for (const auto& hit : hits) {
+        int depIndex = locateDeps_[hit.query];
+        DependencyInfo& dep = dependencies_[depIndex];
+        if (dep.exists || dep.unknown || !dep.matchedPath.empty()) continue;
+        dep.matchedPath = hit.path;
+        provisional_.emplace_back(depIndex, hit.path);
+        ++applied;
+    }
+    if (applied == 0) return;
+    refreshList();
+    updateStats();
+}
+
+void RefCheckerUI::onBatchLocateFinished()
+{
+    if (locateTimer_) {
+        locateTimer_->stop();
+        locateTimer_->deleteLater();
+        locateTimer_ = nullptr;
+    }
+    applyStreamHits();
+
+    BatchLocateWorker::Result result = scanWorker_->result();
+    scanThread_->quit();
+    scanThread_->wait();
+    scanWorker_->deleteLater();
+    scanThread_->deleteLater();
+    scanWorker_ = nullptr;
+    scanThread_ = nullptr;
+    scanInProgress_ = false;
+    locateStream_.reset();
+
+    QProgressDialog* progressDlg = locateProgress_;
+    locateProgress_ = nullptr;
+    progressDlg->deleteLater();
+
+    if (result.cancelled || (!result.index && !result.viaService)) {
+        // Matches already shown stay; they are still only suggestions.
+        PluginLog::info("RefChecker", result.cancelled ? "Batch Locate cancelled by user."
+                                                       : "Batch Locate failed.");
         searchDirs_.pop_back();
         QString dt;
         for (size_t i = 0; i < searchDirs_.size(); ++i) {
@@ -1174,55 +1243,54 @@ void RefCheckerUI::onBatchLocateDeferred()
             dt += utf8ToQString(searchDirs_[i]);
         }
         searchDirField_->setText(dt);
+        progressDlg->close();
+        if (!result.cancelled) {
+            QMessageBox::warning(this, "Batch Locate",
+                "Could not read the selected directory.\n"
+                "Please verify the path and permissions.");
+        }
         return;
     }
 
     // ---- Phase 2: Merge cache ----
-    progressDlg.setLabelText("Merging file cache...");
+    progressDlg->setLabelText("Merging file cache...");
     QApplication::processEvents();
 
-    int addedCount = mergeCache(scanResult.first);
+    int addedCount = result.viaService ? mergeServiceRoot(searchDirs_.back(), result.scannedCount)
+                                       : mergeCache(result.index);
 
     {
         std::ostringstream oss;
-        oss << "Scanned " << scanResult.second << " files, added " << addedCount
-            << " new, total " << fileCache_.totalCount
-            << " (" << fileCache_.cache.size() << " names)";
+        oss << "Indexed " << addedCount << " files, total " << fileCache_.totalCount
+            << " (" << fileCache_.indexes.size() << " search roots)";
         PluginLog::info("RefChecker", oss.str());
     }
 
-    if (scanResult.second == 0) {
+    if (addedCount == 0) {
         QMessageBox::warning(this, "Batch Locate",
             "No files were found under the selected directory.\n"
             "Please verify the path and permissions.");
     }
 
     // ---- Phase 3: Auto-match ----
-    progressDlg.setLabelText("Auto-matching dependencies...");
+    // The full scorer over every root replaces the provisional matches
+    // (unless the user changed them meanwhile).
+    for (const auto& p : provisional_) {
+        DependencyInfo& dep = dependencies_[p.first];
+        if (dep.matchedPath == p.second) dep.matchedPath.clear();
+    }
+    provisional_.clear();
+
+    progressDlg->setLabelText("Auto-matching dependencies...");
     QApplication::processEvents();
 
-    int matchedCount = 0;
     int missingCount = 0;
-    int matchCounter = 0;
-
-    for (auto& dep : dependencies_) {
-        if (dep.exists) continue;
-        if (!dep.matchedPath.empty()) continue;
-        ++missingCount;
-
-        std::string best = autoMatchDependency(dep);
-        if (!best.empty()) {
-            dep.matchedPath = best;
-            ++matchedCount;
-        }
-
-        if (++matchCounter % 20 == 0) {
-            progressDlg.setLabelText(
-                QString("Auto-matching... %1/%2").arg(matchCounter).arg(missingCount));
-            QApplication::processEvents();
-            if (progressDlg.wasCanceled()) break;
-        }
-    }
+    std::vector<int> matched = autoMatchMissing(missingCount, [&](int done, int total) {
+        progressDlg->setLabelText(QString("Auto-matching... %1/%2").arg(done).arg(total));
+        QApplication::processEvents();
+        return !progressDlg->wasCanceled();
+    });
+    int matchedCount = static_cast<int>(matched.size());
 
     {
         std::ostringstream matchOss;
@@ -1231,7 +1299,7 @@ void RefCheckerUI::onBatchLocateDeferred()
         PluginLog::info("RefChecker", matchOss.str());
     }
 
-    progressDlg.close();
+    progressDlg->close();
 
     refreshList();
     updateStats();
@@ -1249,13 +1317,43 @@ void RefCheckerUI::onBatchLocateDeferred()
 
 void RefCheckerUI::onApplyFixes()
 {
+    // A dependency whose stat timed out may still exist: check matched ones
+    // again before repathing them, and leave any still unknown alone.
+    {
+        std::vector<int> recheck;
+        std::vector<std::string> paths;
+        for (int i = 0; i < static_cast<int>(dependencies_.size()); ++i) {
+            const DependencyInfo& dep = dependencies_[i];
+            if (!dep.unknown || dep.matchedPath.empty()) continue;
+            recheck.push_back(i);
+            paths.push_back(SceneScanner::resolveSceneRelative(dep.path));
+        }
+        if (!recheck.empty()) {
+            std::vector<StatResult> stats = MetadataExecutor::shared().statAll(paths);
+            for (size_t k = 0; k < recheck.size(); ++k) {
+                DependencyInfo& dep = dependencies_[recheck[k]];
+                dep.exists = stats[k].state == StatResult::Exists;
+                dep.unknown = stats[k].state == StatResult::Unknown;
+                dep.size = dep.exists ? stats[k].size : 0;
+                if (dep.exists) {
+                    PluginLog::info("RefChecker", "ApplyFixes: original path exists, match dropped: " + dep.path);
+                    dep.matchedPath.clear();
+                } else if (dep.unknown) {
+                    PluginLog::warn("RefChecker", "ApplyFixes: existence still unknown, skipped: " + dep.path);
+                }
+            }
+            refreshList();
+            updateStats();
+        }
+    }
+
     // Collect candidates: prefer selected, fall back to all matched
     std::vector<int> selectedIndices;
     std::vector<int> allMatchedIndices;
 
     for (int i = 0; i < static_cast<int>(dependencies_.size()); ++i) {
         const DependencyInfo& dep = dependencies_[i];
-        if (dep.exists) continue;
+        if (dep.exists || dep.unknown) continue;
         if (dep.matchedPath.empty()) continue;
 
         allMatchedIndices.push_back(i);
@@ -1300,6 +1398,8 @@ void RefCheckerUI::onApplyFixes()
 
     int success = 0;
     int failed = 0;
+    std::vector<int> fixed;
+    std::vector<std::string> fixedFiles;  // absolute file of each fixed dependency
 
     for (size_t i = 0; i < toFix.size(); ++i) {
         int idx = toFix[i];
@@ -1316,10 +1416,11 @@ void RefCheckerUI::onApplyFixes()
         PluginLog::info("RefChecker", logMsg.str());
 
         if (applyPath(dep, newPath)) {
-            // Always check existence using the absolute path (matchedPath
-            // is always absolute from the file cache).  newPath may be
-            // relative when the user chose "Relative Path" mode.
-            dep.exists = SceneScanner::pathExists(dep.matchedPath);
+            // Existence is checked after the loop, on the absolute path
+            // (matchedPath is always absolute from the file cache).  newPath
+            // may be relative when the user chose "Relative Path" mode.
+            fixed.push_back(idx);
+            fixedFiles.push_back(SceneScanner::resolveSceneRelative(dep.matchedPath));
             dep.path = newPath;
             dep.matchedPath = "";
             dep.selected = false;
@@ -1339,6 +1440,21 @@ void RefCheckerUI::onApplyFixes()
         }
     }
 
+    // One batch through the executor, so an unreachable share cannot hang
+    // Maya; a stat that times out leaves the dependency unknown.
+    std::vector<std::pair<std::string, std::string>> applied;  // new dep.path, absolute file
+    if (!fixed.empty()) {
+        std::vector<StatResult> stats = MetadataExecutor::shared().statAll(fixedFiles);
+        for (size_t k = 0; k < fixed.size(); ++k) {
+            DependencyInfo& dep = dependencies_[fixed[k]];
+            dep.exists = stats[k].state == StatResult::Exists;
+            dep.unknown = stats[k].state == StatResult::Unknown;
+            dep.size = dep.exists ? stats[k].size : 0;
+            if (dep.exists) applied.emplace_back(dep.path, fixedFiles[k]);
+        }
+    }
+
+    recordAppliedFiles(applied);
     refreshList();
     updateStats();
 
@@ -1424,6 +1540,11 @@ void RefCheckerUI::refreshList()
                 statusItem->setText("OK");
                 statusItem->setForeground(QBrush(QColor(50, 160, 50)));
             }
+        } else if (dep.unknown) {
+            // Never checked: stays UNKNOWN even with a manual match, which
+            // Apply Fixes only uses once the original is known to be missing.
+            statusItem->setText("UNKNOWN");
+            statusItem->setForeground(QBrush(QColor(140, 140, 140)));
         } else if (!dep.matchedPath.empty()) {
             statusItem->setText("MATCHED");
             statusItem->setForeground(QBrush(QColor(50, 100, 180)));
@@ -1513,17 +1634,62 @@ void RefCheckerUI::updateStats()
     int missing = 0;
     int unloaded = 0;
     int matched = 0;
+    int unknown = 0;
     for (const auto& dep : dependencies_) {
-        if (!dep.exists) ++missing;
+        if (!dep.exists && !dep.unknown) ++missing;
+        if (dep.unknown) ++unknown;
         if (dep.exists && !dep.isLoaded && dep.type == "reference") ++unloaded;
         if (!dep.matchedPath.empty()) ++matched;
     }
 
     QString text = QString("Total: %1 | Missing: %2 | Unloaded: %3 | Matched: %4")
         .arg(total).arg(missing).arg(unloaded).arg(matched);
+    if (unknown > 0) text += QString(" | Unknown: %1").arg(unknown);
     statsLabel_->setText(text);
 }
 
+// ============================================================================
+// File records (expected size / fingerprint for Batch Locate)
+// ============================================================================
+
+// Sizes come with the existence check, so recording them costs nothing.
+void RefCheckerUI::recordFileSizes()
+{
+    for (const auto& dep : dependencies_) {
+        if (dep.exists && dep.size > 0) fileRecords_.record(dep.path, static_cast<uint64_t>(dep.size));
+    }
+    if (!fileRecords_.save(FileRecords::defaultPath())) {
+        PluginLog::warn("RefChecker", "Could not save " + FileRecords::defaultPath());
+    }
+}
+
+// Fingerprint the files a fix pointed at (in parallel), so they can be told
+// apart from same-name copies if they go missing again.
+void RefCheckerUI::recordAppliedFiles(const std::vector<std::pair<std::string, std::string>>& applied)
+{
+    if (applied.empty()) return;
+    std::vector<std::string> files;
+    for (const auto& a : applied) files.push_back(a.second);
+    std::vector<StatResult> stats = MetadataExecutor::shared().statAll(files);
+
+    std::vector<size_t> slots;
+    std::vector<std::string> paths;
+    std::vector<uint64_t> sizes;
+    for (size_t i = 0; i < stats.size(); ++i) {
+        if (stats[i].state != StatResult::Exists) continue;
+        slots.push_back(i);
+        paths.push_back(files[i]);
+        sizes.push_back(static_cast<uint64_t>(stats[i].size));
+    }
+    std::vector<uint64_t> fingerprints = FileFingerprint::sampledAll(paths, sizes);
+    for (size_t k = 0; k < slots.size(); ++k) {
+        fileRecords_.record(applied[slots[k]].first, sizes[k], fingerprints[k]);
+    }
+    if (!fileRecords_.save(FileRecords::defaultPath())) {
+        PluginLog::warn("RefChecker", "Could not save " + FileRecords::defaultPath());
+    }
+}
+
 // ============================================================================
 // checkAndWarnRisks
 // ============================================================================
@@ -1613,41 +1779,127 @@ void RefCheckerUI::checkAndWarnRisks()
 }
 
 // ============================================================================
-// File cache: buildFileCache / scanDirIntoCache / mergeCache
+// File cache: buildFileCache / mergeCache
 // ============================================================================
 
-int RefCheckerUI::mergeCache(
-    const std::map<std::string, std::vector<std::string>>& newCache)
+int RefCheckerUI::mergeCache(const std::shared_ptr<FileIndex>& index)
 {
-    int added = 0;
-    for (const auto& kv : newCache) {
-        const std::string& nameLower = kv.first;
-        const std::vector<std::string>& paths = kv.second;
-
-        auto& bucket = fileCache_.cache[nameLower];
-        for (const auto& candidate : paths) {
-            std::string norm = candidate;
-            norm = lowerString(norm);
-            for (auto& ch : norm) { if (ch == '\\') ch = '/'; }
-
-            if (fileCache_.cacheIndex.count(norm) == 0) {
-                fileCache_.cacheIndex.insert(norm);
-                bucket.push_back(candidate);
-                ++added;
-            }
+    if (!index) return 0;
+
+    // Re-adding a root replaces its previous (older) index. Overlapping
+    // roots are not deduplicated here; AutoMatcher dedupes candidates.
+    int added = static_cast<int>(index->size());
+    fileCache_.matcher.reset();
+    for (size_t i = 0; i < fileCache_.indexes.size(); ++i) {
+        if (fileCache_.indexes[i]->root() == index->root()) {
+            fileCache_.live[i].reset();
+            fileCache_.totalCount -= static_cast<int>(fileCache_.indexes[i]->size());
+            fileCache_.indexes[i] = index;
+            fileCache_.live[i] = startLiveIndex(index);
+            fileCache_.totalCount += added;
+            return added;
+        }
+    }
+    fileCache_.indexes.push_back(index);
+    fileCache_.live.push_back(startLiveIndex(index));
+    fileCache_.totalCount += added;
+    return added;
+}
+
+int RefCheckerUI::mergeServiceRoot(const std::string& root, int fileCount)
+{
+    for (auto& entry : fileCache_.serviceRoots) {
+        if (entry.first == root) {
+            fileCache_.totalCount += fileCount - entry.second;
+            entry.second = fileCount;
+            return fileCount;
         }
     }
-    fileCache_.totalCount += added;
+    fileCache_.serviceRoots.emplace_back(root, fileCount);
+    fileCache_.totalCount += fileCount;
+    return fileCount;
+}
 
-    fileCache_.cacheKeys.clear();
-    for (const auto& kv : fileCache_.cache) {
-        fileCache_.cacheKeys.push_back(kv.first);
+// All roots must be scored together, so the service answers only when it
+// holds every one of them. On any failure (including a timeout) the service
+// roots are indexed in-process, from the index files the service keeps up
+// to date (a refresh, not a walk), behind a progress dialog, and matching
+// carries on locally.
+bool RefCheckerUI::matchViaService(const std::vector<AutoMatcher::Query>& queries,
+                                   std::vector<std::string>& results)
+{
+    if (fileCache_.serviceRoots.empty()) return false;
+    if (!fileCache_.indexes.empty()) {
+        fallBackFromService();
+        return false;
     }
 
-    return added;
+    if (!fileCache_.service || !fileCache_.service->connected()) fileCache_.service = connectIndexService();
+    std::vector<std::string> roots;
+    for (const auto& entry : fileCache_.serviceRoots) roots.push_back(entry.first);
+    if (fileCache_.service && fileCache_.service->bestMatch(roots, queries, results)) return true;
+
+    PluginLog::warn("RefChecker", "Index service unavailable (" +
+                                      (fileCache_.service ? fileCache_.service->error() : std::string("not running")) +
+                                      "); matching in-process");
+    fallBackFromService();
+    return false;
+}
+
+void RefCheckerUI::fallBackFromService()
+{
+    std::vector<std::pair<std::string, int>> roots;
+    roots.swap(fileCache_.serviceRoots);
+    fileCache_.service.reset();
+    if (roots.empty()) return;
+
+    // Even from a current index file, update() checks every directory of
+    // the root, which takes a while on a large network library: show it,
+    // and let the user skip the remaining roots.
+    QProgressDialog progressDlg("Indexing search roots...", "Cancel", 0, 0, this);
+    progressDlg.setWindowTitle("Batch Locate");
+    progressDlg.setWindowModality(Qt::WindowModal);
+    progressDlg.setMinimumDuration(500);
+
+    for (const auto& entry : roots) {
+        fileCache_.totalCount -= entry.second;
+        if (progressDlg.wasCanceled()) {
+            PluginLog::warn("RefChecker", "Search root not indexed (cancelled): " + entry.first);
+            continue;
+        }
+        const QString root = utf8ToQString(entry.first);
+        progressDlg.setLabelText(QString("Indexing %1 ...").arg(root));
+        QApplication::processEvents();
+        auto progressCb = [&](int count) -> bool {
+            progressDlg.setLabelText(QString("Indexing %1 ... %2 files").arg(root).arg(count));
+            QApplication::processEvents();
+            return !progressDlg.wasCanceled();
+        };
+        std::shared_ptr<FileIndex> index = buildFileCacheInternal(entry.first, progressCb, nullptr);
+        if (index) {
+            mergeCache(index);
+        } else if (progressDlg.wasCanceled()) {
+            PluginLog::warn("RefChecker", "Search root not indexed (cancelled): " + entry.first);
+        }
+    }
+    progressDlg.close();
+}
+
+void RefCheckerUI::syncLiveIndexes()
+{
+    // Take the indexes refreshed in the background since the last match.
+    for (size_t i = 0; i < fileCache_.live.size(); ++i) {
+        if (!fileCache_.live[i]) continue;
+        std::shared_ptr<FileIndex> current = fileCache_.live[i]->current();
+        if (current == fileCache_.indexes[i]) continue;
+        fileCache_.totalCount += static_cast<int>(current->size()) -
+                                 static_cast<int>(fileCache_.indexes[i]->size());
+        fileCache_.indexes[i] = current;
+        fileCache_.matcher.reset();
+    }
 }
 
-std::pair<std::map<std::string, std::vector<std::string>>, int>
+std::shared_ptr<FileIndex>
 RefCheckerUI::buildFileCache(const std::string& searchDir,
                              std::function<bool(int)> progressCb,
                              const FileScanFilter* /*filter*/,
@@ -1656,18 +1908,6 @@ RefCheckerUI::buildFileCache(const std::string& searchDir,
     return buildFileCacheInternal(searchDir, progressCb, cancelFlag);
 }
 
-int RefCheckerUI::scanDirIntoCache(
-    const std::string& directory,
-    std::map<std::string, std::vector<std::string>>& cache)
-{
-    auto result = buildFileCache(directory);
-    for (auto& kv : result.first) {
-        auto& bucket = cache[kv.first];
-        bucket.insert(bucket.end(), kv.second.begin(), kv.second.end());
-    }
-    return result.second;
-}
-
 FileScanFilter RefCheckerUI::buildScanFilter()
 {
     FileScanFilter filter;
@@ -1705,7 +1945,7 @@ FileScanFilter RefCheckerUI::buildScanFilter()
     };
 
     for (const auto& dep : dependencies_) {
-        if (dep.exists) continue;
+        if (dep.exists || dep.unknown) continue;
         if (!dep.matchedPath.empty()) continue;
 
         std::vector<std::string> keys = collectMatchKeys(dep);
@@ -1725,21 +1965,13 @@ FileScanFilter RefCheckerUI::buildScanFilter()
 
 void RefCheckerUI::runAutoMatch()
 {
-    int matchedCount = 0;
     int missingCount = 0;
-
-    for (auto& dep : dependencies_) {
-        if (dep.exists) continue;
-        if (!dep.matchedPath.empty()) continue;
-        ++missingCount;
-
-        std::string best = autoMatchDependency(dep);
-        if (!best.empty()) {
-            dep.matchedPath = best;
-            ++matchedCount;
-            PluginLog::info("RefChecker",
-                "Matched: " + getCleanFilename(dep.path) + " -> " + best);
-        }
+    std::vector<int> matched = autoMatchMissing(missingCount, nullptr);
+    int matchedCount = static_cast<int>(matched.size());
+    for (int i : matched) {
+        const DependencyInfo& dep = dependencies_[i];
+        PluginLog::info("RefChecker",
+            "Matched: " + getCleanFilename(dep.path) + " -> " + dep.matchedPath);
     }
 
     std::ostringstream oss;
@@ -1757,35 +1989,95 @@ void RefCheckerUI::runAutoMatch()
     QMessageBox::information(this, "Batch Locate Complete", msg);
 }
 
-std::string RefCheckerUI::autoMatchDependency(const DependencyInfo& dep)
+std::vector<int> RefCheckerUI::autoMatchMissing(
+    int& missingCount, const std::function<bool(int, int)>& progress)
 {
-    if (fileCache_.cache.empty()) return "";
+    syncLiveIndexes();
 
-    std::string originalPath = dep.unresolvedPath.empty() ? dep.path : dep.unresolvedPath;
-    std::vector<std::string> candidates;
+    // Keys are collected here (they use Qt); the matching itself runs on
+    // all cores.
+    std::vector<int> depIndices;
+    std::vector<AutoMatcher::Query> queries;
+    for (int i = 0; i < static_cast<int>(dependencies_.size()); ++i) {
+        const DependencyInfo& dep = dependencies_[i];
+        if (dep.exists || dep.unknown) continue;
+        if (!dep.matchedPath.empty()) continue;
+        depIndices.push_back(i);
+        queries.push_back(buildMatchQuery(dep));
+    }
+    missingCount = static_cast<int>(queries.size());
 
-    std::vector<std::string> keys = collectMatchKeys(dep);
+    std::vector<int> matched;
+    if (queries.empty()) return matched;
 
-    for (const auto& key : keys) {
-        if (isWildcardPattern(key)) {
-            std::vector<std::string> matched = matchByPattern(key);
-            candidates.insert(candidates.end(), matched.begin(), matched.end());
-        } else {
-            auto it = fileCache_.cache.find(key);
-            if (it != fileCache_.cache.end()) {
-                candidates.insert(candidates.end(),
-                                  it->second.begin(), it->second.end());
-            }
+    std::vector<std::string> serviceResults;
+    if (matchViaService(queries, serviceResults)) {
+        for (size_t k = 0; k < serviceResults.size(); ++k) {
+            if (serviceResults[k].empty()) continue;
+            dependencies_[depIndices[k]].matchedPath = serviceResults[k];
+            matched.push_back(depIndices[k]);
         }
+        if (progress) progress(missingCount, missingCount);
+        return matched;
     }
+    if (fileCache_.indexes.empty()) return matched;
 
-    candidates = dedupePaths(candidates);
-    if (candidates.empty()) {
-        return "";
+    AutoMatcher::ProgressFn matchProgress;
+    if (progress) {
+        matchProgress = [&](size_t done) {
+            return progress(static_cast<int>(done), missingCount);
+        };
     }
+    std::vector<std::string> results = autoMatcher().matchAll(queries, matchProgress);
 
-    std::string best = findBestMatch(originalPath, candidates);
-    return best;
+    for (size_t k = 0; k < results.size(); ++k) {
+        if (results[k].empty()) continue;
+        dependencies_[depIndices[k]].matchedPath = results[k];
+        matched.push_back(depIndices[k]);
+    }
+    return matched;
+}
+
+std::string RefCheckerUI::autoMatchDependency(const DependencyInfo& dep)
+{
+    syncLiveIndexes();
+    AutoMatcher::Query query = buildMatchQuery(dep);
+    std::vector<std::string> serviceResults;
+    if (matchViaService({query}, serviceResults)) return serviceResults[0];
+    if (fileCache_.indexes.empty()) return "";
+    return autoMatcher().match(query);
+}
+
+const AutoMatcher& RefCheckerUI::autoMatcher()
+{
+    // Interning every indexed directory is done once per set of indexes.
+    if (!fileCache_.matcher) {
+        fileCache_.matcher = std::make_shared<AutoMatcher>(fileCache_.indexes);
+    }
+    return *fileCache_.matcher;
+}
+
+AutoMatcher::Query RefCheckerUI::buildMatchQuery(const DependencyInfo& dep)
+{
+    AutoMatcher::Query query;
+    query.originalPath = dep.unresolvedPath.empty() ? dep.path : dep.unresolvedPath;
+    query.sequenceKeys = collectSequenceKeys(dep);
+    for (const auto& key : collectMatchKeys(dep)) {
+        AutoMatcher::Key matchKey;
+        matchKey.text = key;
+        matchKey.wildcard = isWildcardPattern(key);
+        query.keys.push_back(std::move(matchKey));
+    }
+
+    // What the file looked like when it was last seen, to tell same-name
+    // candidates apart. MAYA_REF_CHECKER_VERIFY_CONTENT=0 turns this off.
+    const char* env = std::getenv("MAYA_REF_CHECKER_VERIFY_CONTENT");
+    FileRecord record;
+    if (!(env && std::strcmp(env, "0") == 0) && fileRecords_.lookup(dep.path, record)) {
+        query.expectedSize = record.size;
+        query.expectedFingerprint = record.fingerprint;
+    }
+    return query;
 }
 
 std::vector<std::string> RefCheckerUI::collectMatchKeys(const DependencyInfo& dep)
@@ -1835,6 +2127,25 @@ std::vector<std::string> RefCheckerUI::collectMatchKeys(const DependencyInfo& de
     return matchKeys;
 }
 
+std::vector<std::string> RefCheckerUI::collectSequenceKeys(const DependencyInfo& dep)
+{
+    std::vector<std::string> seqKeys;
+    std::set<std::string> seen;
+
+    std::vector<std::string> sourcePaths;
+    if (!dep.unresolvedPath.empty()) sourcePaths.push_back(dep.unresolvedPath);
+    if (!dep.path.empty()) sourcePaths.push_back(dep.path);
+
+    for (const auto& sourcePath : sourcePaths) {
+        std::string seqKey = toSequenceKey(getCleanFilename(sourcePath), dep.type);
+        if (!seqKey.empty() && seen.insert(seqKey).second) {
+            seqKeys.push_back(seqKey);
+        }
+    }
+
+    return seqKeys;
+}
+
 // ============================================================================
 // String / path utilities for matching
 // ============================================================================
@@ -1916,162 +2227,49 @@ std::string RefCheckerUI::toWildcardFilename(
     return "";
 }
 
-bool RefCheckerUI::isWildcardPattern(const std::string& pattern)
+std::string RefCheckerUI::toSequenceKey(
+    const std::string& filename, const std::string& depType)
 {
-    return pattern.find('*') != std::string::npos ||
-           pattern.find('?') != std::string::npos ||
-           pattern.find('[') != std::string::npos;
-}
+    std::string name = lowerString(filename);
+    if (name.empty()) return "";
 
-// Simple glob match: supports * and ? (case-insensitive, both inputs assumed lowercase)
-static bool globMatch(const char* pattern, const char* str)
-{
-    while (*pattern) {
-        if (*pattern == '*') {
-            ++pattern;
-            // Skip consecutive *
-            while (*pattern == '*') ++pattern;
-            if (!*pattern) return true;
-            // Try matching * against 0..N chars
-            for (const char* s = str; *s; ++s) {
-                if (globMatch(pattern, s)) return true;
-            }
-            return globMatch(pattern, str + std::strlen(str)); // match empty tail
-        } else if (*pattern == '?') {
-            if (!*str) return false;
-            ++pattern;
-            ++str;
-        } else {
-            if (*pattern != *str) return false;
-            ++pattern;
-            ++str;
-        }
-    }
-    return *str == '\0';
-}
-
-std::vector<std::string> RefCheckerUI::matchByPattern(const std::string& pattern)
-{
-    std::vector<std::string> matched;
-
-    for (const auto& cachedName : fileCache_.cacheKeys) {
-        if (globMatch(pattern.c_str(), cachedName.c_str())) {
-            auto it = fileCache_.cache.find(cachedName);
-            if (it != fileCache_.cache.end()) {
-                matched.insert(matched.end(),
-                               it->second.begin(), it->second.end());
-            }
+    // A frame token becomes the index's '#' placeholder
+    static const std::vector<std::string> tokens = {
+        "<udim>", "<uvtile>", "{udim}", "{uvtile}",
+        "<f>", "<frame>", "$f4", "$f3", "$f2", "$f1", "$f",
+        "%04d", "%03d", "%02d", "%d",
+        "####", "###", "##", "#"
+    };
+    for (const auto& token : tokens) {
+        size_t pos = name.find(token);
+        if (pos != std::string::npos) {
+            name.replace(pos, token.size(), "#");
+            return name;
         }
     }
 
-    return matched;
-}
-
-std::vector<std::string> RefCheckerUI::dedupePaths(
-    const std::vector<std::string>& paths)
-{
-    std::vector<std::string> unique;
-    std::set<std::string> seen;
-
-    for (const auto& p : paths) {
-        std::string norm = p;
-        norm = lowerString(norm);
-        for (auto& ch : norm) { if (ch == '\\') ch = '/'; }
-
-        if (seen.count(norm) == 0) {
-            seen.insert(norm);
-            unique.push_back(p);
-        }
+    // Numbered textures and caches: FileIndex collapses on the last digit
+    // run, but only a run that looks like a frame (the same [._-] + 3-6
+    // digits + dot rule as toWildcardFilename) is taken as one, so
+    // "wood_v9.png" or "tex_2k.png" never match another version.
+    if (depType == "texture" || depType == "cache") {
+        std::string key = FileIndex::sequenceKey(name);
+        size_t pos = key.find('#');
+        if (pos == std::string::npos) return "";
+        size_t digits = name.size() + 1 - key.size();
+        size_t end = pos + digits;
+        bool frameLike = pos > 0 && (name[pos - 1] == '.' || name[pos - 1] == '_' || name[pos - 1] == '-') &&
+                         digits >= 3 && digits <= 6 && end < name.size() && name[end] == '.';
+        return frameLike ? key : "";
     }
-    return unique;
+    return "";
 }
 
-std::string RefCheckerUI::findBestMatch(
-    const std::string& originalPath,
-    const std::vector<std::string>& candidates)
+bool RefCheckerUI::isWildcardPattern(const std::string& pattern)
 {
-    if (candidates.empty()) return "";
-    if (candidates.size() == 1) return candidates[0];
-
-    // Normalize original path
-    std::string origNorm = originalPath;
-    origNorm = lowerString(origNorm);
-    for (auto& c : origNorm) { if (c == '\\') c = '/'; }
-
-    // Split into parts
-    std::vector<std::string> origParts;
-    {
-        std::istringstream iss(origNorm);
-        std::string part;
-        while (std::getline(iss, part, '/')) {
-            if (!part.empty()) origParts.push_back(part);
-        }
-    }
-    std::string origName = origParts.empty() ? "" : origParts.back();
-    std::string origExt;
-    {
-        size_t dot = origName.rfind('.');
-        if (dot != std::string::npos) origExt = origName.substr(dot);
-    }
-    std::set<std::string> origSet(origParts.begin(), origParts.end());
-
-    int bestScore = -1;
-    int bestTieBreak = 0;
-    std::string bestMatch = candidates[0];
-
-    for (const auto& candidate : candidates) {
-        std::string candNorm = candidate;
-        candNorm = lowerString(candNorm);
-        for (auto& c : candNorm) { if (c == '\\') c = '/'; }
-
-        std::vector<std::string> candParts;
-        {
-            std::istringstream iss(candNorm);
-            std::string part;
-            while (std::getline(iss, part, '/')) {
-                if (!part.empty()) candParts.push_back(part);
-            }
-        }
-        std::string candName = candParts.empty() ? "" : candParts.back();
-        std::string candExt;
-        {
-            size_t dot = candName.rfind('.');
-            if (dot != std::string::npos) candExt = candName.substr(dot);
-        }
-
-        int score = 0;
-        if (candName == origName) score += 120;
-        if (!candExt.empty() && candExt == origExt) score += 25;
-
-        // Suffix directory matching
-        int suffixMatches = 0;
-        int oi = static_cast<int>(origParts.size()) - 2;
-        int ci = static_cast<int>(candParts.size()) - 2;
-        while (oi >= 0 && ci >= 0 && origParts[oi] == candParts[ci]) {
-            ++suffixMatches;
-            --oi;
-            --ci;
-        }
-        score += suffixMatches * 15;
-
-        // Common parts
-        std::set<std::string> candSet(candParts.begin(), candParts.end());
-        int common = 0;
-        for (const auto& p : candSet) {
-            if (origSet.count(p)) ++common;
-        }
-        score += common;
-
-        int tieBreak = -static_cast<int>(candNorm.size());
-
-        if (score > bestScore || (score == bestScore && tieBreak > bestTieBreak)) {
-            bestScore = score;
-            bestTieBreak = tieBreak;
-            bestMatch = candidate;
-        }
-    }
-
-    return bestMatch;
+    return pattern.find('*') != std::string::npos ||
+           pattern.find('?') != std::string::npos ||
+           pattern.find('[') != std::string::npos;
 }
 
 // ============================================================================
@@ -2296,49 +2494,10 @@ bool RefCheckerUI::applyPath(DependencyInfo& dep, const std::string& newPath)
         // Treat a successful load as success even if path comparison query failed.
         return pathUpdated || loaded;
 
-    } else if (depType == "texture") {
-        MString nodeTypeResult;
-        MString ntCmd = MString("nodeType \"") + node.c_str() + "\"";
-        MGlobal::executeCommand(ntCmd, nodeTypeResult);
-        std::string nodeType = toUtf8(nodeTypeResult);
-
-        MString setCmd;
-        if (nodeType == "file") {
-            setCmd = MString("setAttr -type \"string\" \"")
-                + node.c_str() + ".fileTextureName\" \"" + mMayaPath + "\"";
-        } else if (nodeType == "aiImage") {
-            setCmd = MString("setAttr -type \"string\" \"")
-                + node.c_str() + ".filename\" \"" + mMayaPath + "\"";
-        } else {
-            PluginLog::error("RefChecker", "ApplyFix: unknown texture node type: " + nodeType);
-            return false;
-        }
-        MStatus st = MGlobal::executeCommand(setCmd);
-        return (st == MS::kSuccess);
-
-    } else if (depType == "cache") {
-        MString nodeTypeResult;
-        MString ntCmd = MString("nodeType \"") + node.c_str() + "\"";
-        MGlobal::executeCommand(ntCmd, nodeTypeResult);
-        std::string nodeType = toUtf8(nodeTypeResult);
-
-        MString setCmd;
-        if (nodeType == "AlembicNode") {
-            setCmd = MString("setAttr -type \"string\" \"")
-                + node.c_str() + ".abc_File\" \"" + mMayaPath + "\"";
-        } else if (nodeType == "gpuCache") {
-            setCmd = MString("setAttr -type \"string\" \"")
-                + node.c_str() + ".cacheFileName\" \"" + mMayaPath + "\"";
-        } else {
-            PluginLog::error("RefChecker", "ApplyFix: unknown cache node type: " + nodeType);
-            return false;
-        }
-        MStatus st = MGlobal::executeCommand(setCmd);
-        return (st == MS::kSuccess);
-
-    } else if (depType == "audio") {
+    } else if (!dep.attribute.empty()) {
+        // Registry dependency: the path lives in one string attribute.
         MString setCmd = MString("setAttr -type \"string\" \"")
-            + node.c_str() + ".filename\" \"" + mMayaPath + "\"";
+            + node.c_str() + "." + dep.attribute.c_str() + "\" \"" + mMayaPath + "\"";
         MStatus st = MGlobal::executeCommand(setCmd);
         return (st == MS::kSuccess);
     }
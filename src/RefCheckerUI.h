@@ -18,6 +18,11 @@
 #include <QApplication>
 #include <QThread>
 
+#include "AutoMatcher.h"
+#include "FileIndex.h"
+#include "FileRecords.h"
+#include "IndexClient.h"
+#include "LiveFileIndex.h"
 #include "SceneScanner.h"
 
 #include <string>
@@ -26,6 +31,11 @@
 #include <set>
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <utility>
+
+class QProgressDialog;
+class QTimer;
 
 struct FileScanFilter {
     std::set<std::string> exactNames;        // lowercase filenames
@@ -38,7 +48,8 @@ class BatchLocateWorker : public QObject {
 
 public:
     struct Result {
-        std::map<std::string, std::vector<std::string>> cache;
+        std::shared_ptr<FileIndex> index;  // null on failure or cancel
+        bool viaService = false;           // indexed by the shared index service instead
         int scannedCount = 0;
         bool cancelled = false;
     };
@@ -50,6 +61,9 @@ public:
     void requestCancel();
     const Result& result() const;
 
+    // Offer each directory to `stream` as it is indexed (set before run()).
+    void setStreamMatcher(std::shared_ptr<StreamMatcher> stream);
+
 signals:
     void progress(int count);
     void statusText(const QString& text);
@@ -62,6 +76,7 @@ private:
     std::string searchDir_;
     FileScanFilter filter_;
     std::atomic<bool> cancelled_;
+    std::shared_ptr<StreamMatcher> stream_;
     Result result_;
 };
 
@@ -93,38 +108,49 @@ private:
     void refreshList();
     void updateStats();
     void checkAndWarnRisks();
+    void recordFileSizes();
+    void recordAppliedFiles(const std::vector<std::pair<std::string, std::string>>& applied);
     void onBatchLocateDeferred();
+    void onBatchLocateFinished();
+    void applyStreamHits();
     void onLocateSingleDeferred(int depIndex);
 
-    // File cache for batch locate
+    // File cache for batch locate: one persistent FileIndex per search root,
+    // or the roots held by the shared index service (mayaIndexService)
     struct FileCache {
-        std::map<std::string, std::vector<std::string>> cache; // lowercase name -> paths
-        std::vector<std::string> cacheKeys;
-        std::set<std::string> cacheIndex; // normalized paths for dedup
+        std::vector<std::shared_ptr<FileIndex>> indexes;
+        std::vector<std::unique_ptr<LiveFileIndex>> live;  // parallel to indexes; null if not watched
+        std::shared_ptr<AutoMatcher> matcher;  // built on first use, reset when indexes change
+        std::vector<std::pair<std::string, int>> serviceRoots;  // root, file count
+        std::unique_ptr<IndexClient> service;  // main-thread connection, made on first match
         int totalCount;
     };
 
-    int mergeCache(const std::map<std::string, std::vector<std::string>>& newCache);
-    std::pair<std::map<std::string, std::vector<std::string>>, int>
+    int mergeCache(const std::shared_ptr<FileIndex>& index);
+    int mergeServiceRoot(const std::string& root, int fileCount);
+    bool matchViaService(const std::vector<AutoMatcher::Query>& queries, std::vector<std::string>& results);
+    void fallBackFromService();
+    void syncLiveIndexes();
+    std::shared_ptr<FileIndex>
         buildFileCache(const std::string& searchDir,
                        std::function<bool(int)> progressCb = nullptr,
                        const FileScanFilter* filter = nullptr,
                        std::atomic<bool>* cancelFlag = nullptr);
-    int scanDirIntoCache(const std::string& directory,
-                         std::map<std::string, std::vector<std::string>>& cache);
     FileScanFilter buildScanFilter();
 
     // Auto-matching
     void runAutoMatch();
+    std::vector<int> autoMatchMissing(int& missingCount,
+                                      const std::function<bool(int done, int total)>& progress);
     std::string autoMatchDependency(const DependencyInfo& dep);
+    const AutoMatcher& autoMatcher();
+    AutoMatcher::Query buildMatchQuery(const DependencyInfo& dep);
     std::vector<std::string> collectMatchKeys(const DependencyInfo& dep);
+    std::vector<std::string> collectSequenceKeys(const DependencyInfo& dep);
     std::string getCleanFilename(const std::string& path);
     std::string toWildcardFilename(const std::string& filename, const std::string& depType);
+    std::string toSequenceKey(const std::string& filename, const std::string& depType);
     bool isWildcardPattern(const std::string& pattern);
-    std::vector<std::string> matchByPattern(const std::string& pattern);
-    std::vector<std::string> dedupePaths(const std::vector<std::string>& paths);
-    std::string findBestMatch(const std::string& originalPath,
-                              const std::vector<std::string>& candidates);
 
     // Path utilities
     std::string resolvePathForApply(const std::string& rawPath);
@@ -145,10 +171,18 @@ private:
     BatchLocateWorker* scanWorker_;
     bool scanInProgress_;
 
+    // Batch Locate in flight
+    QProgressDialog* locateProgress_;
+    QTimer* locateTimer_;                    // polls locateStream_ for hits
+    std::shared_ptr<StreamMatcher> locateStream_;
+    std::vector<int> locateDeps_;            // dependency index per stream query
+    std::vector<std::pair<int, std::string>> provisional_;  // stream matches applied so far
+
     // Data
     std::vector<DependencyInfo> dependencies_;
     std::vector<std::string> searchDirs_;
     FileCache fileCache_;
+    FileRecords fileRecords_;  // sizes/fingerprints of dependencies seen present
 
     static RefCheckerUI* instance_;
 };
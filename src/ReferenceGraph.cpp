@@ -0,0 +1,380 @@
+#include "ReferenceGraph.h"
+#include "MetadataExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <deque>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+std::string lowerExt(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return "";
+    std::string ext = path.substr(dot);
+    for (auto& c : ext) c = (char)std::tolower((unsigned char)c);
+    return ext;
+}
+
+// References inside scenes are absolute; make root paths given on the
+// command line absolute too so both spellings intern to the same node.
+std::string absoluteRoot(const std::string& path)
+{
+    std::error_code ec;
+    std::filesystem::path abs = std::filesystem::absolute(std::filesystem::u8path(path), ec);
+    return ec ? path : abs.generic_u8string();
+}
+
+bool isSceneExt(const std::string& path)
+{
+    std::string ext = lowerExt(path);
+    return ext == ".ma" || ext == ".mb";
+}
+
+// Result of analyzing one node; filled by a worker thread and merged into
+// the graph on the calling thread.
+struct NodeAnalysis {
+    bool exists = false;
+    bool ok = false;
+    AnalysisSummary summary;
+    std::vector<AnalyzedDep> references;
+    std::vector<AnalyzedDep> textures;
+    std::vector<AnalyzedDep> caches;
+};
+
+} // namespace
+
+ReferenceGraph::ReferenceGraph(unsigned threads)
+    : threads_(threads ? threads : 1)
+{
+}
+
+std::string ReferenceGraph::canonicalKey(const std::string& path)
+{
+    std::string p = path;
+    for (auto& c : p) {
+        if (c == '\\') c = '/';
+    }
+
+    // Keep the root ("/", "//server", "C:/") and collapse "." and ".." in
+    // the rest, so "a/b/../c.ma" and "a/c.ma" are the same node.
+    std::string prefix;
+    size_t pos = 0;
+    if (p.size() >= 2 && p[0] == '/' && p[1] == '/') {
+        prefix = "//";
+        pos = 2;
+    } else if (p.size() >= 2 && std::isalpha((unsigned char)p[0]) && p[1] == ':') {
+        prefix = p.substr(0, 2);
+        pos = 2;
+        if (pos < p.size() && p[pos] == '/') {
+            prefix += '/';
+            ++pos;
+        }
+    } else if (!p.empty() && p[0] == '/') {
+        prefix = "/";
+        pos = 1;
+    }
+
+    std::vector<std::string> parts;
+    while (pos <= p.size()) {
+        size_t next = p.find('/', pos);
+        if (next == std::string::npos) next = p.size();
+        std::string part = p.substr(pos, next - pos);
+        if (part.empty() || part == ".") {
+            // skip
+        } else if (part == ".." && !parts.empty() && parts.back() != "..") {
+            parts.pop_back();
+        } else if (part != ".." || prefix.empty()) {
+            parts.push_back(part);
+        }
+        pos = next + 1;
+    }
+
+    std::string key = prefix;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (i) key += '/';
+        key += parts[i];
+    }
+
+#ifdef _WIN32
+    // NTFS and SMB shares are case-insensitive.
+    for (auto& c : key) c = (char)std::tolower((unsigned char)c);
+#endif
+    return key;
+}
+
+int ReferenceGraph::find(const std::string& path) const
+{
+    auto it = index_.find(canonicalKey(path));
+    return it == index_.end() ? -1 : it->second;
+}
+
+int ReferenceGraph::internNode(const std::string& path)
+{
+    std::string key = canonicalKey(path);
+    auto it = index_.find(key);
+    if (it != index_.end()) return it->second;
+
+    int id = (int)nodes_.size();
+    RefGraphNode node;
+    node.path = path;
+    node.isScene = isSceneExt(path);
+    nodes_.push_back(std::move(node));
+    index_.emplace(std::move(key), id);
+    return id;
+}
+
+void ReferenceGraph::build(const std::vector<std::string>& rootPaths)
+{
+    std::vector<int> frontier;
+    for (const auto& p : rootPaths) {
+        size_t before = nodes_.size();
+        int id = internNode(absoluteRoot(p));
+        if (std::find(roots_.begin(), roots_.end(), id) == roots_.end()) roots_.push_back(id);
+        if ((size_t)id >= before) frontier.push_back(id);
+    }
+
+    expand(std::move(frontier));
+    computeDepths();
+    findCycles();
+}
+
+void ReferenceGraph::expand(std::vector<int> frontier)
+{
+    while (!frontier.empty()) {
+        // Existence of the whole level in one batch on the shared executor,
+        // so a hung mount costs the stat timeout (Unknown) instead of
+        // blocking a worker.
+        std::vector<std::string> paths;
+        paths.reserve(frontier.size());
+        for (int id : frontier) paths.push_back(nodes_[id].path);
+        std::vector<StatResult> stats = MetadataExecutor::shared().statAll(paths);
+
+        // Analyze the whole level in parallel. Workers only read node paths
+        // and write their own slot in `results`.
+        std::vector<NodeAnalysis> results(frontier.size());
+        std::atomic<size_t> next{0};
+
+        auto worker = [&]() {
+            for (;;) {
+                size_t i = next.fetch_add(1);
+                if (i >= frontier.size()) break;
+                const RefGraphNode& node = nodes_[frontier[i]];
+                NodeAnalysis& r = results[i];
+
+                r.exists = stats[i].state == StatResult::Exists;
+                if (!r.exists || !node.isScene) continue;
+
+                FileAnalyzer fa(node.path);
+                fa.setCache(cache_);
+                fa.setMode(mode_);
+                fa.setMemoryLimit(memoryLimit_);
+                r.ok = fa.analyze();
+                r.summary = fa.summary();
+                r.references = std::move(fa.references);
+                r.textures = std::move(fa.textures);
+                r.caches = std::move(fa.caches);
+            }
+        };
+
+        unsigned n = (unsigned)std::min<size_t>(threads_, frontier.size());
+        if (n <= 1) {
+            worker();
+        } else {
+            std::vector<std::thread> pool;
+            pool.reserve(n);
+            for (unsigned t = 0; t < n; ++t) pool.emplace_back(worker);
+            for (auto& t : pool) t.join();
+        }
+
+        // Merge in frontier order so numbering is deterministic.
+        std::vector<int> nextFrontier;
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            int id = frontier[i];
+            NodeAnalysis& r = results[i];
+
+            nodes_[id].exists = r.exists;
+            nodes_[id].unknown = stats[i].state == StatResult::Unknown;
+            nodes_[id].analyzed = r.ok;
+            nodes_[id].summary = std::move(r.summary);
+            nodes_[id].references = std::move(r.references);
+            nodes_[id].textures = std::move(r.textures);
+            nodes_[id].caches = std::move(r.caches);
+            if (r.ok) ++analyzedCount_;
+
+            for (const auto& ref : nodes_[id].references) {
+                size_t before = nodes_.size();
+                int child = internNode(ref.path);
+                nodes_[id].children.push_back(child);
+                ++edgeCount_;
+                if ((size_t)child < before) continue;
+
+                // New node: scenes that exist are analyzed on the next level;
+                // everything else is a leaf whose existence is already known.
+                if (nodes_[child].isScene && ref.exists) {
+                    nextFrontier.push_back(child);
+                } else {
+                    nodes_[child].exists = ref.exists;
+                    nodes_[child].unknown = ref.unknown;
+                }
+            }
+        }
+        frontier.swap(nextFrontier);
+    }
+}
+
+void ReferenceGraph::computeDepths()
+{
+    for (auto& node : nodes_) node.depth = -1;
+
+    std::deque<int> queue;
+    for (int r : roots_) {
+        if (nodes_[r].depth < 0) {
+            nodes_[r].depth = 0;
+            queue.push_back(r);
+        }
+    }
+    while (!queue.empty()) {
+        int id = queue.front();
+        queue.pop_front();
+        for (int child : nodes_[id].children) {
+            if (nodes_[child].depth < 0) {
+                nodes_[child].depth = nodes_[id].depth + 1;
+                queue.push_back(child);
+            }
+        }
+    }
+}
+
+void ReferenceGraph::findCycles()
+{
+    // Iterative DFS; a back edge to a node on the current path closes a
+    // cycle. Each back edge is reported once.
+    cycles_.clear();
+    enum : char { White, Grey, Black };
+    std::vector<char> color(nodes_.size(), White);
+    std::vector<int> path;
+    std::vector<std::pair<int, size_t>> stack;  // node, next child index
+
+    for (int root : roots_) {
+        if (color[root] != White) continue;
+        stack.push_back({root, 0});
+        color[root] = Grey;
+        path.push_back(root);
+
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            const auto& children = nodes_[top.first].children;
+            if (top.second < children.size()) {
+                int child = children[top.second++];
+                if (color[child] == White) {
+                    color[child] = Grey;
+                    path.push_back(child);
+                    stack.push_back({child, 0});
+                } else if (color[child] == Grey) {
+                    auto start = std::find(path.begin(), path.end(), child);
+                    cycles_.emplace_back(start, path.end());
+                }
+            } else {
+                color[top.first] = Black;
+                path.pop_back();
+                stack.pop_back();
+            }
+        }
+    }
+}
+
+std::vector<RefClosureEntry> ReferenceGraph::closure(int node) const
+{
+    std::vector<RefClosureEntry> out;
+    if (node < 0 || node >= (int)nodes_.size()) return out;
+
+    std::vector<char> seen(nodes_.size(), 0);
+    seen[node] = 1;
+    out.push_back({node, 0});
+    for (size_t i = 0; i < out.size(); ++i) {
+        RefClosureEntry cur = out[i];
+        for (int child : nodes_[cur.node].children) {
+            if (!seen[child]) {
+                seen[child] = 1;
+                out.push_back({child, cur.depth + 1});
+            }
+        }
+    }
+    return out;
+}
+
+int ReferenceGraph::closureMissing(const std::vector<RefClosureEntry>& entries) const
+{
+    int missing = 0;
+    for (const auto& e : entries) {
+        const RefGraphNode& n = nodes_[e.node];
+        // Missing references are counted through their own (leaf) nodes.
+        for (const auto& t : n.textures) if (!t.exists && !t.unknown) ++missing;
+        for (const auto& c : n.caches) if (!c.exists && !c.unknown) ++missing;
+        if (!n.exists && !n.unknown) ++missing;
+    }
+    return missing;
+}
+
+std::string ReferenceGraph::getReport(int root) const
+{
+    std::ostringstream oss;
+    std::string sep60(60, '=');
+    std::vector<RefClosureEntry> entries = closure(root);
+    if (entries.empty()) return std::string();
+
+    oss << sep60 << "\n";
+    oss << "Maya Reference Graph Report\n";
+    oss << "File: " << nodes_[root].path << "\n";
+    oss << sep60 << "\n";
+
+    int maxDepth = 0;
+    for (const auto& e : entries) {
+        const RefGraphNode& n = nodes_[e.node];
+        maxDepth = std::max(maxDepth, e.depth);
+
+        std::string indent(2 + 2 * e.depth, ' ');
+        oss << indent << "[" << (n.exists ? "OK" : n.unknown ? "UNKNOWN" : "MISSING") << "] " << n.path;
+        if (n.analyzed) {
+            oss << " (refs " << n.references.size() << ", textures " << n.textures.size()
+                << ", caches " << n.caches.size() << ")";
+        }
+        oss << "\n";
+
+        for (const auto& err : n.summary.errors) {
+            oss << indent << "    [ERROR] " << err << "\n";
+        }
+        for (const auto& t : n.textures) {
+            if (!t.exists) oss << indent << "    [" << (t.unknown ? "UNKNOWN" : "MISSING") << " texture] " << t.path << "\n";
+        }
+        for (const auto& c : n.caches) {
+            if (!c.exists) oss << indent << "    [" << (c.unknown ? "UNKNOWN" : "MISSING") << " cache] " << c.path << "\n";
+        }
+    }
+
+    std::vector<char> inClosure(nodes_.size(), 0);
+    for (const auto& e : entries) inClosure[e.node] = 1;
+    int cyclesHere = 0;
+    for (const auto& cycle : cycles_) {
+        if (inClosure[cycle.front()]) {
+            ++cyclesHere;
+            oss << "\n[Cycle] ";
+            for (int id : cycle) oss << nodes_[id].path << " -> ";
+            oss << nodes_[cycle.front()].path << "\n";
+        }
+    }
+
+    oss << "\n" << sep60 << "\n";
+    oss << "Files in closure: " << entries.size() << "  Max depth: " << maxDepth;
+    if (cyclesHere) oss << "  Cycles: " << cyclesHere;
+    oss << "\n";
+    oss << "Total Missing: " << closureMissing(entries) << "\n";
+    oss << sep60 << "\n";
+    return oss.str();
+}
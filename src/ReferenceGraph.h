@@ -0,0 +1,108 @@
+#pragma once
+#ifndef REFERENCEGRAPH_H
+#define REFERENCEGRAPH_H
+
+#include "FileAnalyzer.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One file in the reference graph. Scene files (.ma/.mb) that exist are
+// analyzed exactly once; other references (.abc/.fbx, missing files) are
+// leaves.
+struct RefGraphNode {
+    std::string path;
+    int depth = -1;         // shortest reference distance from any root (roots are 0)
+    bool exists = false;
+    bool unknown = false;   // existence check timed out
+    bool isScene = false;   // .ma / .mb
+    bool analyzed = false;  // FileAnalyzer ran and succeeded
+
+    AnalysisSummary summary;            // valid when isScene && exists
+    std::vector<AnalyzedDep> references;
+    std::vector<AnalyzedDep> textures;
+    std::vector<AnalyzedDep> caches;
+    std::vector<int> children;          // node indices, in reference order
+};
+
+struct RefClosureEntry {
+    int node;
+    int depth;   // distance from the root of this closure
+};
+
+// Transitive reference graph over Maya scenes.
+//
+// Every distinct file (compared by a lexically normalized path,
+// case-insensitive on Windows) becomes one node and is analyzed once, no
+// matter how many shots reference it. Results are memoized across build()
+// calls, so adding a sequence of shots that share sets and rigs costs about
+// the number of distinct files, not the number of edges.
+//
+// Expansion is breadth-first; each level is analyzed on a pool of worker
+// threads and merged in a fixed order, so node numbering and reports do not
+// depend on scheduling.
+class ReferenceGraph {
+public:
+    explicit ReferenceGraph(unsigned threads = 1);
+
+    // Optional persistent parse cache (not owned), passed to every
+    // FileAnalyzer the graph runs.
+    void setCache(AnalysisCache* cache) { cache_ = cache; }
+
+    // What each FileAnalyzer extracts. In the header-only modes nodes carry
+    // no textures or caches, only the reference edges.
+    void setMode(AnalysisMode mode) { mode_ = mode; }
+
+    // Per-analysis .ma memory ceiling, see FileAnalyzer::setMemoryLimit().
+    void setMemoryLimit(size_t bytes) { memoryLimit_ = bytes; }
+
+    // Add root scenes (relative paths are made absolute) and expand
+    // everything they reference.
+    void build(const std::vector<std::string>& rootPaths);
+
+    const std::vector<RefGraphNode>& nodes() const { return nodes_; }
+    const std::vector<int>& roots() const { return roots_; }
+
+    // Each cycle is a list of node indices a -> b -> ... -> a (the first node
+    // is not repeated at the end).
+    const std::vector<std::vector<int>>& cycles() const { return cycles_; }
+
+    // Node index for a path, or -1.
+    int find(const std::string& path) const;
+
+    // All nodes reachable from a node (including itself), each once, in
+    // breadth-first order with the depth relative to that node.
+    std::vector<RefClosureEntry> closure(int node) const;
+
+    // Number of missing references/textures/caches over a closure; each
+    // file is counted once even if reached through several paths.
+    int closureMissing(const std::vector<RefClosureEntry>& entries) const;
+
+    int analyzedCount() const { return analyzedCount_; }
+    int edgeCount() const { return edgeCount_; }
+
+    // Text report for one root, in the style of FileAnalyzer::getReport().
+    std::string getReport(int root) const;
+
+    static std::string canonicalKey(const std::string& path);
+
+private:
+    int internNode(const std::string& path);
+    void expand(std::vector<int> frontier);
+    void computeDepths();
+    void findCycles();
+
+    unsigned threads_;
+    AnalysisCache* cache_ = nullptr;
+    AnalysisMode mode_ = AnalysisMode::Full;
+    size_t memoryLimit_ = FileAnalyzer::kDefaultMemoryLimit;
+    std::vector<RefGraphNode> nodes_;
+    std::vector<int> roots_;
+    std::vector<std::vector<int>> cycles_;
+    std::unordered_map<std::string, int> index_;
+    int analyzedCount_ = 0;
+    int edgeCount_ = 0;
+};
+
+#endif // REFERENCEGRAPH_H
@@ -1,4 +1,5 @@
 #include "SafeLoaderUI.h"
+#include "MetadataExecutor.h"
 #include "PluginLog.h"
 #include "SceneScanner.h"
 
@@ -7,7 +8,6 @@
 #include <maya/MString.h>
 #include <maya/MStringArray.h>
 
-#include <QFileInfo>
 #include <QByteArray>
 #include <QStringList>
 
@@ -58,12 +58,6 @@ static std::string qStringToUtf8(const QString& s) {
     return std::string(u8.constData(), static_cast<size_t>(u8.size()));
 }
 
-static QFileInfo resolvedFileInfo(const std::string& rawPath)
-{
-    const std::string resolved = SceneScanner::resolveSceneRelative(rawPath);
-    return QFileInfo(utf8ToQString(resolved.empty() ? rawPath : resolved));
-}
-
 // ============================================================================
 // Static members
 // ============================================================================
@@ -241,16 +235,41 @@ void SafeLoaderUI::scanReferences()
         MGlobal::executeCommand(loadCmd, loaded);
         entry.isLoaded = (loaded != 0);
 
-        // Check file existence and size using the resolved on-disk path.
-        // Maya may return unresolved paths with env-vars, scene-relative
-        // segments, or reference copy-number suffixes such as {1}. Using the
-        // raw string here can incorrectly mark valid references as missing.
-        QFileInfo fi = resolvedFileInfo(entry.filePath);
-        entry.fileExists = fi.exists();
-        entry.fileSize = fi.exists() ? fi.size() : 0;
-
+        entry.fileExists = false;
+        entry.unknown = false;
+        entry.fileSize = 0;
         refs_.push_back(entry);
     }
+
+    std::vector<size_t> rows(refs_.size());
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = i;
+    checkExistence(rows);
+}
+
+void SafeLoaderUI::checkExistence(const std::vector<size_t>& rows)
+{
+    if (rows.empty()) return;
+
+    // Check existence and size using the resolved on-disk path. Maya may
+    // return unresolved paths with env-vars, scene-relative segments, or
+    // reference copy-number suffixes such as {1}; using the raw string can
+    // incorrectly mark valid references as missing. All references are
+    // checked in one parallel batch so a slow or dead share cannot hang the
+    // dialog for longer than the executor deadline; those come back as
+    // unknown, never as missing.
+    std::vector<std::string> paths;
+    paths.reserve(rows.size());
+    for (size_t row : rows) {
+        const RefEntry& ref = refs_[row];
+        paths.push_back(ref.resolvedPath.empty() ? ref.filePath : ref.resolvedPath);
+    }
+    std::vector<StatResult> results = MetadataExecutor::shared().statAll(paths);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        RefEntry& ref = refs_[rows[i]];
+        ref.fileExists = results[i].state == StatResult::Exists;
+        ref.unknown = results[i].state == StatResult::Unknown;
+        ref.fileSize = results[i].size;
+    }
 }
 
 // ============================================================================
@@ -266,6 +285,7 @@ void SafeLoaderUI::refreshTable()
 
     int loadedCount = 0;
     int missingCount = 0;
+    int unknownCount = 0;
 
     for (int row = 0; row < rowCount; ++row) {
         const RefEntry& ref = refs_[row];
@@ -302,9 +322,15 @@ void SafeLoaderUI::refreshTable()
             existsItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
             tableWidget_->setItem(row, 2, existsItem);
         }
+        existsItem->setToolTip(QString());
         if (ref.fileExists) {
             existsItem->setText("Yes");
             existsItem->setForeground(QBrush(QColor(50, 160, 50)));
+        } else if (ref.unknown) {
+            existsItem->setText("UNKNOWN");
+            existsItem->setForeground(QBrush(QColor(180, 130, 50)));
+            existsItem->setToolTip("Storage did not answer in time; existence was not checked.");
+            ++unknownCount;
         } else {
             existsItem->setText("No");
             existsItem->setForeground(QBrush(QColor(200, 50, 50)));
@@ -355,6 +381,7 @@ void SafeLoaderUI::refreshTable()
         .arg(loadedCount)
         .arg(rowCount - loadedCount)
         .arg(missingCount);
+    if (unknownCount > 0) statusText += QString(" | Unknown: %1").arg(unknownCount);
     statusLabel_->setText(statusText);
 }
 
@@ -386,7 +413,7 @@ void SafeLoaderUI::onLoadSelected()
         RefEntry& ref = refs_[row];
         if (ref.isLoaded) continue;
         if (ref.refNode.empty()) continue;
-        if (!ref.fileExists) {
+        if (!ref.fileExists && !ref.unknown) {
             ++skippedMissing;
             PluginLog::warn("SafeLoader", "Skip missing ref: " + ref.filePath);
             continue;
@@ -431,7 +458,7 @@ void SafeLoaderUI::onLoadAll()
     for (auto& ref : refs_) {
         if (ref.isLoaded) continue;
         if (ref.refNode.empty()) continue;
-        if (!ref.fileExists) continue;
+        if (!ref.fileExists && !ref.unknown) continue;
         ++total;
     }
 
@@ -444,7 +471,7 @@ void SafeLoaderUI::onLoadAll()
     for (auto& ref : refs_) {
         if (ref.isLoaded) continue;
         if (ref.refNode.empty()) continue;
-        if (!ref.fileExists) {
+        if (!ref.fileExists && !ref.unknown) {
             ++skippedMissing;
             PluginLog::warn("SafeLoader", "Skip missing ref: " + ref.filePath);
             continue;
@@ -512,10 +539,10 @@ void SafeLoaderUI::onUnloadAll()
 
 void SafeLoaderUI::onRemoveMissing()
 {
-    // Count missing
+    // Count missing (unknown references are never removed)
     int missingCount = 0;
     for (const auto& ref : refs_) {
-        if (!ref.fileExists) ++missingCount;
+        if (!ref.fileExists && !ref.unknown) ++missingCount;
     }
 
     if (missingCount == 0) {
@@ -532,11 +559,21 @@ void SafeLoaderUI::onRemoveMissing()
         QMessageBox::Ok | QMessageBox::Cancel);
     if (confirm != QMessageBox::Ok) return;
 
+    // Check the candidates again right before removing them: the scan may be
+    // stale, and a share may have come back since.
+    {
+        std::vector<size_t> rows;
+        for (size_t i = 0; i < refs_.size(); ++i) {
+            if (!refs_[i].fileExists && !refs_[i].unknown) rows.push_back(i);
+        }
+        checkExistence(rows);
+    }
+
     int removed = 0;
     // Iterate in reverse so removal doesn't invalidate indices
     for (int i = static_cast<int>(refs_.size()) - 1; i >= 0; --i) {
         RefEntry& ref = refs_[i];
-        if (ref.fileExists) continue;
+        if (ref.fileExists || ref.unknown) continue;
         if (ref.refNode.empty()) continue;
 
         PluginLog::info("SafeLoader", "Removing missing ref: " + ref.filePath);
@@ -556,5 +593,9 @@ void SafeLoaderUI::onRemoveMissing()
     refreshTable();
 
     QString msg = QString("Removed %1 missing reference(s).").arg(removed);
+    if (removed < missingCount) {
+        msg += QString("\n%1 reference(s) were kept: found again, unknown or not removable.")
+            .arg(missingCount - removed);
+    }
     QMessageBox::information(this, "Remove Missing", msg);
 }
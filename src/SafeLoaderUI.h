@@ -21,6 +21,7 @@ struct RefEntry {
     std::string resolvedPath;
     bool isLoaded;
     bool fileExists;
+    bool unknown;       // existence check timed out (fileExists is false)
     qint64 fileSize;
 };
 
@@ -44,6 +45,7 @@ private slots:
 private:
     void setupUI();
     void scanReferences();
+    void checkExistence(const std::vector<size_t>& rows);
     void refreshTable();
 
     QTableWidget* tableWidget_;
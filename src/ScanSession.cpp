@@ -0,0 +1,104 @@
+#include "ScanSession.h"
+
+namespace {
+
+// Cache key of a query with several arguments; node and type names never
+// contain a newline.
+std::string key(const std::string& a, const std::string& b)
+{
+    return a + '\n' + b;
+}
+
+} // namespace
+
+ScanSession::ScanSession(const SceneQuery& scene)
+    : scene_(scene)
+{
+}
+
+template <typename T, typename Fetch>
+const T& ScanSession::memo(std::unordered_map<std::string, T>& cache, const std::string& key,
+                           Fetch&& fetch) const
+{
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        ++hits_;
+        return it->second;
+    }
+    ++queries_;
+    return cache.emplace(key, fetch()).first->second;
+}
+
+std::vector<std::string> ScanSession::nodesOfType(const std::string& type) const
+{
+    return memo(nodesOfType_, type, [&]() { return scene_.nodesOfType(type); });
+}
+
+SceneQuery::DagForest ScanSession::dagForest(const std::string& type) const
+{
+    return memo(forests_, type, [&]() { return scene_.dagForest(type); });
+}
+
+std::string ScanSession::nodeType(const std::string& node) const
+{
+    return memo(nodeTypes_, node, [&]() { return scene_.nodeType(node); });
+}
+
+std::string ScanSession::parent(const std::string& dagNode, const std::string& type) const
+{
+    return memo(parents_, key(dagNode, type), [&]() { return scene_.parent(dagNode, type); });
+}
+
+std::vector<std::string> ScanSession::children(const std::string& dagNode, const std::string& type) const
+{
+    return memo(children_, key(dagNode, type), [&]() { return scene_.children(dagNode, type); });
+}
+
+std::vector<std::string> ScanSession::descendants(const std::string& dagNode, const std::string& type) const
+{
+    return memo(descendants_, key(dagNode, type), [&]() { return scene_.descendants(dagNode, type); });
+}
+
+std::vector<std::string> ScanSession::connections(const std::string& node, const std::string& type,
+                                                  bool source, bool destination) const
+{
+    std::string k = key(node, type) + (source ? "\ns" : "\n-") + (destination ? "d" : "-");
+    return memo(connections_, k, [&]() { return scene_.connections(node, type, source, destination); });
+}
+
+bool ScanSession::history(const std::string& node, std::vector<std::string>& out) const
+{
+    const std::pair<bool, Names>& result = memo(histories_, node, [&]() {
+        std::pair<bool, Names> r;
+        r.first = scene_.history(node, r.second);
+        return r;
+    });
+    out = result.second;
+    return result.first;
+}
+
+std::vector<std::string> ScanSession::deformedGeometry(const std::string& deformer) const
+{
+    return memo(deformed_, deformer, [&]() { return scene_.deformedGeometry(deformer); });
+}
+
+std::vector<std::string> ScanSession::elementNames(const std::string& node, const std::string& multiAttr) const
+{
+    return memo(elementNames_, key(node, multiAttr), [&]() { return scene_.elementNames(node, multiAttr); });
+}
+
+bool ScanSession::getString(const std::string& node, const std::string& attr, std::string& value) const
+{
+    const std::pair<bool, std::string>& result = memo(strings_, key(node, attr), [&]() {
+        std::pair<bool, std::string> r;
+        r.first = scene_.getString(node, attr, r.second);
+        return r;
+    });
+    if (result.first) value = result.second;
+    return result.first;
+}
+
+bool ScanSession::isStartupCamera(const std::string& cameraShape) const
+{
+    return memo(startupCameras_, cameraShape, [&]() { return scene_.isStartupCamera(cameraShape); });
+}
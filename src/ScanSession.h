@@ -0,0 +1,66 @@
+#pragma once
+#ifndef SCANSESSION_H
+#define SCANSESSION_H
+
+#include "SceneQuery.h"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// SceneQuery that remembers every answer of the scene it wraps, so the
+// steps of one export (batch bake, frame-range log) share joint lists,
+// mesh histories and blendShape weight aliases instead of each asking the
+// scene again. (Scan Scene reads a SceneSnapshot instead.)
+//
+// A session assumes the facts it has answered do not change while it lives:
+// create one per export and drop it afterwards. Not thread-safe (like
+// MayaSceneQuery, main thread only).
+class ScanSession : public SceneQuery {
+public:
+    explicit ScanSession(const SceneQuery& scene);
+
+    // Calls forwarded to the wrapped scene / answered from the session.
+    size_t queryCount() const { return queries_; }
+    size_t hitCount() const { return hits_; }
+
+    std::vector<std::string> nodesOfType(const std::string& type) const override;
+    DagForest dagForest(const std::string& type) const override;
+    std::string nodeType(const std::string& node) const override;
+    std::string parent(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> children(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> descendants(const std::string& dagNode, const std::string& type = "") const override;
+    std::vector<std::string> connections(const std::string& node, const std::string& type,
+                                         bool source, bool destination) const override;
+    bool history(const std::string& node, std::vector<std::string>& out) const override;
+    std::vector<std::string> deformedGeometry(const std::string& deformer) const override;
+    std::vector<std::string> elementNames(const std::string& node, const std::string& multiAttr) const override;
+    bool getString(const std::string& node, const std::string& attr, std::string& value) const override;
+    bool isStartupCamera(const std::string& cameraShape) const override;
+
+private:
+    using Names = std::vector<std::string>;
+
+    template <typename T, typename Fetch>
+    const T& memo(std::unordered_map<std::string, T>& cache, const std::string& key, Fetch&& fetch) const;
+
+    const SceneQuery& scene_;
+    mutable std::unordered_map<std::string, Names> nodesOfType_;
+    mutable std::unordered_map<std::string, DagForest> forests_;
+    mutable std::unordered_map<std::string, std::string> nodeTypes_;
+    mutable std::unordered_map<std::string, std::string> parents_;
+    mutable std::unordered_map<std::string, Names> children_;
+    mutable std::unordered_map<std::string, Names> descendants_;
+    mutable std::unordered_map<std::string, Names> connections_;
+    mutable std::unordered_map<std::string, std::pair<bool, Names>> histories_;
+    mutable std::unordered_map<std::string, Names> deformed_;
+    mutable std::unordered_map<std::string, Names> elementNames_;
+    mutable std::unordered_map<std::string, std::pair<bool, std::string>> strings_;
+    mutable std::unordered_map<std::string, bool> startupCameras_;
+    mutable size_t queries_ = 0;
+    mutable size_t hits_ = 0;
+};
+
+#endif // SCANSESSION_H
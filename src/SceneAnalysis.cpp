@@ -0,0 +1,306 @@
+#include "SceneAnalysis.h"
+#include "SceneQuery.h"
+#include "SceneSnapshot.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace SceneAnalysis {
+
+std::string shortName(const std::string& fullPath)
+{
+    size_t pos = fullPath.rfind('|');
+    return (pos != std::string::npos) ? fullPath.substr(pos + 1) : fullPath;
+}
+
+std::string bareName(const std::string& name)
+{
+    size_t pos = name.rfind(':');
+    return (pos != std::string::npos) ? name.substr(pos + 1) : name;
+}
+
+std::string namespaceOf(const std::string& shortName)
+{
+    size_t lastColon = shortName.rfind(':');
+    if (lastColon == std::string::npos) return "";
+    std::string ns = shortName.substr(0, lastColon);
+    size_t prevColon = ns.rfind(':');
+    return (prevColon != std::string::npos) ? ns.substr(prevColon + 1) : ns;
+}
+
+std::vector<std::string> blendShapeWeightAttrs(const SceneQuery& scene, const std::string& blendShape)
+{
+    std::vector<std::string> attrs = scene.elementNames(blendShape, "weight");
+    for (auto& a : attrs) a = blendShape + "." + a;
+    return attrs;
+}
+
+std::vector<CameraInfo> findNonDefaultCameras(const SceneQuery& scene)
+{
+    std::vector<CameraInfo> result;
+
+    static const std::set<std::string> defaultCams = {
+        "persp", "top", "front", "side", "back", "bottom", "left", "right"
+    };
+    static const std::set<std::string> defaultShapes = {
+        "perspShape", "topShape", "frontShape", "sideShape",
+        "backShape", "bottomShape", "leftShape", "rightShape"
+    };
+
+    for (const auto& camShape : scene.nodesOfType("camera")) {
+        std::string transform = scene.parent(camShape);
+        if (transform.empty()) continue;
+
+        std::string sn = shortName(transform);
+        if (defaultCams.count(bareName(sn))) continue;
+        if (defaultShapes.count(bareName(shortName(camShape)))) continue;
+        if (scene.isStartupCamera(camShape)) continue;
+
+        CameraInfo info;
+        info.transform = transform;
+        info.display = sn;
+        result.push_back(info);
+    }
+
+    return result;
+}
+
+namespace {
+
+bool isRootName(const std::string& bare)
+{
+    static const char kRoot[] = "root";
+    if (bare.size() != sizeof(kRoot) - 1) return false;
+    for (size_t i = 0; i < bare.size(); ++i) {
+        if (tolower(static_cast<unsigned char>(bare[i])) != kRoot[i]) return false;
+    }
+    return true;
+}
+
+// Node ids ordered by full path, each once.
+std::vector<int32_t> sortedByPath(const SceneSnapshot& snap, std::vector<int32_t> ids)
+{
+    std::vector<std::pair<std::string, int32_t>> keyed;
+    keyed.reserve(ids.size());
+    for (int32_t n : ids) keyed.emplace_back(snap.path(n), n);
+    std::sort(keyed.begin(), keyed.end());
+    keyed.erase(std::unique(keyed.begin(), keyed.end()), keyed.end());
+    ids.clear();
+    for (const auto& k : keyed) ids.push_back(k.second);
+    return ids;
+}
+
+} // namespace
+
+std::vector<CharacterInfo> findCharacters(const SceneSnapshot& snap)
+{
+    using NodeType = SceneSnapshot::NodeType;
+    std::vector<CharacterInfo> result;
+
+    // Descendant joint counts, summed up the parent links in one reverse
+    // pass (descendants come after their ancestors).
+    const int32_t n = snap.dagCount();
+    std::vector<uint32_t> descendants(n, 0);
+    for (int32_t i = n; i-- > 0;) {
+        int32_t p = snap.parent(i);
+        if (p >= 0) descendants[p] += descendants[i] + (snap.type(i) == NodeType::Joint ? 1 : 0);
+    }
+
+    // Pick the best root joint (no joint parent) for export in each namespace.
+    // Prefer a root whose bare name is "root" (case-insensitive) — this is the
+    // standard UE export skeleton in rigs that have multiple skeleton hierarchies
+    // (e.g. DeformationSystem/Root_M, FitSkeleton/Root1, and the export skeleton "root").
+    // Fall back to the root with the most descendants if none is named "root".
+    struct Best {
+        int32_t joint;
+        bool isRootNamed;
+    };
+    std::map<std::string, Best> nsMap;
+    for (int32_t i = 0; i < n; ++i) {
+        if (snap.type(i) != NodeType::Joint) continue;
+        int32_t p = snap.parent(i);
+        if (p >= 0 && snap.type(p) == NodeType::Joint) continue;
+
+        bool isRootNamed = isRootName(snap.bareName(i));
+        auto it = nsMap.find(snap.nameSpace(i));
+        if (it == nsMap.end()) {
+            nsMap.emplace(snap.nameSpace(i), Best{i, isRootNamed});
+            continue;
+        }
+        // Prefer "root"-named joint; among same priority, prefer most descendants
+        Best& best = it->second;
+        if ((isRootNamed && !best.isRootNamed) ||
+            (isRootNamed == best.isRootNamed && descendants[i] > descendants[best.joint])) {
+            best = Best{i, isRootNamed};
+        }
+    }
+
+    for (const auto& kv : nsMap) {
+        const std::string& ns = kv.first;
+        int32_t root = kv.second.joint;
+
+        CharacterInfo info;
+        info.rootJoint = snap.path(root);
+        info.nsOrName = ns.empty() ? snap.bareName(root) : ns;
+        info.display = snap.name(root);
+        result.push_back(info);
+    }
+
+    return result;
+}
+
+std::vector<BlendShapeGroupInfo> findBlendShapeGroups(const SceneSnapshot& snap)
+{
+    std::vector<BlendShapeGroupInfo> result;
+
+    struct NsEntry {
+        int32_t mesh;
+        size_t weightCount;
+    };
+    std::map<std::string, NsEntry> nsMap; // namespace -> best mesh (highest weightCount)
+
+    for (int32_t bs = snap.dagCount(); bs < snap.size(); ++bs) {
+        if (snap.type(bs) != SceneSnapshot::NodeType::BlendShape) continue;
+        size_t weightCount = snap.weights(bs).size();
+
+        for (int32_t geo : snap.deformed(bs)) {
+            int32_t transform = snap.parent(geo);
+            if (transform < 0) continue;
+
+            const std::string& ns = snap.nameSpace(transform);
+            auto it = nsMap.find(ns);
+            if (it == nsMap.end() || weightCount > it->second.weightCount) {
+                nsMap[ns] = {transform, weightCount};
+            }
+        }
+    }
+
+    for (auto& kv : nsMap) {
+        const std::string& ns = kv.first;
+        int32_t mesh = kv.second.mesh;
+
+        BlendShapeGroupInfo info;
+        info.mesh = snap.path(mesh);
+
+        if (!ns.empty()) {
+            info.nsOrName = ns;
+            info.display = ns + ":* (BlendShape)";
+        } else {
+            info.nsOrName = snap.bareName(mesh);
+            info.display = snap.name(mesh) + " (BlendShape)";
+        }
+
+        result.push_back(info);
+    }
+
+    return result;
+}
+
+std::vector<SkeletonBlendShapeInfo> findSkeletonBlendShapeCombos(const SceneSnapshot& snap,
+                                                                 const std::vector<CharacterInfo>& characters)
+{
+    using NodeType = SceneSnapshot::NodeType;
+    std::vector<SkeletonBlendShapeInfo> result;
+    std::vector<uint8_t> mark(snap.size(), 0);
+
+    for (const auto& ch : characters) {
+        int32_t root = snap.find(ch.rootJoint);
+        if (root < 0 || !snap.isDag(root)) continue;
+
+        // skinClusters connected to the joints of this character
+        std::vector<int32_t> skinClusters;
+        for (int32_t j = root; j < snap.subtreeEnd(root); ++j) {
+            if (snap.type(j) != NodeType::Joint) continue;
+            for (int32_t c : snap.connections(j)) {
+                if (snap.type(c) == NodeType::SkinCluster && !mark[c]) {
+                    mark[c] = 1;
+                    skinClusters.push_back(c);
+                }
+            }
+        }
+        for (int32_t c : skinClusters) mark[c] = 0;
+
+        // For each skinCluster, get the output mesh transforms
+        std::vector<int32_t> skinned;
+        for (int32_t skin : skinClusters) {
+            for (int32_t geo : snap.deformed(skin)) {
+                if (snap.type(geo) == NodeType::Mesh) {
+                    if (snap.parent(geo) >= 0) skinned.push_back(snap.parent(geo));
+                } else if (snap.type(geo) == NodeType::Transform) {
+                    skinned.push_back(geo);
+                }
+            }
+        }
+        skinned = sortedByPath(snap, std::move(skinned));
+
+        // For each skinned mesh, check if it also has a blendShape deformer
+        std::vector<std::string> bsMeshes;
+        std::vector<std::string> bsNodes;
+        std::vector<std::string> bsWeightAttrs;
+        std::vector<int32_t> seenBsNodes;
+
+        // blendShapes deforming the transform or one of its shapes.
+        auto scanMeshForBS = [&](int32_t meshXform) {
+            bool meshHasBS = false;
+            auto scanGeometry = [&](int32_t geo) {
+                for (int32_t bs : snap.deformers(geo)) {
+                    if (snap.type(bs) != NodeType::BlendShape) continue;
+                    meshHasBS = true;
+                    if (!mark[bs]) {
+                        mark[bs] = 1;
+                        seenBsNodes.push_back(bs);
+                        bsNodes.push_back(snap.name(bs));
+                    }
+                    for (int32_t w : snap.weights(bs)) bsWeightAttrs.push_back(snap.name(bs) + "." + snap.string(w));
+                }
+            };
+            scanGeometry(meshXform);
+            for (int32_t c : snap.children(meshXform)) {
+                if (snap.type(c) != NodeType::Transform && snap.type(c) != NodeType::Joint) scanGeometry(c);
+            }
+            if (meshHasBS) bsMeshes.push_back(snap.path(meshXform));
+        };
+
+        for (int32_t meshXform : skinned) {
+            scanMeshForBS(meshXform);
+        }
+
+        // Also scan non-skinned meshes under the character hierarchy for blendShape.
+        // These may be constrained or parented to the skeleton without a skinCluster.
+        int32_t rootTop = root;
+        while (snap.parent(rootTop) >= 0) rootTop = snap.parent(rootTop);
+
+        for (int32_t t : skinned) mark[t] = 1;
+        std::vector<int32_t> nonSkinned;
+        for (int32_t m = rootTop + 1; m < snap.subtreeEnd(rootTop); ++m) {
+            if (snap.type(m) != NodeType::Mesh) continue;
+            int32_t parent = snap.parent(m);
+            if (parent >= 0 && !mark[parent]) nonSkinned.push_back(parent);
+        }
+        for (int32_t t : skinned) mark[t] = 0;
+        for (int32_t meshXform : sortedByPath(snap, std::move(nonSkinned))) {
+            scanMeshForBS(meshXform);
+        }
+        for (int32_t bs : seenBsNodes) mark[bs] = 0;
+
+        // Only create a combo entry if at least one mesh has BS
+        if (!bsMeshes.empty()) {
+            SkeletonBlendShapeInfo info;
+            info.rootJoint     = ch.rootJoint;
+            info.nsOrName      = ch.nsOrName;
+            info.display       = ch.display + " (Skel+BS)";
+            info.bsMeshes      = bsMeshes;
+            info.bsNodes       = bsNodes;
+            info.bsWeightAttrs = bsWeightAttrs;
+            result.push_back(info);
+        }
+    }
+
+    return result;
+}
+
+} // namespace SceneAnalysis
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef SCENEANALYSIS_H
+#define SCENEANALYSIS_H
+
+#include <string>
+#include <vector>
+
+class SceneQuery;
+class SceneSnapshot;
+
+struct CameraInfo {
+    std::string transform; // full DAG path
+    std::string display;   // short display name
+};
+
+struct CharacterInfo {
+    std::string rootJoint;  // full DAG path of main root joint
+    std::string nsOrName;   // namespace or bare joint name
+    std::string display;    // human-readable label
+};
+
+struct BlendShapeGroupInfo {
+    std::string mesh;       // first mesh transform with blendShape
+    std::string nsOrName;   // namespace or bare mesh name
+    std::string display;    // human-readable label
+};
+
+struct SkeletonBlendShapeInfo {
+    std::string rootJoint;              // skeleton root joint full DAG path
+    std::string nsOrName;               // namespace or bare name
+    std::string display;                // human-readable label
+    std::vector<std::string> bsMeshes;  // skinned meshes that also have blendShape
+    std::vector<std::string> bsNodes;   // blendShape deformer node names
+    std::vector<std::string> bsWeightAttrs; // all BS weight attributes (for bake)
+};
+
+// Export-target discovery for the Batch Exporter. Cameras are read
+// through SceneQuery; characters, blendShape groups and skeleton+blendShape
+// combos run over a SceneSnapshot of it. Both work on the live scene
+// (MayaSceneQuery) or an in-memory one (MemorySceneQuery). SceneScanner
+// wraps these for the plugin.
+namespace SceneAnalysis {
+
+    std::vector<CameraInfo> findNonDefaultCameras(const SceneQuery& scene);
+
+    // One character per namespace: its root joint named "root" if there is
+    // one, else the root joint with the most descendant joints.
+    std::vector<CharacterInfo> findCharacters(const SceneSnapshot& snap);
+
+    // The mesh with the most blendShape weights in each namespace.
+    std::vector<BlendShapeGroupInfo> findBlendShapeGroups(const SceneSnapshot& snap);
+
+    // Characters whose skinned meshes (or other meshes under the character's
+    // top group) have blendShape deformers, with every weight attribute.
+    std::vector<SkeletonBlendShapeInfo> findSkeletonBlendShapeCombos(const SceneSnapshot& snap,
+                                                                     const std::vector<CharacterInfo>& characters);
+
+    // "node.alias" (or "node.weight[i]") for every weight of a blendShape.
+    std::vector<std::string> blendShapeWeightAttrs(const SceneQuery& scene, const std::string& blendShape);
+
+    // DAG path helpers.
+    std::string shortName(const std::string& fullPath);
+    std::string bareName(const std::string& name);
+    // Innermost namespace of a short name: "B" for "A:B:node", "" for "node".
+    std::string namespaceOf(const std::string& shortName);
+
+} // namespace SceneAnalysis
+
+#endif // SCENEANALYSIS_H
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef SCENEQUERY_H
+#define SCENEQUERY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only access to the scene graph for the scanners and the exporter.
+//
+// DAG nodes are named by full path ("|grp|ns:root"), other nodes by their
+// unique name, the way `ls -long` prints them. Type names are Maya node type
+// names; a type filter also matches derived types (as `ls -type` and
+// `listRelatives -type` do), and "" matches every node.
+//
+// MayaSceneQuery answers through the API (MItDag, MItDependencyNodes,
+// MFnDagNode, MPlug) instead of formatting, parsing and marshalling a MEL
+// command per call. MemorySceneQuery is an in-memory scene that the same
+// analyses run against without Maya.
+class SceneQuery {
+public:
+    // Every DAG node of one type from a single depth-first traversal, as
+    // flat arrays in traversal order. An ancestor always comes before its
+    // descendants, so subtree sums are one reverse pass.
+    struct DagForest {
+        std::vector<std::string> paths;
+        std::vector<int32_t> ancestor;      // nearest ancestor of the type, -1 if none
+        std::vector<uint8_t> parentIsType;  // the direct parent is of the type
+    };
+
+    virtual ~SceneQuery() = default;
+
+    // Every node of a type (`ls -type <type> -long`).
+    virtual std::vector<std::string> nodesOfType(const std::string& type) const = 0;
+
+    // DagForest of `type` (derived types included), one query for the
+    // whole scene instead of a parent/descendant query per node.
+    virtual DagForest dagForest(const std::string& type) const = 0;
+
+    // Exact type of a node (`nodeType`), "" if there is no such node.
+    virtual std::string nodeType(const std::string& node) const = 0;
+
+    // DAG parent if it is of `type` (`listRelatives -parent -type`), "" for
+    // a node under the world.
+    virtual std::string parent(const std::string& dagNode, const std::string& type = "") const = 0;
+
+    // Direct children / all descendants of a DAG node (`listRelatives
+    // -children` / `-allDescendents`), restricted to `type`.
+    virtual std::vector<std::string> children(const std::string& dagNode, const std::string& type = "") const = 0;
+    virtual std::vector<std::string> descendants(const std::string& dagNode, const std::string& type = "") const = 0;
+
+    // Nodes connected to any plug of `node` (`listConnections`): `source`
+    // returns the nodes feeding it, `destination` the nodes it feeds. Each
+    // node is returned once.
+    virtual std::vector<std::string> connections(const std::string& node, const std::string& type,
+                                                 bool source, bool destination) const = 0;
+
+    // Upstream non-DAG nodes of a node, or of the shapes of a transform
+    // (`listHistory -pruneDagObjects true`), breadth first. False if the
+    // node is missing or its history could not be walked.
+    virtual bool history(const std::string& node, std::vector<std::string>& out) const = 0;
+
+    // Output geometry shapes of a deformer (`skinCluster -q -geometry`,
+    // `blendShape -q -geometry`).
+    virtual std::vector<std::string> deformedGeometry(const std::string& deformer) const = 0;
+
+    // Name of every element of a multi attribute, its alias if it has one
+    // ("smile") and "attr[<index>]" otherwise, e.g. blendShape weights.
+    virtual std::vector<std::string> elementNames(const std::string& node, const std::string& multiAttr) const = 0;
+
+    // Value of a string attribute; false if the node or attribute is missing.
+    virtual bool getString(const std::string& node, const std::string& attr, std::string& value) const = 0;
+
+    // Whether a camera shape is one of the startup cameras (persp, top...).
+    virtual bool isStartupCamera(const std::string& cameraShape) const = 0;
+};
+
+#endif // SCENEQUERY_H
@@ -1,5 +1,6 @@
 #include "SceneScanner.h"
 #include "PluginLog.h"
+#include "MetadataExecutor.h"
 
 #include <maya/MGlobal.h>
 #include <maya/MString.h>
@@ -12,6 +13,7 @@
 #include <maya/MItDependencyNodes.h>
 #include <maya/MItDag.h>
 #include <maya/MFnDependencyNode.h>
+#include <maya/MFnAttribute.h>
 #include <maya/MPlug.h>
 #include <maya/MObjectArray.h>
 
@@ -20,6 +22,7 @@
 #include <set>
 #include <map>
 #include <sstream>
+#include <unordered_map>
 #include <sys/stat.h>
 #include <cctype>
 #include <cstdlib>
@@ -61,13 +64,6 @@ static MString utf8ToMString(const std::string& utf8) {
 #endif
 }
 
-// Helper: execute MEL and return string result
-static std::string melQueryString(const std::string& cmd) {
-    MString result;
-    MGlobal::executeCommand(utf8ToMString(cmd), result);
-    return toUtf8(result);
-}
-
 // Helper: execute MEL and return string array result
 static std::vector<std::string> melQueryStringArray(const std::string& cmd) {
     MStringArray result;
@@ -103,28 +99,6 @@ static bool fileExistsOnDisk(const std::string& utf8Path) {
 #endif
 }
 
-// Helper: get short name from full DAG path
-static std::string shortName(const std::string& fullPath) {
-    size_t pos = fullPath.rfind('|');
-    return (pos != std::string::npos) ? fullPath.substr(pos + 1) : fullPath;
-}
-
-// Helper: get bare name (strip namespace)
-static std::string bareName(const std::string& name) {
-    size_t pos = name.rfind(':');
-    return (pos != std::string::npos) ? name.substr(pos + 1) : name;
-}
-
-// Helper: get innermost namespace segment from short name
-// For "A:B:NodeName" returns "B", for "B:NodeName" returns "B", for "NodeName" returns ""
-static std::string getNamespace(const std::string& shortName) {
-    size_t lastColon = shortName.rfind(':');
-    if (lastColon == std::string::npos) return "";
-    std::string ns = shortName.substr(0, lastColon);
-    size_t prevColon = ns.rfind(':');
-    return (prevColon != std::string::npos) ? ns.substr(prevColon + 1) : ns;
-}
-
 // Helper: normalize path
 static std::string normPath(const std::string& path) {
     std::string p = path;
@@ -215,6 +189,31 @@ static std::string expandEnvVars(const std::string& input) {
 
 namespace SceneScanner {
 
+// Resolve every dependency path on the calling thread (MEL is not
+// thread-safe), then stat them all in one batch on the shared metadata
+// executor. Paths on an unresponsive share come back as unknown instead of
+// hanging Maya.
+static void checkExistence(std::vector<DependencyInfo>& deps) {
+    if (deps.empty()) return;
+
+    std::vector<std::string> resolved;
+    resolved.reserve(deps.size());
+    for (const auto& dep : deps) resolved.push_back(resolveSceneRelative(dep.path));
+
+    std::vector<StatResult> results = MetadataExecutor::shared().statAll(resolved);
+    int unknown = 0;
+    for (size_t i = 0; i < deps.size(); ++i) {
+        deps[i].exists = results[i].state == StatResult::Exists;
+        deps[i].unknown = results[i].state == StatResult::Unknown;
+        deps[i].size = deps[i].exists ? results[i].size : 0;
+        if (deps[i].unknown) ++unknown;
+    }
+    if (unknown > 0) {
+        PluginLog::warn("SceneScanner",
+            std::to_string(unknown) + " dependency paths could not be checked (storage timed out)");
+    }
+}
+
 std::string getSceneDir() {
     MString scenePath;
     MGlobal::executeCommand("file -q -sceneName", scenePath);
@@ -264,345 +263,31 @@ bool pathExists(const std::string& rawPath) {
     return fileExistsOnDisk(resolved);
 }
 
-std::vector<CameraInfo> findNonDefaultCameras() {
-    std::vector<CameraInfo> result;
-
-    static const std::set<std::string> defaultCams = {
-        "persp", "top", "front", "side", "back", "bottom", "left", "right"
-    };
-    static const std::set<std::string> defaultShapes = {
-        "perspShape", "topShape", "frontShape", "sideShape",
-        "backShape", "bottomShape", "leftShape", "rightShape"
-    };
-
-    // Get all camera shapes
-    std::vector<std::string> camShapes = melQueryStringArray("ls -type \"camera\" -long");
-
-    for (const auto& camShape : camShapes) {
-        // Get parent transform
-        std::string cmd = "listRelatives -parent -fullPath \"" + camShape + "\"";
-        std::vector<std::string> parents = melQueryStringArray(cmd);
-        if (parents.empty()) continue;
-
-        std::string transform = parents[0];
-        std::string sn = shortName(transform);
-        std::string bn = bareName(sn);
-
-        if (defaultCams.count(bn)) continue;
-
-        std::string shapeSn = shortName(camShape);
-        std::string shapeBn = bareName(shapeSn);
-        if (defaultShapes.count(shapeBn)) continue;
-
-        // Check startup camera
-        std::string startupCmd = "camera -q -startupCamera \"" + camShape + "\"";
-        int isStartup = 0;
-        MGlobal::executeCommand(utf8ToMString(startupCmd), isStartup);
-        if (isStartup) continue;
-
-        CameraInfo info;
-        info.transform = transform;
-        info.display = sn;
-        result.push_back(info);
-    }
-
-    return result;
+std::vector<CameraInfo> findNonDefaultCameras(const SceneQuery& scene) {
+    return SceneAnalysis::findNonDefaultCameras(scene);
 }
 
-std::vector<CharacterInfo> findCharacters() {
-    std::vector<CharacterInfo> result;
-
-    // Get all joints
-    std::vector<std::string> allJoints = melQueryStringArray("ls -type \"joint\" -long");
-
-    // Find root joints (no joint parent)
-    std::vector<std::string> rootJoints;
-    for (const auto& joint : allJoints) {
-        std::string cmd = "listRelatives -parent -type \"joint\" \"" + joint + "\"";
-        std::vector<std::string> parents = melQueryStringArray(cmd);
-        if (parents.empty()) {
-            rootJoints.push_back(joint);
-        }
-    }
-
-    // Group roots by namespace
-    std::map<std::string, std::vector<std::string>> nsMap;
-    for (const auto& root : rootJoints) {
-        std::string sn = shortName(root);
-        std::string ns = getNamespace(sn);
-        nsMap[ns].push_back(root);
-    }
-
-    for (auto& kv : nsMap) {
-        const std::string& ns = kv.first;
-        std::vector<std::string>& roots = kv.second;
-
-        // Pick the best root joint for export.
-        // Prefer a root whose bare name is "root" (case-insensitive) — this is the
-        // standard UE export skeleton in rigs that have multiple skeleton hierarchies
-        // (e.g. DeformationSystem/Root_M, FitSkeleton/Root1, and the export skeleton "root").
-        // Fall back to the root with the most descendants if none is named "root".
-        std::string bestRoot = roots[0];
-        int bestCount = 0;
-        bool bestIsRootNamed = false;
-
-        for (const auto& r : roots) {
-            std::string sn_r = shortName(r);
-            std::string bn = bareName(sn_r);
-            std::string lower = bn;
-            for (auto& c : lower) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
-            bool isRootNamed = (lower == "root");
-
-            std::string cmd = "listRelatives -allDescendents -type \"joint\" \"" + r + "\"";
-            std::vector<std::string> desc = melQueryStringArray(cmd);
-            int count = (int)desc.size();
-
-            // Prefer "root"-named joint; among same priority, prefer most descendants
-            if ((isRootNamed && !bestIsRootNamed) ||
-                (isRootNamed == bestIsRootNamed && count > bestCount)) {
-                bestCount = count;
-                bestRoot = r;
-                bestIsRootNamed = isRootNamed;
-            }
-        }
-
-        std::string sn = shortName(bestRoot);
-        CharacterInfo info;
-        info.rootJoint = bestRoot;
-
-        if (!ns.empty()) {
-            info.nsOrName = ns;
-            info.display = sn;
-        } else {
-            info.nsOrName = bareName(sn);
-            info.display = sn;
-        }
-
-        result.push_back(info);
-    }
-
-    return result;
+std::vector<CharacterInfo> findCharacters(const SceneSnapshot& snap) {
+    return SceneAnalysis::findCharacters(snap);
 }
 
-std::vector<BlendShapeGroupInfo> findBlendShapeGroups() {
-    std::vector<BlendShapeGroupInfo> result;
-
-    std::vector<std::string> bsNodes = melQueryStringArray("ls -type \"blendShape\"");
-
-    struct NsEntry {
-        std::string mesh;
-        int weightCount;
-    };
-    std::map<std::string, NsEntry> nsMap; // namespace -> best mesh (highest weightCount)
-
-    for (const auto& bsNode : bsNodes) {
-        // Get geometry connected to this blendShape
-        std::string cmd = "blendShape -q -geometry \"" + bsNode + "\"";
-        std::vector<std::string> geometries = melQueryStringArray(cmd);
-
-        int weightCount = 0;
-        {
-            std::string wcCmd = "blendShape -q -weightCount \"" + bsNode + "\"";
-            MGlobal::executeCommand(utf8ToMString(wcCmd), weightCount);
-        }
-
-        for (const auto& geo : geometries) {
-            std::string parentCmd = "listRelatives -parent -fullPath \"" + geo + "\"";
-            std::vector<std::string> parents = melQueryStringArray(parentCmd);
-            if (parents.empty()) continue;
-
-            std::string transform = parents[0];
-            std::string sn = shortName(transform);
-            std::string ns = getNamespace(sn);
-
-            auto it = nsMap.find(ns);
-            if (it == nsMap.end() || weightCount > it->second.weightCount) {
-                nsMap[ns] = {transform, weightCount};
-            }
-        }
-    }
-
-    for (auto& kv : nsMap) {
-        const std::string& ns = kv.first;
-        const std::string& mesh = kv.second.mesh;
-
-        std::string sn = shortName(mesh);
-        BlendShapeGroupInfo info;
-        info.mesh = mesh;
-
-        if (!ns.empty()) {
-            info.nsOrName = ns;
-            info.display = ns + ":* (BlendShape)";
-        } else {
-            info.nsOrName = bareName(sn);
-            info.display = sn + " (BlendShape)";
-        }
-
-        result.push_back(info);
-    }
-
-    return result;
+std::vector<BlendShapeGroupInfo> findBlendShapeGroups(const SceneSnapshot& snap) {
+    return SceneAnalysis::findBlendShapeGroups(snap);
 }
 
-std::vector<SkeletonBlendShapeInfo> findSkeletonBlendShapeCombos() {
-    std::vector<SkeletonBlendShapeInfo> result;
-
-    std::vector<CharacterInfo> characters = findCharacters();
-
+std::vector<SkeletonBlendShapeInfo> findSkeletonBlendShapeCombos(const SceneSnapshot& snap,
+                                                                 const std::vector<CharacterInfo>& characters) {
     PluginLog::info("SceneScanner",
         "findSkeletonBlendShapeCombos: scanning " + std::to_string(characters.size()) + " characters for BS deformers");
 
-    for (const auto& ch : characters) {
-        // Collect all joints under this character
-        std::string listCmd = "listRelatives -allDescendents -type \"joint\" -fullPath \"" + ch.rootJoint + "\"";
-        std::vector<std::string> allJoints = melQueryStringArray(listCmd);
-        allJoints.push_back(ch.rootJoint);
-
-        // Find skinClusters connected to these joints
-        std::set<std::string> skinClusters;
-        for (const auto& j : allJoints) {
-            std::vector<std::string> clusters = melQueryStringArray(
-                "listConnections -source true -destination false -type \"skinCluster\" \"" + j + "\"");
-            if (clusters.empty()) {
-                clusters = melQueryStringArray(
-                    "listConnections -source true -destination true -type \"skinCluster\" \"" + j + "\"");
-            }
-            skinClusters.insert(clusters.begin(), clusters.end());
-        }
-
-        // For each skinCluster, get the output mesh transforms
-        std::set<std::string> skinnedMeshTransforms;
-        for (const auto& skin : skinClusters) {
-            std::vector<std::string> geos = melQueryStringArray("skinCluster -q -g \"" + skin + "\"");
-            for (const auto& g : geos) {
-                std::vector<std::string> full = melQueryStringArray("ls -long \"" + g + "\"");
-                std::string geo = full.empty() ? g : full[0];
-                std::string geoType = melQueryString("nodeType \"" + geo + "\"");
-
-                if (geoType == "mesh") {
-                    std::vector<std::string> parent = melQueryStringArray(
-                        "listRelatives -parent -fullPath \"" + geo + "\"");
-                    if (!parent.empty()) {
-                        skinnedMeshTransforms.insert(parent[0]);
-                    }
-                } else if (geoType == "transform") {
-                    skinnedMeshTransforms.insert(geo);
-                }
-            }
-        }
-
-        {
-            std::ostringstream dbg;
-            dbg << "  character '" << ch.display << "': "
-                << skinClusters.size() << " skinClusters, "
-                << skinnedMeshTransforms.size() << " skinned meshes";
-            PluginLog::info("SceneScanner", dbg.str());
-        }
-
-        // For each skinned mesh, check if it also has a blendShape deformer
-        std::vector<std::string> bsMeshes;
-        std::vector<std::string> bsNodes;
-        std::vector<std::string> bsWeightAttrs;
-        std::set<std::string> seenBsNodes;
-
-        // Lambda: scan a mesh transform for blendShape deformers and collect attrs
-        auto scanMeshForBS = [&](const std::string& meshXform) {
-            std::string histCmd = "listHistory -pruneDagObjects true \"" + meshXform + "\"";
-            std::vector<std::string> history = melQueryStringArray(histCmd);
-
-            bool meshHasBS = false;
-            int meshBsCount = 0;
-            int meshWeightCount = 0;
-
-            for (const auto& histNode : history) {
-                MString nodeType;
-                MGlobal::executeCommand(utf8ToMString("nodeType \"" + histNode + "\""), nodeType);
-                if (toUtf8(nodeType) != "blendShape") continue;
-
-                meshHasBS = true;
-                ++meshBsCount;
-
-                if (seenBsNodes.count(histNode) == 0) {
-                    seenBsNodes.insert(histNode);
-                    bsNodes.push_back(histNode);
-                }
-
-                int wc = 0;
-                MGlobal::executeCommand(
-                    utf8ToMString("blendShape -q -weightCount \"" + histNode + "\""), wc);
-
-                for (int i = 0; i < wc; ++i) {
-                    std::ostringstream attrCmd;
-                    attrCmd << "aliasAttr -q \"" << histNode << ".weight[" << i << "]\"";
-                    MString alias;
-                    MStatus status = MGlobal::executeCommand(utf8ToMString(attrCmd.str()), alias);
-
-                    std::string attrName;
-                    if (status == MS::kSuccess && alias.length() > 0) {
-                        attrName = histNode + "." + toUtf8(alias);
-                    } else {
-                        std::ostringstream fallback;
-                        fallback << histNode << ".weight[" << i << "]";
-                        attrName = fallback.str();
-                    }
-                    bsWeightAttrs.push_back(attrName);
-                    ++meshWeightCount;
-                }
-            }
-
-            if (meshHasBS) {
-                bsMeshes.push_back(meshXform);
-                std::ostringstream dbg;
-                dbg << "  mesh '" << meshXform << "': "
-                    << meshBsCount << " blendShape deformers found, "
-                    << meshWeightCount << " weight attrs collected";
-                PluginLog::info("SceneScanner", dbg.str());
-            }
-        };
-
-        // Scan skinned meshes for blendShape
-        for (const auto& meshXform : skinnedMeshTransforms) {
-            scanMeshForBS(meshXform);
-        }
-
-        // Also scan non-skinned meshes under the character hierarchy for blendShape.
-        // These may be constrained or parented to the skeleton without a skinCluster.
-        {
-            std::set<std::string> alreadyScanned(skinnedMeshTransforms.begin(), skinnedMeshTransforms.end());
-            // Find all mesh shapes under the character root's top-level parent
-            std::string rootTop = ch.rootJoint;
-            size_t pipePos = rootTop.find('|', 1);
-            if (pipePos != std::string::npos) rootTop = rootTop.substr(0, pipePos);
-            if (rootTop.empty()) rootTop = ch.rootJoint;
-
-            std::vector<std::string> allMeshShapes = melQueryStringArray(
-                "listRelatives -allDescendents -type \"mesh\" -fullPath \"" + rootTop + "\"");
-            std::set<std::string> nonSkinnedTransforms;
-            for (const auto& shape : allMeshShapes) {
-                std::vector<std::string> parent = melQueryStringArray(
-                    "listRelatives -parent -fullPath \"" + shape + "\"");
-                if (!parent.empty() && alreadyScanned.count(parent[0]) == 0) {
-                    nonSkinnedTransforms.insert(parent[0]);
-                }
-            }
-            if (!nonSkinnedTransforms.empty()) {
-                for (const auto& meshXform : nonSkinnedTransforms) {
-                    scanMeshForBS(meshXform);
-                }
-            }
-        }
-
-        // Only create a combo entry if at least one skinned mesh has BS
-        if (!bsMeshes.empty()) {
-            SkeletonBlendShapeInfo info;
-            info.rootJoint     = ch.rootJoint;
-            info.nsOrName      = ch.nsOrName;
-            info.display       = ch.display + " (Skel+BS)";
-            info.bsMeshes      = bsMeshes;
-            info.bsNodes       = bsNodes;
-            info.bsWeightAttrs = bsWeightAttrs;
-            result.push_back(info);
-        }
+    std::vector<SkeletonBlendShapeInfo> result = SceneAnalysis::findSkeletonBlendShapeCombos(snap, characters);
+    for (const auto& combo : result) {
+        std::ostringstream dbg;
+        dbg << "  character '" << combo.display << "': "
+            << combo.bsMeshes.size() << " meshes with blendShape, "
+            << combo.bsNodes.size() << " blendShape deformers, "
+            << combo.bsWeightAttrs.size() << " weight attrs collected";
+        PluginLog::info("SceneScanner", dbg.str());
     }
 
     PluginLog::info("SceneScanner",
@@ -643,8 +328,6 @@ std::vector<DependencyInfo> scanReferences() {
         std::string cleanPath = std::regex_replace(refPath, copyNum, "");
         std::string cleanUnresolved = std::regex_replace(unresolved, copyNum, "");
 
-        bool exists = pathExists(cleanPath);
-
         bool isLoaded = false;
         {
             int loaded = 0;
@@ -659,160 +342,99 @@ std::vector<DependencyInfo> scanReferences() {
         dep.node = refNode;
         dep.path = cleanPath;
         dep.unresolvedPath = cleanUnresolved;
-        dep.exists = exists;
+        dep.exists = false;
+        dep.unknown = false;
         dep.isLoaded = isLoaded;
         dep.selected = false;
         dep.matchedPath = "";
         deps.push_back(dep);
     }
 
+    checkExistence(deps);
     return deps;
 }
 
-std::vector<DependencyInfo> scanTextures() {
-    std::vector<DependencyInfo> deps;
-
-    // File texture nodes
-    std::vector<std::string> fileNodes = melQueryStringArray("ls -type \"file\"");
-    for (const auto& node : fileNodes) {
-        std::string cmd = "getAttr \"" + node + ".fileTextureName\"";
-        MString result;
-        MStatus status = MGlobal::executeCommand(utf8ToMString(cmd), result);
-        if (status != MS::kSuccess) continue;
-
-        std::string path = toUtf8(result);
-        if (path.empty()) continue;
+std::vector<DependencyInfo> scanNodeDependencies(const DependencyRegistry& registry) {
+    for (const auto& error : registry.errors()) PluginLog::warn("SceneScanner", error);
 
-        bool exists = pathExists(path);
+    const std::vector<DependencySource>& sources = registry.sources();
 
-        DependencyInfo dep;
-        dep.type = "texture";
-        dep.typeLabel = "Texture";
-        dep.node = node;
-        dep.path = path;
-        dep.unresolvedPath = path;
-        dep.exists = exists;
-        dep.isLoaded = true;
-        dep.selected = false;
-        dep.matchedPath = "";
-        deps.push_back(dep);
-    }
-
-    // Arnold aiImage nodes
-    std::vector<std::string> aiNodes = melQueryStringArray("ls -type \"aiImage\"");
-    for (const auto& node : aiNodes) {
-        std::string cmd = "getAttr \"" + node + ".filename\"";
-        MString result;
-        MStatus status = MGlobal::executeCommand(utf8ToMString(cmd), result);
-        if (status != MS::kSuccess) continue;
-
-        std::string path = toUtf8(result);
-        if (path.empty()) continue;
-
-        bool exists = pathExists(path);
-
-        DependencyInfo dep;
-        dep.type = "texture";
-        dep.typeLabel = "Texture";
-        dep.node = node;
-        dep.path = path;
-        dep.unresolvedPath = path;
-        dep.exists = exists;
-        dep.isLoaded = true;
-        dep.selected = false;
-        dep.matchedPath = "";
-        deps.push_back(dep);
-    }
-
-    return deps;
-}
-
-std::vector<DependencyInfo> scanCaches() {
-    std::vector<DependencyInfo> deps;
-
-    // AlembicNode
-    std::vector<std::string> alembicNodes = melQueryStringArray("ls -type \"AlembicNode\"");
-    for (const auto& node : alembicNodes) {
-        std::string cmd = "getAttr \"" + node + ".abc_File\"";
-        MString result;
-        MStatus status = MGlobal::executeCommand(utf8ToMString(cmd), result);
-        if (status != MS::kSuccess) continue;
-
-        std::string path = toUtf8(result);
-        if (path.empty()) continue;
-
-        bool exists = pathExists(path);
-
-        DependencyInfo dep;
-        dep.type = "cache";
-        dep.typeLabel = "Cache";
-        dep.node = node;
-        dep.path = path;
-        dep.unresolvedPath = path;
-        dep.exists = exists;
-        dep.isLoaded = true;
-        dep.selected = false;
-        dep.matchedPath = "";
-        deps.push_back(dep);
+    // Registered attributes per node type. Attribute objects are looked up
+    // on the first node of a type and reused for the rest (a null object
+    // means the attribute is dynamic or missing: fall back to findPlug).
+    struct TypeAttr {
+        size_t source;
+        MString name;
+        MObject attr;
+    };
+    struct TypeEntry {
+        std::vector<TypeAttr> attrs;
+        bool resolved = false;
+    };
+    std::unordered_map<std::string, TypeEntry> types;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        types[sources[i].nodeType].attrs.push_back(TypeAttr{i, utf8ToMString(sources[i].attribute), MObject()});
     }
 
-    // gpuCache
-    std::vector<std::string> gpuNodes = melQueryStringArray("ls -type \"gpuCache\"");
-    for (const auto& node : gpuNodes) {
-        std::string cmd = "getAttr \"" + node + ".cacheFileName\"";
-        MString result;
-        MStatus status = MGlobal::executeCommand(utf8ToMString(cmd), result);
-        if (status != MS::kSuccess) continue;
-
-        std::string path = toUtf8(result);
-        if (path.empty()) continue;
+    // Dependencies per source, so the result keeps registry order.
+    std::vector<std::vector<DependencyInfo>> found(sources.size());
+    size_t total = 0;
+
+    for (MItDependencyNodes it(MFn::kInvalid); !it.isDone(); it.next()) {
+        MObject obj = it.thisNode();
+        MFnDependencyNode fn(obj);
+        auto entry = types.find(toUtf8(fn.typeName()));
+        if (entry == types.end()) continue;
+
+        TypeEntry& type = entry->second;
+        if (!type.resolved) {
+            for (auto& a : type.attrs) {
+                MStatus st;
+                MObject attr = fn.attribute(a.name, &st);
+                if (st == MS::kSuccess && !MFnAttribute(attr).isDynamic()) a.attr = attr;
+            }
+            type.resolved = true;
+        }
 
-        bool exists = pathExists(path);
+        std::string node;
+        for (const auto& a : type.attrs) {
+            MStatus st;
+            MPlug plug = a.attr.isNull() ? fn.findPlug(a.name, false, &st) : MPlug(obj, a.attr);
+            if (a.attr.isNull() && st != MS::kSuccess) continue;
+            MString value = plug.asString(&st);
+            if (st != MS::kSuccess || value.length() == 0) continue;
+
+            if (node.empty()) {
+                MDagPath dagPath;
+                node = (obj.hasFn(MFn::kDagNode) && MDagPath::getAPathTo(obj, dagPath) == MS::kSuccess)
+                    ? toUtf8(dagPath.fullPathName()) : toUtf8(fn.name());
+            }
 
-        DependencyInfo dep;
-        dep.type = "cache";
-        dep.typeLabel = "Cache";
-        dep.node = node;
-        dep.path = path;
-        dep.unresolvedPath = path;
-        dep.exists = exists;
-        dep.isLoaded = true;
-        dep.selected = false;
-        dep.matchedPath = "";
-        deps.push_back(dep);
+            const DependencySource& source = sources[a.source];
+            DependencyInfo dep;
+            dep.type = source.category;
+            dep.typeLabel = DependencyRegistry::categoryLabel(source.category);
+            dep.node = node;
+            dep.attribute = source.attribute;
+            dep.path = toUtf8(value);
+            dep.unresolvedPath = dep.path;
+            dep.exists = false;
+            dep.unknown = false;
+            dep.isLoaded = true;
+            dep.selected = false;
+            dep.matchedPath = "";
+            found[a.source].push_back(dep);
+            ++total;
+        }
     }
 
-    return deps;
-}
-
-std::vector<DependencyInfo> scanAudio() {
     std::vector<DependencyInfo> deps;
-
-    std::vector<std::string> audioNodes = melQueryStringArray("ls -type \"audio\"");
-    for (const auto& node : audioNodes) {
-        std::string cmd = "getAttr \"" + node + ".filename\"";
-        MString result;
-        MStatus status = MGlobal::executeCommand(utf8ToMString(cmd), result);
-        if (status != MS::kSuccess) continue;
-
-        std::string path = toUtf8(result);
-        if (path.empty()) continue;
-
-        bool exists = pathExists(path);
-
-        DependencyInfo dep;
-        dep.type = "audio";
-        dep.typeLabel = "Audio";
-        dep.node = node;
-        dep.path = path;
-        dep.unresolvedPath = path;
-        dep.exists = exists;
-        dep.isLoaded = true;
-        dep.selected = false;
-        dep.matchedPath = "";
-        deps.push_back(dep);
+    deps.reserve(total);
+    for (auto& list : found) {
+        for (auto& dep : list) deps.push_back(std::move(dep));
     }
 
+    checkExistence(deps);
     return deps;
 }
 
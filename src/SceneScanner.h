@@ -2,67 +2,54 @@
 #ifndef SCENESCANNER_H
 #define SCENESCANNER_H
 
+#include "DependencyRegistry.h"
+#include "SceneAnalysis.h"
+
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
 
-struct CameraInfo {
-    std::string transform; // full DAG path
-    std::string display;   // short display name
-};
-
-struct CharacterInfo {
-    std::string rootJoint;  // full DAG path of main root joint
-    std::string nsOrName;   // namespace or bare joint name
-    std::string display;    // human-readable label
-};
-
-struct BlendShapeGroupInfo {
-    std::string mesh;       // first mesh transform with blendShape
-    std::string nsOrName;   // namespace or bare mesh name
-    std::string display;    // human-readable label
-};
-
-struct SkeletonBlendShapeInfo {
-    std::string rootJoint;              // skeleton root joint full DAG path
-    std::string nsOrName;               // namespace or bare name
-    std::string display;                // human-readable label
-    std::vector<std::string> bsMeshes;  // skinned meshes that also have blendShape
-    std::vector<std::string> bsNodes;   // blendShape deformer node names
-    std::vector<std::string> bsWeightAttrs; // all BS weight attributes (for bake)
-};
-
 struct DependencyInfo {
-    std::string type;           // "reference", "texture", "cache", "audio"
+    std::string type;           // "reference" or a DependencyRegistry category ("texture", "cache", "audio", ...)
     std::string typeLabel;      // display label
     std::string node;           // Maya node name
+    std::string attribute;      // path attribute of node (empty for references)
     std::string path;           // resolved path
     std::string unresolvedPath; // unresolved/original path
     bool exists;
+    bool unknown;           // existence check timed out (exists is false)
     bool isLoaded;          // references: queried from Maya; textures/caches/audio: always true
     bool selected;
     std::string matchedPath;    // auto-matched replacement path
+    int64_t size = 0;           // bytes, when exists
 };
 
 namespace SceneScanner {
 
+    // Export targets of the open scene: SceneAnalysis over MayaSceneQuery
+    // and one SceneSnapshot of it per scan.
+
     // Find all non-default cameras in the scene
-    std::vector<CameraInfo> findNonDefaultCameras();
+    std::vector<CameraInfo> findNonDefaultCameras(const SceneQuery& scene);
 
     // Find character skeletons grouped by namespace
-    std::vector<CharacterInfo> findCharacters();
+    std::vector<CharacterInfo> findCharacters(const SceneSnapshot& snap);
 
     // Find blendshape meshes grouped by namespace
-    std::vector<BlendShapeGroupInfo> findBlendShapeGroups();
+    std::vector<BlendShapeGroupInfo> findBlendShapeGroups(const SceneSnapshot& snap);
 
-    // Find characters whose skinned meshes also have blendShape deformers
-    std::vector<SkeletonBlendShapeInfo> findSkeletonBlendShapeCombos();
+    // Find which of `characters` have skinned meshes with blendShape deformers
+    std::vector<SkeletonBlendShapeInfo> findSkeletonBlendShapeCombos(const SceneSnapshot& snap,
+                                                                     const std::vector<CharacterInfo>& characters);
 
     // Scan scene dependencies
     std::vector<DependencyInfo> scanReferences();
-    std::vector<DependencyInfo> scanTextures();
-    std::vector<DependencyInfo> scanCaches();
-    std::vector<DependencyInfo> scanAudio();
+
+    // File paths held by the node attributes in `registry`, in registry
+    // order: one pass over the dependency graph, then one parallel
+    // existence check of every path.
+    std::vector<DependencyInfo> scanNodeDependencies(const DependencyRegistry& registry = DependencyRegistry::shared());
 
     // Utility: get scene directory
     std::string getSceneDir();
@@ -0,0 +1,179 @@
+#include "SceneSnapshot.h"
+#include "SceneAnalysis.h"
+#include "SceneQuery.h"
+
+#include <algorithm>
+
+SceneSnapshot SceneSnapshot::build(const SceneQuery& scene)
+{
+    SceneSnapshot s;
+    std::unordered_map<std::string, int32_t> ids;  // full path / node name -> node, while building
+
+    // Every DAG node; with no type filter the nearest ancestor is the parent.
+    SceneQuery::DagForest dag = scene.dagForest("");
+    ids.reserve(dag.paths.size());
+    s.stringIds_.reserve(dag.paths.size());
+    for (size_t i = 0; i < dag.paths.size(); ++i) {
+        int32_t n = s.addNode(SceneAnalysis::shortName(dag.paths[i]), NodeType::Other, dag.ancestor[i]);
+        ids.emplace(std::move(dag.paths[i]), n);
+        if (dag.ancestor[i] < 0) s.roots_.push_back(n);
+    }
+    s.dagCount_ = s.size();
+
+    // Later entries win: a joint is also a transform.
+    static const struct { NodeType type; const char* name; } kDagTypes[] = {
+        {NodeType::Transform, "transform"},
+        {NodeType::Joint, "joint"},
+        {NodeType::Mesh, "mesh"},
+        {NodeType::Camera, "camera"},
+    };
+    for (const auto& t : kDagTypes) {
+        for (const auto& path : scene.nodesOfType(t.name)) {
+            auto it = ids.find(path);
+            if (it != ids.end()) s.type_[it->second] = t.type;
+        }
+    }
+
+    static const struct { NodeType type; const char* name; } kDeformerTypes[] = {
+        {NodeType::SkinCluster, "skinCluster"},
+        {NodeType::BlendShape, "blendShape"},
+    };
+    std::vector<std::pair<int32_t, int32_t>> connections;
+    std::vector<std::pair<int32_t, int32_t>> deformed;
+    std::vector<std::pair<int32_t, int32_t>> weights;
+    for (const auto& t : kDeformerTypes) {
+        for (const auto& name : scene.nodesOfType(t.name)) {
+            if (ids.count(name)) continue;
+            int32_t d = s.addNode(name, t.type, -1);
+            ids.emplace(name, d);
+            s.deformerByName_.emplace(s.name_[d], d);
+
+            if (t.type == NodeType::SkinCluster) {
+                for (const auto& joint : scene.connections(name, "joint", true, true)) {
+                    auto it = ids.find(joint);
+                    if (it == ids.end()) continue;
+                    connections.emplace_back(d, it->second);
+                    connections.emplace_back(it->second, d);
+                }
+            }
+            for (const auto& geo : scene.deformedGeometry(name)) {
+                auto it = ids.find(geo);
+                if (it != ids.end()) deformed.emplace_back(d, it->second);
+            }
+            if (t.type == NodeType::BlendShape) {
+                for (const auto& alias : scene.elementNames(name, "weight")) {
+                    weights.emplace_back(d, s.intern(alias));
+                }
+            }
+        }
+    }
+
+    std::vector<std::pair<int32_t, int32_t>> children;
+    children.reserve(s.dagCount_);
+    for (int32_t n = 0; n < s.dagCount_; ++n) {
+        if (s.parent_[n] >= 0) children.emplace_back(s.parent_[n], n);
+    }
+    std::vector<std::pair<int32_t, int32_t>> deformers;
+    deformers.reserve(deformed.size());
+    for (const auto& e : deformed) deformers.emplace_back(e.second, e.first);
+
+    s.children_ = s.makeCsr(children);
+    s.connections_ = s.makeCsr(connections);
+    s.deformed_ = s.makeCsr(deformed);
+    s.deformers_ = s.makeCsr(deformers);
+    s.weights_ = s.makeCsr(weights);
+
+    // Descendants follow their ancestors, so subtree ends propagate up in
+    // one reverse pass.
+    s.subtreeEnd_.resize(s.dagCount_);
+    for (int32_t n = 0; n < s.dagCount_; ++n) s.subtreeEnd_[n] = n + 1;
+    for (int32_t n = s.dagCount_; n-- > 0;) {
+        int32_t p = s.parent_[n];
+        if (p >= 0) s.subtreeEnd_[p] = (std::max)(s.subtreeEnd_[p], s.subtreeEnd_[n]);
+    }
+    return s;
+}
+
+int32_t SceneSnapshot::intern(const std::string& str)
+{
+    auto it = stringIds_.find(str);
+    if (it != stringIds_.end()) return it->second;
+    int32_t id = static_cast<int32_t>(strings_.size());
+    strings_.push_back(str);
+    stringIds_.emplace(str, id);
+    return id;
+}
+
+int32_t SceneSnapshot::addNode(const std::string& shortName, NodeType type, int32_t parent)
+{
+    int32_t n = size();
+    type_.push_back(type);
+    parent_.push_back(parent);
+    name_.push_back(intern(shortName));
+    ns_.push_back(intern(SceneAnalysis::namespaceOf(shortName)));
+    return n;
+}
+
+SceneSnapshot::Csr SceneSnapshot::makeCsr(const std::vector<std::pair<int32_t, int32_t>>& edges) const
+{
+    Csr csr;
+    csr.offsets.assign(static_cast<size_t>(size()) + 1, 0);
+    for (const auto& e : edges) ++csr.offsets[e.first + 1];
+    for (size_t i = 1; i < csr.offsets.size(); ++i) csr.offsets[i] += csr.offsets[i - 1];
+    csr.ids.resize(edges.size());
+    std::vector<uint32_t> next(csr.offsets.begin(), csr.offsets.end() - 1);
+    for (const auto& e : edges) csr.ids[next[e.first]++] = e.second;
+    return csr;
+}
+
+std::string SceneSnapshot::bareName(int32_t n) const
+{
+    return SceneAnalysis::bareName(name(n));
+}
+
+std::string SceneSnapshot::path(int32_t n) const
+{
+    if (!isDag(n)) return name(n);
+    std::vector<int32_t> chain;
+    for (int32_t p = n; p >= 0; p = parent_[p]) chain.push_back(p);
+    std::string out;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        out += '|';
+        out += name(*it);
+    }
+    return out;
+}
+
+int32_t SceneSnapshot::find(const std::string& name) const
+{
+    if (name.empty()) return -1;
+    if (name[0] != '|') {
+        auto id = stringIds_.find(name);
+        if (id == stringIds_.end()) return -1;
+        auto it = deformerByName_.find(id->second);
+        return it == deformerByName_.end() ? -1 : it->second;
+    }
+
+    // Walk the path one component at a time from the roots.
+    int32_t current = -1;
+    size_t pos = 1;
+    for (;;) {
+        size_t bar = name.find('|', pos);
+        auto id = stringIds_.find(name.substr(pos, bar == std::string::npos ? std::string::npos : bar - pos));
+        if (id == stringIds_.end()) return -1;
+        int32_t next = -1;
+        if (current < 0) {
+            for (int32_t r : roots_) {
+                if (name_[r] == id->second) { next = r; break; }
+            }
+        } else {
+            for (int32_t c : children(current)) {
+                if (name_[c] == id->second) { next = c; break; }
+            }
+        }
+        if (next < 0) return -1;
+        current = next;
+        if (bar == std::string::npos) return current;
+        pos = bar + 1;
+    }
+}
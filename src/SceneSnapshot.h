@@ -0,0 +1,115 @@
+#pragma once
+#ifndef SCENESNAPSHOT_H
+#define SCENESNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class SceneQuery;
+
+// Compact copy of the part of the scene the export-target analyses read:
+// every DAG node, the skinCluster and blendShape deformers, which joints
+// each skinCluster is connected to, which geometry each deformer deforms
+// and the blendShape weight aliases.
+//
+// Nodes are numbered 0..size()-1: DAG nodes first, in depth-first order
+// (a node's subtree is the id range [n, subtreeEnd(n))), then the
+// deformers. Relationships are CSR arrays (one offset per node into one id
+// array) and names are interned, so after build() the analyses are loops
+// over integer arrays. build() costs one dagForest() and a few
+// nodesOfType() queries plus a constant number of queries per deformer,
+// linear in the scene size.
+class SceneSnapshot {
+public:
+    enum class NodeType : uint8_t {
+        Other,
+        Transform,
+        Joint,
+        Mesh,
+        Camera,
+        SkinCluster,
+        BlendShape,
+    };
+
+    // Ids of one CSR row.
+    struct Ids {
+        const int32_t* first;
+        const int32_t* last;
+        const int32_t* begin() const { return first; }
+        const int32_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    static SceneSnapshot build(const SceneQuery& scene);
+
+    int32_t size() const { return static_cast<int32_t>(type_.size()); }
+    int32_t dagCount() const { return dagCount_; }
+    bool isDag(int32_t n) const { return n < dagCount_; }
+
+    NodeType type(int32_t n) const { return type_[n]; }
+    int32_t parent(int32_t n) const { return parent_[n]; }  // -1 under the world and for deformers
+    int32_t subtreeEnd(int32_t n) const { return subtreeEnd_[n]; }  // DAG nodes only
+
+    Ids children(int32_t n) const { return row(children_, n); }
+    // skinCluster <-> joints connected to it, both directions.
+    Ids connections(int32_t n) const { return row(connections_, n); }
+    // Deformer -> output geometry, and geometry -> its deformers.
+    Ids deformed(int32_t n) const { return row(deformed_, n); }
+    Ids deformers(int32_t n) const { return row(deformers_, n); }
+    // blendShape -> string ids of its weight aliases ("weight[i]" if none).
+    Ids weights(int32_t n) const { return row(weights_, n); }
+
+    // Interned strings: short name ("ns:node", the DAG leaf) and innermost
+    // namespace ("" for none).
+    const std::string& string(int32_t id) const { return strings_[id]; }
+    const std::string& name(int32_t n) const { return strings_[name_[n]]; }
+    const std::string& nameSpace(int32_t n) const { return strings_[ns_[n]]; }
+    // Short name without namespaces.
+    std::string bareName(int32_t n) const;
+
+    // Full DAG path for DAG nodes, the node name for deformers.
+    std::string path(int32_t n) const;
+    // Node of a full DAG path or deformer name, -1 if not in the snapshot.
+    int32_t find(const std::string& name) const;
+
+private:
+    struct Csr {
+        std::vector<uint32_t> offsets;  // size() + 1 entries
+        std::vector<int32_t> ids;
+    };
+
+    Ids row(const Csr& csr, int32_t n) const
+    {
+        const int32_t* base = csr.ids.data();
+        return Ids{base + csr.offsets[n], base + csr.offsets[n + 1]};
+    }
+
+    int32_t intern(const std::string& s);
+    int32_t addNode(const std::string& shortName, NodeType type, int32_t parent);
+    // CSR over `size()` rows from (row, id) pairs, keeping their order within a row.
+    Csr makeCsr(const std::vector<std::pair<int32_t, int32_t>>& edges) const;
+
+    int32_t dagCount_ = 0;
+    std::vector<NodeType> type_;
+    std::vector<int32_t> parent_;
+    std::vector<int32_t> subtreeEnd_;
+    std::vector<int32_t> name_;
+    std::vector<int32_t> ns_;
+    std::vector<int32_t> roots_;
+    Csr children_;
+    Csr connections_;
+    Csr deformed_;
+    Csr deformers_;
+    Csr weights_;
+
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, int32_t> stringIds_;
+    std::unordered_map<int32_t, int32_t> deformerByName_;  // name string id -> node
+};
+
+#endif // SCENESNAPSHOT_H
@@ -0,0 +1,663 @@
+// mayaDepCheck — headless, parallel dependency preflight for Maya scenes.
+//
+// Runs FileAnalyzer::analyze() on every .ma/.mb found under the given roots
+// (or listed in a text file), one scene per task on a pool of worker threads,
+// and writes one combined report. No Maya SDK or Qt required.
+//
+//   mayaDepCheck [options] <scene-or-directory>...
+//
+// Exit code: 0 = nothing missing, 1 = missing dependencies, 2 = scenes that
+// could not be analyzed (or bad usage).
+
+#include "AnalysisCache.h"
+#include "FileAnalyzer.h"
+#include "MetadataExecutor.h"
+#include "ReferenceGraph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+enum class ReportFormat { Text, Json };
+
+struct Options {
+    std::vector<std::string> inputs;     // scenes or directories (UTF-8)
+    std::vector<std::string> listFiles;  // text files with one scene per line
+    std::string outputPath;              // empty = stdout
+    std::string cachePath;               // empty = no persistent parse cache
+    bool cacheFingerprint = false;       // also take a sampled fingerprint of each scene
+    ReportFormat format = ReportFormat::Text;
+    unsigned jobs = 0;                   // 0 = hardware_concurrency
+    bool missingOnly = false;
+    bool recursive = false;              // follow references (ReferenceGraph)
+    bool headerOnly = false;             // .ma: stop at the first createNode
+    size_t memoryLimit = FileAnalyzer::kDefaultMemoryLimit;  // per-scene .ma window
+    bool progress = true;
+    MetadataExecutor::Options stat;      // dependency existence checks
+};
+
+struct SceneResult {
+    AnalysisSummary summary;
+    bool ok = false;
+    std::string report;  // formatted fragment for this scene
+};
+
+// Directories never worth descending into (same list as the UI file cache).
+bool isSkippedDir(const std::string& name)
+{
+    return name.empty() || name[0] == '.' || name == "__pycache__" || name == "node_modules";
+}
+
+std::string lowerExt(const fs::path& p)
+{
+    std::string ext = p.extension().u8string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+bool isSceneFile(const fs::path& p)
+{
+    std::string ext = lowerExt(p);
+    return ext == ".ma" || ext == ".mb";
+}
+
+std::string toGenericUtf8(const fs::path& p)
+{
+    return p.generic_u8string();
+}
+
+void collectScenes(const fs::path& root, std::vector<std::string>& scenes)
+{
+    std::error_code ec;
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+    if (ec) {
+        std::cerr << "warning: cannot open directory " << toGenericUtf8(root) << ": " << ec.message() << "\n";
+        return;
+    }
+    for (const fs::recursive_directory_iterator end; it != end; it.increment(ec)) {
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        const fs::directory_entry& entry = *it;
+        std::error_code typeEc;
+        if (entry.is_directory(typeEc)) {
+            if (isSkippedDir(entry.path().filename().u8string())) it.disable_recursion_pending();
+            continue;
+        }
+        if (entry.is_regular_file(typeEc) && isSceneFile(entry.path())) {
+            scenes.push_back(toGenericUtf8(entry.path()));
+        }
+    }
+}
+
+bool readListFile(const std::string& listPath, std::vector<std::string>& scenes)
+{
+    std::ifstream in(fs::u8path(listPath), std::ios::binary);
+    if (!in) return false;
+
+    std::string line;
+    bool first = true;
+    while (std::getline(in, line)) {
+        if (first && line.size() >= 3 && line.compare(0, 3, "\xEF\xBB\xBF") == 0) line.erase(0, 3);
+        first = false;
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) line.pop_back();
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') continue;
+        scenes.push_back(line.substr(start));
+    }
+    return true;
+}
+
+std::string jsonEscape(const std::string& s)
+{
+    std::string out;
+    out.reserve(s.size() + 2);
+    for (char ch : s) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += ch;
+            }
+        }
+    }
+    return out;
+}
+
+void appendJsonStrings(std::ostringstream& oss, const char* key, const std::vector<std::string>& values)
+{
+    oss << "\"" << key << "\":[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i) oss << ",";
+        oss << "\"" << jsonEscape(values[i]) << "\"";
+    }
+    oss << "]";
+}
+
+void appendJsonDeps(std::ostringstream& oss, const char* key, const std::vector<AnalyzedDep>& deps, bool missingOnly)
+{
+    oss << "\"" << key << "\":[";
+    bool first = true;
+    for (const auto& d : deps) {
+        if (missingOnly && d.exists) continue;
+        if (!first) oss << ",";
+        first = false;
+        oss << "{\"path\":\"" << jsonEscape(d.path) << "\",\"exists\":" << (d.exists ? "true" : "false")
+            << ",\"unknown\":" << (d.unknown ? "true" : "false") << ",\"size\":" << d.size << "}";
+    }
+    oss << "]";
+}
+
+std::string formatJson(const FileAnalyzer& fa, const AnalysisSummary& s, bool ok, bool missingOnly)
+{
+    std::ostringstream oss;
+    oss << "{\"file\":\"" << jsonEscape(s.file) << "\",\"ok\":" << (ok ? "true" : "false")
+        << ",\"missing\":" << s.totalMissing << ",";
+    appendJsonStrings(oss, "errors", s.errors);
+    oss << ",";
+    appendJsonStrings(oss, "warnings", s.warnings);
+    oss << ",\"requires\":[";
+    for (size_t i = 0; i < fa.requiredPlugins.size(); ++i) {
+        if (i) oss << ",";
+        oss << "{\"plugin\":\"" << jsonEscape(fa.requiredPlugins[i].plugin) << "\",\"version\":\""
+            << jsonEscape(fa.requiredPlugins[i].version) << "\"}";
+    }
+    oss << "],";
+    appendJsonDeps(oss, "references", fa.references, missingOnly);
+    oss << ",";
+    appendJsonDeps(oss, "textures", fa.textures, missingOnly);
+    oss << ",";
+    appendJsonDeps(oss, "caches", fa.caches, missingOnly);
+    oss << "}";
+    return oss.str();
+}
+
+std::string formatMissingText(const FileAnalyzer& fa, const AnalysisSummary& s)
+{
+    std::ostringstream oss;
+    oss << s.file << "\n";
+    for (const auto& e : s.errors) oss << "  [ERROR] " << e << "\n";
+    for (const auto& d : fa.getMissingFiles()) {
+        oss << "  [MISSING " << d.type << "] " << d.path << "\n";
+    }
+    return oss.str();
+}
+
+SceneResult analyzeScene(const std::string& scene, const Options& opts, AnalysisCache* cache)
+{
+    SceneResult result;
+    FileAnalyzer fa(scene);
+    fa.setCache(cache);
+    if (opts.headerOnly) fa.setMode(AnalysisMode::ReferencesAndRequires);
+    fa.setMemoryLimit(opts.memoryLimit);
+    result.ok = fa.analyze();
+    result.summary = fa.summary();
+
+    bool clean = result.ok && result.summary.totalMissing == 0 && result.summary.errors.empty();
+    if (opts.missingOnly && clean) return result;
+
+    if (opts.format == ReportFormat::Json) {
+        result.report = formatJson(fa, result.summary, result.ok, opts.missingOnly);
+    } else if (opts.missingOnly) {
+        result.report = formatMissingText(fa, result.summary);
+    } else {
+        result.report = fa.getReport();
+    }
+    return result;
+}
+
+std::string formatGraphJson(const ReferenceGraph& graph, int root, bool missingOnly)
+{
+    const auto& nodes = graph.nodes();
+    std::vector<RefClosureEntry> entries = graph.closure(root);
+    int maxDepth = 0;
+    for (const auto& e : entries) maxDepth = std::max(maxDepth, e.depth);
+
+    std::ostringstream oss;
+    oss << "{\"file\":\"" << jsonEscape(nodes[root].path) << "\",\"closureFiles\":" << entries.size()
+        << ",\"maxDepth\":" << maxDepth << ",\"missing\":" << graph.closureMissing(entries) << ",\"nodes\":[";
+    bool first = true;
+    for (const auto& e : entries) {
+        const RefGraphNode& n = nodes[e.node];
+        bool clean = n.exists && n.summary.errors.empty() && n.summary.missingTextures == 0 &&
+                     n.summary.missingCaches == 0;
+        if (missingOnly && clean) continue;
+        if (!first) oss << ",";
+        first = false;
+        oss << "{\"path\":\"" << jsonEscape(n.path) << "\",\"depth\":" << e.depth
+            << ",\"exists\":" << (n.exists ? "true" : "false") << ",\"unknown\":" << (n.unknown ? "true" : "false")
+            << ",";
+        appendJsonStrings(oss, "errors", n.summary.errors);
+        oss << ",";
+        appendJsonDeps(oss, "textures", n.textures, missingOnly);
+        oss << ",";
+        appendJsonDeps(oss, "caches", n.caches, missingOnly);
+        oss << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
+
+bool openOutput(const Options& opts, std::ofstream& file)
+{
+    if (opts.outputPath.empty()) return true;
+    file.open(fs::u8path(opts.outputPath), std::ios::binary);
+    if (!file) {
+        std::cerr << "error: cannot write " << opts.outputPath << "\n";
+        return false;
+    }
+    return true;
+}
+
+// --recursive: one ReferenceGraph over all scenes, so shared sets and rigs
+// are analyzed once for the whole run.
+int runGraph(const std::vector<std::string>& scenes, const Options& opts, unsigned jobs, AnalysisCache* cache)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    ReferenceGraph graph(jobs);
+    graph.setCache(cache);
+    if (opts.headerOnly) graph.setMode(AnalysisMode::ReferencesAndRequires);
+    graph.setMemoryLimit(opts.memoryLimit);
+    graph.build(scenes);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    const auto& nodes = graph.nodes();
+    size_t failed = 0;
+    std::vector<RefClosureEntry> all;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].depth < 0) continue;
+        all.push_back({(int)i, nodes[i].depth});
+        bool isRoot = nodes[i].depth == 0;
+        if ((nodes[i].isScene && nodes[i].exists && !nodes[i].analyzed) || (isRoot && !nodes[i].exists)) ++failed;
+    }
+    int missing = graph.closureMissing(all);
+
+    std::ofstream file;
+    if (!openOutput(opts, file)) return 2;
+    std::ostream& out = opts.outputPath.empty() ? std::cout : file;
+
+    if (opts.format == ReportFormat::Json) {
+        out << "{\"scenes\":" << graph.roots().size() << ",\"files\":" << nodes.size()
+            << ",\"analyzed\":" << graph.analyzedCount() << ",\"edges\":" << graph.edgeCount()
+            << ",\"failed\":" << failed << ",\"missing\":" << missing << ",\"cycles\":[";
+        for (size_t c = 0; c < graph.cycles().size(); ++c) {
+            if (c) out << ",";
+            out << "[";
+            const auto& cycle = graph.cycles()[c];
+            for (size_t k = 0; k < cycle.size(); ++k) {
+                if (k) out << ",";
+                out << "\"" << jsonEscape(nodes[cycle[k]].path) << "\"";
+            }
+            out << "]";
+        }
+        out << "],\"results\":[\n";
+        bool first = true;
+        for (int root : graph.roots()) {
+            if (opts.missingOnly && graph.closureMissing(graph.closure(root)) == 0 &&
+                nodes[root].summary.errors.empty()) continue;
+            if (!first) out << ",\n";
+            first = false;
+            out << formatGraphJson(graph, root, opts.missingOnly);
+        }
+        out << "\n]}\n";
+    } else {
+        for (int root : graph.roots()) {
+            if (opts.missingOnly && graph.closureMissing(graph.closure(root)) == 0 &&
+                nodes[root].summary.errors.empty()) continue;
+            out << graph.getReport(root) << "\n";
+        }
+        std::string sep60(60, '=');
+        out << sep60 << "\n";
+        out << "Scenes:              " << graph.roots().size() << "\n";
+        out << "Distinct files:      " << nodes.size() << " (" << graph.analyzedCount() << " analyzed, "
+            << graph.edgeCount() << " reference edges)\n";
+        out << "Failed to analyze:   " << failed << "\n";
+        out << "Reference cycles:    " << graph.cycles().size() << "\n";
+        out << "Total Missing: " << missing << "\n";
+        out << sep60 << "\n";
+    }
+    out.flush();
+
+    if (opts.progress) {
+        std::cerr << graph.roots().size() << " scenes, " << nodes.size() << " distinct files, " << missing
+                  << " missing, " << failed << " failed in " << seconds << " s (" << jobs << " threads)\n";
+    }
+
+    if (failed > 0) return 2;
+    return missing > 0 ? 1 : 0;
+}
+
+// One FileAnalyzer per scene, no reference following.
+int runFlat(const std::vector<std::string>& scenes, const Options& opts, unsigned jobs, AnalysisCache* cache)
+{
+    jobs = static_cast<unsigned>(std::min<size_t>(jobs, scenes.size()));
+
+    std::vector<SceneResult> results(scenes.size());
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::mutex progressMutex;
+    auto startTime = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t i = next.fetch_add(1);
+            if (i >= scenes.size()) break;
+            results[i] = analyzeScene(scenes[i], opts, cache);
+
+            size_t n = done.fetch_add(1) + 1;
+            if (opts.progress && (n % 100 == 0 || n == scenes.size())) {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                std::cerr << "\r[" << n << "/" << scenes.size() << "] scenes analyzed" << std::flush;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(jobs);
+    for (unsigned t = 0; t < jobs; ++t) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (opts.progress) std::cerr << "\n";
+
+    // ---- Totals ----
+    size_t failed = 0, withMissing = 0;
+    long long refs = 0, texs = 0, caches = 0, missing = 0, unknown = 0;
+    for (const auto& r : results) {
+        if (!r.ok) ++failed;
+        if (r.summary.totalMissing > 0) ++withMissing;
+        refs += r.summary.references;
+        texs += r.summary.textures;
+        caches += r.summary.caches;
+        missing += r.summary.totalMissing;
+        unknown += r.summary.unknown;
+    }
+
+    // ---- Write combined report (input order, independent of scheduling) ----
+    std::ofstream file;
+    if (!openOutput(opts, file)) return 2;
+    std::ostream& out = opts.outputPath.empty() ? std::cout : file;
+
+    if (opts.format == ReportFormat::Json) {
+        out << "{\"scenes\":" << scenes.size() << ",\"failed\":" << failed
+            << ",\"scenesWithMissing\":" << withMissing << ",\"references\":" << refs
+            << ",\"textures\":" << texs << ",\"caches\":" << caches << ",\"missing\":" << missing << ",\"unknown\":" << unknown
+            << ",\"results\":[\n";
+        bool first = true;
+        for (const auto& r : results) {
+            if (r.report.empty()) continue;
+            if (!first) out << ",\n";
+            first = false;
+            out << r.report;
+        }
+        out << "\n]}\n";
+    } else {
+        for (const auto& r : results) {
+            if (!r.report.empty()) out << r.report << "\n";
+        }
+        std::string sep60(60, '=');
+        out << sep60 << "\n";
+        out << "Scenes analyzed:     " << scenes.size() << "\n";
+        out << "Failed to analyze:   " << failed << "\n";
+        out << "Scenes with missing: " << withMissing << "\n";
+        out << "References: " << refs << "  Textures: " << texs << "  Caches: " << caches << "\n";
+        out << "Total Missing: " << missing << "\n";
+        if (unknown > 0) out << "Unknown (stat timed out): " << unknown << "\n";
+        out << sep60 << "\n";
+    }
+    out.flush();
+
+    if (opts.progress) {
+        std::cerr << scenes.size() << " scenes, " << missing << " missing, " << failed << " failed in "
+                  << seconds << " s (" << jobs << " threads)\n";
+    }
+
+    if (failed > 0) return 2;
+    return missing > 0 ? 1 : 0;
+}
+
+void printUsage(const char* exe)
+{
+    std::cerr <<
+        "Usage: " << exe << " [options] <scene-or-directory>...\n"
+        "\n"
+        "Analyze Maya .ma/.mb scenes for missing references, textures and caches\n"
+        "without Maya. Directories are searched recursively for .ma/.mb files.\n"
+        "\n"
+        "Options:\n"
+        "  -l, --list <file>     read scene paths from <file>, one per line ('#' comments)\n"
+        "  -o, --output <file>   write the report to <file> instead of stdout\n"
+        "  -j, --jobs <n>        number of worker threads (default: all cores)\n"
+        "  -r, --recursive       follow references transitively; every distinct file is\n"
+        "                        analyzed once and each scene reports its full closure\n"
+        "      --header-only     only references and `requires` plugins; .ma files are\n"
+        "                        read up to the first createNode (textures and caches\n"
+        "                        are not reported)\n"
+        "      --memory-limit <MB>  .ma files larger than this are streamed through a\n"
+        "                        buffer of this size instead of mapped whole; peak\n"
+        "                        memory is about jobs x limit (default 256)\n"
+        "      --cache <file>    persistent parse cache; unchanged scenes are not reparsed\n"
+        "      --cache-fingerprint  also hash 64 KB at the start/middle/end of each scene when\n"
+        "                        checking the cache (catches size/mtime-preserving edits)\n"
+        "      --stat-timeout <ms>   give up on a dependency stat after <ms> and report it\n"
+        "                        as UNKNOWN (default 5000)\n"
+        "      --stat-per-mount <n>  concurrent stats per share/drive/mount (default 8)\n"
+        "      --json            write the report as JSON\n"
+        "      --missing-only    only report scenes with errors or missing dependencies\n"
+        "  -q, --quiet           no progress on stderr\n"
+        "  -h, --help            show this help\n"
+        "\n"
+        "Exit code: 0 nothing missing, 1 missing dependencies, 2 analysis errors.\n";
+}
+
+bool parseArgs(const std::vector<std::string>& args, Options& opts, const char* exe)
+{
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& a = args[i];
+        auto needValue = [&](std::string& out) {
+            if (i + 1 >= args.size()) {
+                std::cerr << "error: " << a << " needs a value\n";
+                return false;
+            }
+            out = args[++i];
+            return true;
+        };
+
+        if (a == "-h" || a == "--help") {
+            printUsage(exe);
+            std::exit(0);
+        } else if (a == "-l" || a == "--list") {
+            std::string v;
+            if (!needValue(v)) return false;
+            opts.listFiles.push_back(v);
+        } else if (a == "-o" || a == "--output") {
+            if (!needValue(opts.outputPath)) return false;
+        } else if (a == "-j" || a == "--jobs") {
+            std::string v;
+            if (!needValue(v)) return false;
+            int n = std::atoi(v.c_str());
+            if (n <= 0) {
+                std::cerr << "error: invalid job count: " << v << "\n";
+                return false;
+            }
+            opts.jobs = static_cast<unsigned>(n);
+        } else if (a == "-r" || a == "--recursive") {
+            opts.recursive = true;
+        } else if (a == "--header-only") {
+            opts.headerOnly = true;
+        } else if (a == "--cache") {
+            if (!needValue(opts.cachePath)) return false;
+        } else if (a == "--cache-fingerprint") {
+            opts.cacheFingerprint = true;
+        } else if (a == "--memory-limit") {
+            std::string v;
+            if (!needValue(v)) return false;
+            int n = std::atoi(v.c_str());
+            if (n <= 0) {
+                std::cerr << "error: invalid value for " << a << ": " << v << "\n";
+                return false;
+            }
+            opts.memoryLimit = static_cast<size_t>(n) * 1024 * 1024;
+        } else if (a == "--stat-timeout" || a == "--stat-per-mount") {
+            std::string v;
+            if (!needValue(v)) return false;
+            int n = std::atoi(v.c_str());
+            if (n <= 0) {
+                std::cerr << "error: invalid value for " << a << ": " << v << "\n";
+                return false;
+            }
+            if (a == "--stat-timeout") {
+                opts.stat.deadline = std::chrono::milliseconds(n);
+            } else {
+                opts.stat.perMountLimit = static_cast<unsigned>(n);
+            }
+        } else if (a == "--json") {
+            opts.format = ReportFormat::Json;
+        } else if (a == "--missing-only") {
+            opts.missingOnly = true;
+        } else if (a == "-q" || a == "--quiet") {
+            opts.progress = false;
+        } else if (!a.empty() && a[0] == '-') {
+            std::cerr << "error: unknown option " << a << "\n";
+            return false;
+        } else {
+            opts.inputs.push_back(a);
+        }
+    }
+    if (opts.inputs.empty() && opts.listFiles.empty()) {
+        printUsage(exe);
+        return false;
+    }
+    return true;
+}
+
+int run(const std::vector<std::string>& args)
+{
+    Options opts;
+    const char* exe = "mayaDepCheck";
+    if (!parseArgs(args, opts, exe)) return 2;
+
+    // ---- Collect scenes ----
+    std::vector<std::string> scenes;
+    for (const auto& listPath : opts.listFiles) {
+        if (!readListFile(listPath, scenes)) {
+            std::cerr << "error: cannot read list file " << listPath << "\n";
+            return 2;
+        }
+    }
+    for (const auto& input : opts.inputs) {
+        fs::path p = fs::u8path(input);
+        std::error_code ec;
+        if (fs::is_directory(p, ec)) {
+            std::vector<std::string> found;
+            collectScenes(p, found);
+            std::sort(found.begin(), found.end());
+            scenes.insert(scenes.end(), found.begin(), found.end());
+        } else {
+            scenes.push_back(input);
+        }
+    }
+
+    // Drop duplicates but keep the input order.
+    {
+        std::unordered_set<std::string> seen;
+        std::vector<std::string> unique;
+        unique.reserve(scenes.size());
+        for (auto& s : scenes) {
+            if (seen.insert(s).second) unique.push_back(std::move(s));
+        }
+        scenes.swap(unique);
+    }
+
+    if (scenes.empty()) {
+        std::cerr << "error: no .ma/.mb scenes found\n";
+        return 2;
+    }
+
+    // ---- Analyze in parallel, one scene per task ----
+    unsigned jobs = opts.jobs ? opts.jobs : std::thread::hardware_concurrency();
+    if (jobs == 0) jobs = 1;
+
+    MetadataExecutor::configure(opts.stat);
+
+    AnalysisCache cache(opts.cacheFingerprint);
+    AnalysisCache* cachePtr = nullptr;
+    if (!opts.cachePath.empty()) {
+        if (!cache.load(opts.cachePath)) {
+            std::cerr << "warning: ignoring unreadable cache " << opts.cachePath << "\n";
+        }
+        cachePtr = &cache;
+    }
+    int rc = opts.recursive ? runGraph(scenes, opts, jobs, cachePtr) : runFlat(scenes, opts, jobs, cachePtr);
+
+    if (cachePtr) {
+        if (!cache.save(opts.cachePath)) {
+            std::cerr << "warning: cannot write cache " << opts.cachePath << "\n";
+        } else if (opts.progress) {
+            std::cerr << "cache: " << cache.hits() << " hits, " << cache.misses() << " misses, "
+                      << cache.size() << " entries\n";
+        }
+    }
+    return rc;
+}
+
+} // namespace
+
+#ifdef _WIN32
+// Use the wide entry point so non-ASCII (e.g. Chinese) paths survive.
+static std::string wideToUtf8(const wchar_t* w)
+{
+    int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return std::string();
+    std::string out(static_cast<size_t>(len), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, w, -1, &out[0], len, nullptr, nullptr);
+    out.resize(static_cast<size_t>(len - 1));
+    return out;
+}
+
+int wmain(int argc, wchar_t** argv)
+{
+    SetConsoleOutputCP(CP_UTF8);
+    std::vector<std::string> args;
+    for (int i = 0; i < argc; ++i) args.push_back(wideToUtf8(argv[i]));
+    return run(args);
+}
+#else
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args(argv, argv + argc);
+    return run(args);
+}
+#endif
@@ -0,0 +1,130 @@
+// mayaIndexService — shared Batch Locate file index for every Maya session
+// of the current user on this workstation.
+//
+// Owns one persistent, watched FileIndex per search root and answers index,
+// lookup and best-match requests from RefChecker over a Unix domain socket
+// (named pipe on Windows). Sessions that find no service fall back to their
+// own in-process index. Runs until interrupted (Ctrl+C / SIGTERM).
+//
+//   mayaIndexService [--endpoint <path>] [--index <root>]...
+
+#include "IndexClient.h"
+#include "IndexServer.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void onSignal(int)
+{
+    g_stop = true;
+}
+
+void printUsage(const char* exe)
+{
+    std::cerr <<
+        "Usage: " << exe << " [options]\n"
+        "\n"
+        "Serve the RefChecker Batch Locate file index to every Maya session of this\n"
+        "user, so each search root is walked and held in memory once.\n"
+        "\n"
+        "Options:\n"
+        "      --endpoint <path>  socket path / pipe name (default: per-user, see below)\n"
+        "      --index <root>     index <root> at startup (repeatable)\n"
+        "  -h, --help             show this help\n"
+        "\n"
+        "Default endpoint: " << IndexProtocol::defaultEndpoint() << "\n"
+        "Maya sessions use it unless MAYA_REF_CHECKER_INDEX_SERVICE is set (to another\n"
+        "endpoint, or to 0 to never use the service).\n";
+}
+
+int run(const std::vector<std::string>& args)
+{
+    const char* exe = args.empty() ? "mayaIndexService" : args[0].c_str();
+    std::string endpoint = IndexProtocol::defaultEndpoint();
+    std::vector<std::string> roots;
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& a = args[i];
+        if (a == "-h" || a == "--help") {
+            printUsage(exe);
+            return 0;
+        } else if ((a == "--endpoint" || a == "--index") && i + 1 < args.size()) {
+            if (a == "--endpoint") endpoint = args[++i];
+            else roots.push_back(args[++i]);
+        } else {
+            std::cerr << "error: unknown or incomplete option " << a << "\n";
+            printUsage(exe);
+            return 2;
+        }
+    }
+
+    IndexServer server;
+    if (!server.start(endpoint)) {
+        std::cerr << "error: " << server.error() << "\n";
+        return 1;
+    }
+    std::cerr << "Listening on " << endpoint << "\n";
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Warm-up goes through the service itself, like any client.
+    if (!roots.empty()) {
+        std::unique_ptr<IndexClient> client = IndexClient::connect(endpoint);
+        for (const auto& root : roots) {
+            uint64_t files = 0;
+            if (client && client->index(root, [](size_t) { return !g_stop.load(); }, files)) {
+                std::cerr << "Indexed " << root << ": " << files << " files\n";
+            } else {
+                std::cerr << "error: " << root << ": " << (client ? client->error() : "cannot connect") << "\n";
+            }
+        }
+    }
+
+    while (!g_stop.load()) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::cerr << "Stopping\n";
+    server.stop();
+    return 0;
+}
+
+} // namespace
+
+#ifdef _WIN32
+// Use the wide entry point so non-ASCII (e.g. Chinese) paths survive.
+static std::string wideToUtf8(const wchar_t* w)
+{
+    int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return std::string();
+    std::string out(static_cast<size_t>(len), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, w, -1, &out[0], len, nullptr, nullptr);
+    out.resize(static_cast<size_t>(len - 1));
+    return out;
+}
+
+int wmain(int argc, wchar_t** argv)
+{
+    SetConsoleOutputCP(CP_UTF8);
+    std::vector<std::string> args;
+    for (int i = 0; i < argc; ++i) args.push_back(wideToUtf8(argv[i]));
+    return run(args);
+}
+#else
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args(argv, argv + argc);
+    return run(args);
+}
+#endif